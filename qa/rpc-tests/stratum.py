@@ -0,0 +1,121 @@
+#!/usr/bin/env python2
+# Copyright (c) 2019 Duality Blockchain Solutions Developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#
+# Test the embedded stratum server with a loopback client
+#
+
+from test_framework.test_framework import DynamicTestFramework
+from test_framework.util import *
+
+import json
+import socket
+import time
+
+class StratumClient(object):
+    def __init__(self, port):
+        self.sock = socket.create_connection(("127.0.0.1", port), 30)
+        self.buf = b""
+        self.next_id = 1
+        self.notifications = []
+
+    def read_message(self):
+        while b"\n" not in self.buf:
+            data = self.sock.recv(4096)
+            assert(data)
+            self.buf += data
+        line, self.buf = self.buf.split(b"\n", 1)
+        return json.loads(line.decode())
+
+    def request(self, method, params):
+        request_id = self.next_id
+        self.next_id += 1
+        self.sock.sendall((json.dumps({"id": request_id, "method": method, "params": params}) + "\n").encode())
+        while True:
+            message = self.read_message()
+            if message["id"] == request_id:
+                return message
+            self.notifications.append(message)
+
+    def wait_notification(self, method, timeout=30):
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            while self.notifications:
+                message = self.notifications.pop(0)
+                if message["method"] == method:
+                    return message["params"]
+            self.notifications.append(self.read_message())
+        raise AssertionError("no %s notification" % method)
+
+class StratumTest(DynamicTestFramework):
+
+    def setup_nodes(self):
+        # p2p port of a node that is not started
+        self.port = p2p_port(4)
+        return start_nodes(4, self.options.tmpdir, extra_args=[
+            ["-stratumport=%d" % self.port],
+            [],
+            [],
+            []
+            ])
+
+    def wait_job(self, client, tip):
+        while True:
+            job = client.wait_notification("mining.notify")
+            if job[1] == bytes_to_hex_str(hex_str_to_bytes(tip)[::-1]):
+                return job
+
+    def assert_error(self, reply, code):
+        assert_equal(reply["result"], None)
+        assert_equal(reply["error"][0], code)
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(1)
+        self.sync_all()
+
+        client = StratumClient(self.port)
+        other = StratumClient(self.port)
+
+        # Shares need a subscription and an authorized worker
+        self.assert_error(other.request("mining.submit", ["worker", "0", "00000000", "00000000", "00000000"]), 25)
+        other.request("mining.subscribe", [])
+        self.assert_error(other.request("mining.submit", ["worker", "0", "00000000", "00000000", "00000000"]), 24)
+        self.assert_error(other.request("mining.unknown", []), 20)
+
+        reply = client.request("mining.subscribe", ["test/1.0"])
+        assert_equal(reply["error"], None)
+        extranonce1 = reply["result"][1]
+        assert_equal(len(extranonce1), 8)
+        assert_equal(reply["result"][2], 4)
+        # Every connection searches its own extranonce range
+        assert(extranonce1 != other.request("mining.subscribe", [])["result"][1])
+
+        assert_equal(client.wait_notification("mining.set_difficulty"), [1])
+        job = self.wait_job(client, node.getbestblockhash())
+        assert_equal(job[8], True)
+        assert_equal(int(job[6], 16), int(node.getblocktemplate()["bits"], 16))
+
+        reply = client.request("mining.authorize", ["worker", "x"])
+        assert_equal(reply["result"], True)
+
+        job_id, ntime = job[0], job[7]
+        self.assert_error(client.request("mining.submit", ["worker", "unknown", "00000000", ntime, "00000000"]), 21)
+        self.assert_error(client.request("mining.submit", ["worker", job_id, "00", ntime, "00000000"]), 20)
+        self.assert_error(client.request("mining.submit", ["worker", job_id, "00000000", "00000000", "00000000"]), 20)
+
+        # The share target is the proof of work limit, a random nonce almost never meets it
+        reply = client.request("mining.submit", ["worker", job_id, "00000000", ntime, "00000000"])
+        if reply["result"] != True:
+            self.assert_error(reply, 23)
+            self.assert_error(client.request("mining.submit", ["worker", job_id, "00000000", ntime, "00000000"]), 22)
+
+        # A new block pushes a clean job on top of it
+        job = self.wait_job(client, node.generate(1)[0])
+        assert_equal(job[8], True)
+        self.assert_error(client.request("mining.submit", ["worker", job_id, "00000001", ntime, "00000000"]), 21)
+
+if __name__ == '__main__':
+    StratumTest().main()
@@ -0,0 +1,54 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "hash.h"
+#include "primitives/block.h"
+
+#include <vector>
+
+// Hashes one block header per iteration, the way CPUMiner does with -minerbatch=n
+static void Argon2dMultiBuffer(benchmark::State& state, unsigned int count)
+{
+    CArgon2dContext ctx;
+    unsigned char headers[CArgon2dContext::MAX_MULTI_HASHES][BLOCK_HEADER_HASHED_SIZE] = {};
+    const void* inputs[CArgon2dContext::MAX_MULTI_HASHES];
+    uint256 hashes[CArgon2dContext::MAX_MULTI_HASHES];
+    for (unsigned int i = 0; i < count; i++) {
+        inputs[i] = headers[i];
+    }
+    uint32_t nonce = 0;
+    unsigned int pending = 0;
+    while (state.KeepRunning()) {
+        if (pending == 0) {
+            for (unsigned int i = 0; i < count; i++) {
+                memcpy(headers[i] + BLOCK_HEADER_HASHED_SIZE - sizeof(nonce), &nonce, sizeof(nonce));
+                nonce++;
+            }
+            ctx.HashMulti(inputs, BLOCK_HEADER_HASHED_SIZE, count, 1, hashes);
+            pending = count;
+        }
+        pending--;
+    }
+}
+
+static void Argon2dSingleBuffer(benchmark::State& state)
+{
+    Argon2dMultiBuffer(state, 1);
+}
+
+static void Argon2dDoubleBuffer(benchmark::State& state)
+{
+    Argon2dMultiBuffer(state, 2);
+}
+
+static void Argon2dQuadBuffer(benchmark::State& state)
+{
+    Argon2dMultiBuffer(state, 4);
+}
+
+BENCHMARK(Argon2dSingleBuffer);
+BENCHMARK(Argon2dDoubleBuffer);
+BENCHMARK(Argon2dQuadBuffer);
@@ -4,12 +4,21 @@
 
 #include "bench.h"
 
+#include <univalue.h>
+
 #include <iostream>
 #include <sys/time.h>
 
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
 using namespace benchmark;
 
 std::map<std::string, BenchFunction> BenchRunner::benchmarks;
+std::vector<Result> BenchRunner::results;
+
+std::atomic<uint64_t>* benchmark::pAllocationCounter = nullptr;
 
 static double gettimedouble(void) {
     struct timeval tv;
@@ -17,23 +26,64 @@ static double gettimedouble(void) {
     return tv.tv_usec * 0.000001 + tv.tv_sec;
 }
 
+static uint64_t getcycles(void) {
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
 BenchRunner::BenchRunner(std::string name, BenchFunction func)
 {
     benchmarks.insert(std::make_pair(name, func));
 }
 
-void
-BenchRunner::RunAll(double elapsedTimeForOne)
+void BenchRunner::AddResult(const Result& result)
 {
-    std::cout << "Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << "\n";
+    results.push_back(result);
+}
 
+void
+BenchRunner::RunAll(double elapsedTimeForOne, const std::string& filter, bool fJson)
+{
+    results.clear();
     for (std::map<std::string,BenchFunction>::iterator it = benchmarks.begin();
          it != benchmarks.end(); ++it) {
+        if (!filter.empty() && it->first.find(filter) == std::string::npos)
+            continue;
 
         State state(it->first, elapsedTimeForOne);
         BenchFunction& func = it->second;
         func(state);
     }
+
+    if (fJson) {
+        UniValue arr(UniValue::VARR);
+        for (const Result& result : results) {
+            UniValue obj(UniValue::VOBJ);
+            obj.push_back(Pair("name", result.name));
+            obj.push_back(Pair("count", result.count));
+            obj.push_back(Pair("ns_per_op", result.average * 1e9));
+            obj.push_back(Pair("min_ns", result.minTime * 1e9));
+            obj.push_back(Pair("max_ns", result.maxTime * 1e9));
+            obj.push_back(Pair("cycles_per_op", result.cycles));
+            if (result.allocs >= 0)
+                obj.push_back(Pair("allocs_per_op", result.allocs));
+            arr.push_back(obj);
+        }
+        std::cout << arr.write(2) << "\n";
+        return;
+    }
+
+    std::cout << "Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << "," << "cycles" << "," << "allocs" << "\n";
+    for (const Result& result : results) {
+        std::cout << result.name << "," << result.count << "," << result.minTime << "," << result.maxTime << "," << result.average
+                  << "," << result.cycles << ",";
+        if (result.allocs >= 0)
+            std::cout << result.allocs;
+        std::cout << "\n";
+    }
 }
 
 bool State::KeepRunning()
@@ -41,6 +91,8 @@ bool State::KeepRunning()
     double now;
     if (count == 0) {
         beginTime = now = gettimedouble();
+        beginCycles = getcycles();
+        beginAllocs = pAllocationCounter ? pAllocationCounter->load(std::memory_order_relaxed) : 0;
     }
     else {
         // timeCheckCount is used to avoid calling gettime most of the time,
@@ -62,9 +114,15 @@ bool State::KeepRunning()
 
     --count;
 
-    // Output results
-    double average = (now-beginTime)/count;
-    std::cout << name << "," << count << "," << minTime << "," << maxTime << "," << average << "\n";
+    Result result;
+    result.name = name;
+    result.count = count;
+    result.minTime = minTime;
+    result.maxTime = maxTime;
+    result.average = (now-beginTime)/count;
+    result.cycles = double(getcycles() - beginCycles) / count;
+    result.allocs = pAllocationCounter ? double(pAllocationCounter->load(std::memory_order_relaxed) - beginAllocs) / count : -1;
+    BenchRunner::AddResult(result);
 
     return false;
 }
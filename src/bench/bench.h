@@ -5,8 +5,11 @@
 #ifndef DYNAMIC_BENCH_BENCH_H
 #define DYNAMIC_BENCH_BENCH_H
 
+#include <atomic>
+#include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/preprocessor/cat.hpp>
@@ -32,15 +35,34 @@ static void CODE_TO_TIME(benchmark::State& state)
 
 BENCHMARK(CODE_TO_TIME);
 
+ * Besides wall time, each benchmark reports CPU cycles (where a cycle counter
+ * is available) and heap allocations per iteration. bench_dynamic -printer=json
+ * prints the results as JSON, -filter=<substring> selects benchmarks by name.
+ * Allocations are counted by bench/allocs.cpp, through malloc with glibc and
+ * through operator new elsewhere.
  */
  
 namespace benchmark {
 
+    /** Heap allocations made by the process, null unless bench/allocs.cpp is linked in */
+    extern std::atomic<uint64_t>* pAllocationCounter;
+
+    /** Measurements of one benchmark, per iteration */
+    struct Result {
+        std::string name;
+        int64_t count;
+        double minTime, maxTime, average; // seconds
+        double cycles; // 0 without a cycle counter
+        double allocs; // -1 when allocations aren't counted
+    };
+
     class State {
         std::string name;
         double maxElapsed;
         double beginTime;
         double lastTime, minTime, maxTime;
+        uint64_t beginCycles;
+        uint64_t beginAllocs;
         int64_t count;
         int64_t timeCheckCount;
     public:
@@ -57,11 +79,14 @@ namespace benchmark {
     class BenchRunner
     {
         static std::map<std::string, BenchFunction> benchmarks;
+        static std::vector<Result> results;
 
     public:
         BenchRunner(std::string name, BenchFunction func);
 
-        static void RunAll(double elapsedTimeForOne=1.0);
+        static void AddResult(const Result& result);
+
+        static void RunAll(double elapsedTimeForOne=1.0, const std::string& filter="", bool fJson=false);
     };
 }
 
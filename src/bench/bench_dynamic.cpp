@@ -4,6 +4,7 @@
 
 #include "bench.h"
 
+#include "chainparams.h"
 #include "key.h"
 #include "random.h"
 #include "validation.h"
@@ -12,12 +13,14 @@
 int
 main(int argc, char** argv)
 {
+    ParseParameters(argc, argv);
     RandomInit();
     ECC_Start();
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
+    SelectParams(CBaseChainParams::MAIN);
 
-    benchmark::BenchRunner::RunAll();
+    benchmark::BenchRunner::RunAll(1.0, GetArg("-filter", ""), GetArg("-printer", "console") == "json");
 
     ECC_Stop();
 }
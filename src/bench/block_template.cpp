@@ -0,0 +1,175 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "amount.h"
+#include "chainparams.h"
+#include "consensus/consensus.h"
+#include "consensus/validation.h"
+#include "miner/miner-util.h"
+#include "pow.h"
+#include "primitives/transaction.h"
+#include "random.h"
+#include "script/script.h"
+#include "txdb.h"
+#include "txmempool.h"
+#include "util.h"
+#include "utiltime.h"
+#include "validation.h"
+
+#include <boost/filesystem.hpp>
+
+/**
+ * Regtest chain in a temporary data directory, for benchmarks that need
+ * blocks and coins on disk. The bench otherwise runs on main net parameters
+ * without a chain, the destructor restores that.
+ */
+class CBenchChain
+{
+public:
+    CBenchChain();
+    ~CBenchChain();
+
+    // Mines a block with txns after the coinbase paying to OP_TRUE
+    CBlock MineBlock(const std::vector<CTransactionRef>& txns);
+
+private:
+    boost::filesystem::path pathTemp;
+    CCoinsViewDB* pcoinsdbview;
+};
+
+CBenchChain::CBenchChain()
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    ClearDatadirCache();
+    pathTemp = boost::filesystem::temp_directory_path() / strprintf("bench_dynamic_%lu_%i", (unsigned long)GetTime(), (int)(GetRand(100000)));
+    boost::filesystem::create_directories(pathTemp);
+    ForceSetArg("-datadir", pathTemp.string());
+    pblocktree = new CBlockTreeDB(1 << 20, true);
+    pcoinsdbview = new CCoinsViewDB(1 << 23, true);
+    pcoinsTip = new CCoinsViewCache(pcoinsdbview);
+    InitBlockIndex(Params());
+    CValidationState state;
+    ActivateBestChain(state, Params());
+}
+
+CBenchChain::~CBenchChain()
+{
+    mempool.clear();
+    UnloadBlockIndex();
+    delete pcoinsTip;
+    pcoinsTip = nullptr;
+    delete pcoinsdbview;
+    delete pblocktree;
+    pblocktree = nullptr;
+    boost::filesystem::remove_all(pathTemp);
+    ClearDatadirCache();
+    SelectParams(CBaseChainParams::MAIN);
+}
+
+CBlock CBenchChain::MineBlock(const std::vector<CTransactionRef>& txns)
+{
+    const CChainParams& chainparams = Params();
+    std::unique_ptr<CBlockTemplate> pblocktemplate = CreateNewBlock(chainparams, CScript() << OP_TRUE);
+    CBlock& block = pblocktemplate->block;
+    block.vtx.resize(1);
+    block.vtx.insert(block.vtx.end(), txns.begin(), txns.end());
+    unsigned int nExtraNonce = 0;
+    IncrementExtraNonce(block, chainActive.Tip(), nExtraNonce);
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, chainparams.GetConsensus()))
+        ++block.nNonce;
+    ProcessNewBlock(chainparams, std::make_shared<const CBlock>(block), true, nullptr);
+    return block;
+}
+
+// Assembles a block from a mempool of 4000 transactions spending mature outputs,
+// including the TestBlockValidity check CreateNewBlock ends with
+static void CreateNewBlockFullMempool(benchmark::State& state)
+{
+    const unsigned int nTx = 4000;
+    const CAmount nFee = 1000;
+    CBenchChain chain;
+
+    CBlock first = chain.MineBlock({});
+    for (int i = 0; i < COINBASE_MATURITY; i++)
+        chain.MineBlock({});
+
+    // One transaction splits the first coinbase into an output for each mempool transaction
+    CMutableTransaction txSplit;
+    txSplit.vin.resize(1);
+    txSplit.vin[0].prevout = COutPoint(first.vtx[0]->GetHash(), 0);
+    const CAmount nValue = (first.vtx[0]->vout[0].nValue - nFee) / nTx;
+    txSplit.vout.resize(nTx);
+    for (CTxOut& txout : txSplit.vout) {
+        txout.nValue = nValue;
+        txout.scriptPubKey = CScript() << OP_TRUE;
+    }
+    CTransactionRef split = MakeTransactionRef(txSplit);
+    chain.MineBlock({split});
+
+    LockPoints lp;
+    for (unsigned int i = 0; i < nTx; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(split->GetHash(), i);
+        tx.vout.resize(1);
+        tx.vout[0].nValue = nValue - nFee;
+        tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+        CTransactionRef txRef = MakeTransactionRef(tx);
+        mempool.addUnchecked(txRef->GetHash(), CTxMemPoolEntry(txRef, nFee, GetTime(), 0, chainActive.Height(), nValue, false, 0, lp));
+    }
+
+    const CScript scriptPubKey = CScript() << OP_TRUE;
+    while (state.KeepRunning()) {
+        CreateNewBlock(Params(), scriptPubKey);
+    }
+}
+
+// Fills an empty template from a mempool holding a full block of transactions
+static void UpdateBlockTemplateFullMempool(benchmark::State& state)
+{
+    CMutableTransaction txCoinbase;
+    txCoinbase.vin.resize(1);
+    txCoinbase.vin[0].prevout.SetNull();
+    txCoinbase.vin[0].scriptSig = CScript() << 1 << OP_0;
+    txCoinbase.vout.resize(1);
+    txCoinbase.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    CTransactionRef coinbase = MakeTransactionRef(txCoinbase);
+
+    LockPoints lp;
+    for (unsigned int i = 0; i < 4000; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(GetRandHash(), 0);
+        tx.vin[0].scriptSig = CScript() << OP_TRUE;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+        tx.vout[0].nValue = COIN;
+        CTransactionRef txRef = MakeTransactionRef(tx);
+        mempool.addUnchecked(txRef->GetHash(), CTxMemPoolEntry(txRef, 10000, GetTime(), 0, 1, 0, false, 1, lp));
+    }
+
+    CBlockTemplate blocktemplate;
+    blocktemplate.block.vtx.push_back(coinbase);
+    blocktemplate.vTxFees.push_back(0);
+    blocktemplate.vTxSigOps.push_back(0);
+    blocktemplate.nHeight = 100000;
+    blocktemplate.nLockTimeCutoff = GetTime();
+    blocktemplate.nBlockSize = 1000;
+    blocktemplate.nBlockSigOps = 100;
+    blocktemplate.nLastEntryTime = 0;
+    blocktemplate.selection->merkleTree = CMerkleTree(std::vector<uint256>(1, coinbase->GetHash()));
+
+    while (state.KeepRunning()) {
+        CBlockTemplate copy(blocktemplate);
+        // Every iteration extends the same template, don't share its selection
+        copy.selection = std::make_shared<CBlockTemplateSelection>(*blocktemplate.selection);
+        UpdateBlockTemplate(copy);
+    }
+    mempool.clear();
+}
+
+BENCHMARK(CreateNewBlockFullMempool);
+BENCHMARK(UpdateBlockTemplateFullMempool);
@@ -0,0 +1,146 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "consensus/merkle.h"
+#include "hash.h"
+#include "miner/impl/miner-cpu.h"
+#include "miner/miner-util.h"
+#include "net.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "script/script.h"
+#include "validation.h"
+#include "validationinterface.h"
+
+// Block with a coinbase and nTx independent transactions
+static CBlock MakeBlock(unsigned int nTx)
+{
+    CBlock block;
+    CMutableTransaction txCoinbase;
+    txCoinbase.vin.resize(1);
+    txCoinbase.vin[0].prevout.SetNull();
+    txCoinbase.vin[0].scriptSig = CScript() << 1 << OP_0;
+    txCoinbase.vout.resize(1);
+    txCoinbase.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    block.vtx.push_back(MakeTransactionRef(txCoinbase));
+    for (unsigned int i = 0; i < nTx; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(GetRandHash(), 0);
+        tx.vin[0].scriptSig = CScript() << OP_TRUE;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+        tx.vout[0].nValue = COIN;
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.hashPrevBlock = GetRandHash();
+    block.nVersion = 4;
+    block.nTime = 1500000000;
+    block.nBits = 0x1e0fffff;
+    return block;
+}
+
+// One header hash per iteration, allocating the Argon2d memory every time
+static void Argon2dHash(benchmark::State& state, unsigned int nPhase)
+{
+    CBlockHeader header = MakeBlock(0).GetBlockHeader();
+    while (state.KeepRunning()) {
+        hash_Argon2d(BEGIN(header.nVersion), END(header.nNonce), nPhase);
+        header.nNonce++;
+    }
+}
+
+static void Argon2dPhase1(benchmark::State& state)
+{
+    Argon2dHash(state, 1);
+}
+
+static void Argon2dPhase2(benchmark::State& state)
+{
+    Argon2dHash(state, 2);
+}
+
+static void ScriptForMining(std::shared_ptr<CReserveScript>& script)
+{
+    script = std::make_shared<CReserveScript>();
+    script->reserveScript = CScript() << OP_TRUE;
+}
+
+// Drives TryMineBlock without the miner loop, a friend of MinerBase
+class MinerBench
+{
+public:
+    static int64_t MineRound(MinerBase& miner, CBlock& block, const arith_uint256& target)
+    {
+        miner._hash_target = target;
+        return miner.TryMineBlock(block);
+    }
+};
+
+// One TryMineBlock round (256 nonces) per iteration, the target is never met
+static void MinerTryMineBlock(benchmark::State& state)
+{
+    CConnman connman(0, 0);
+    MinerContextRef ctx = std::make_shared<MinerContext>(Params(), connman);
+    GetMainSignals().ScriptForMining.connect(ScriptForMining);
+    CPUMiner miner(ctx, 0);
+    GetMainSignals().ScriptForMining.disconnect(ScriptForMining);
+
+    CBlock block = MakeBlock(0);
+    while (state.KeepRunning()) {
+        MinerBench::MineRound(miner, block, arith_uint256(0));
+    }
+}
+
+static void MerkleRootFull(benchmark::State& state)
+{
+    CBlock block = MakeBlock(2000);
+    while (state.KeepRunning()) {
+        BlockMerkleRoot(block);
+    }
+}
+
+static void MerkleRootCoinbaseBranch(benchmark::State& state)
+{
+    CBlock block = MakeBlock(2000);
+    std::vector<uint256> vBranch = BlockMerkleBranch(block, 0);
+    while (state.KeepRunning()) {
+        ComputeMerkleRootFromBranch(block.vtx[0]->GetHash(), vBranch, 0);
+    }
+}
+
+static void ExtraNonce(benchmark::State& state, bool fBranch)
+{
+    CBlock block = MakeBlock(2000);
+    std::vector<uint256> vBranch = BlockMerkleBranch(block, 0);
+    CBlockIndex indexPrev;
+    indexPrev.nHeight = 100000;
+    unsigned int nExtraNonce = 0;
+    while (state.KeepRunning()) {
+        IncrementExtraNonce(block, &indexPrev, nExtraNonce, fBranch ? &vBranch : nullptr);
+    }
+}
+
+static void IncrementExtraNonceFull(benchmark::State& state)
+{
+    ExtraNonce(state, false);
+}
+
+static void IncrementExtraNonceBranch(benchmark::State& state)
+{
+    ExtraNonce(state, true);
+}
+
+BENCHMARK(Argon2dPhase1);
+BENCHMARK(Argon2dPhase2);
+BENCHMARK(MinerTryMineBlock);
+BENCHMARK(MerkleRootFull);
+BENCHMARK(MerkleRootCoinbaseBranch);
+BENCHMARK(IncrementExtraNonceFull);
+BENCHMARK(IncrementExtraNonceBranch);
@@ -3,6 +3,8 @@
 #include "hash.h"
 #include "utilstrencodings.h"
 
+#include <assert.h>
+
 /*     WARNING! If you're reading this because you're learning about crypto
        and/or designing a new system that will use merkle trees, keep in mind
        that the following merkle tree algorithm has a serious flaw related to
@@ -180,3 +182,72 @@ std::vector<uint256> BlockMerkleBranch(const CBlock& block, uint32_t position)
     }
     return ComputeMerkleBranch(leaves, position);
 }
+
+CMerkleTree::CMerkleTree(const std::vector<uint256>& leaves)
+{
+    if (leaves.empty())
+        return;
+    vLevels.push_back(leaves);
+    while (vLevels.back().size() > 1) {
+        const std::vector<uint256>& below = vLevels.back();
+        std::vector<uint256> level((below.size() + 1) / 2);
+        for (size_t i = 0; i < level.size(); i++) {
+            const uint256& left = below[2 * i];
+            const uint256& right = 2 * i + 1 < below.size() ? below[2 * i + 1] : left;
+            level[i] = Hash(BEGIN(left), END(left), BEGIN(right), END(right));
+        }
+        vLevels.push_back(std::move(level));
+    }
+}
+
+void CMerkleTree::Append(const uint256& leaf)
+{
+    if (vLevels.empty())
+        vLevels.resize(1);
+    vLevels[0].push_back(leaf);
+    UpdatePath(vLevels[0].size() - 1);
+}
+
+void CMerkleTree::Update(uint32_t position, const uint256& leaf)
+{
+    assert(position < size());
+    vLevels[0][position] = leaf;
+    UpdatePath(position);
+}
+
+uint256 CMerkleTree::Root() const
+{
+    if (vLevels.empty())
+        return uint256();
+    return vLevels.back()[0];
+}
+
+std::vector<uint256> CMerkleTree::Branch(uint32_t position) const
+{
+    std::vector<uint256> branch;
+    for (size_t level = 0; level < vLevels.size() && vLevels[level].size() > 1; level++) {
+        const std::vector<uint256>& nodes = vLevels[level];
+        branch.push_back(nodes[std::min<size_t>(position ^ 1U, nodes.size() - 1)]);
+        position >>= 1;
+    }
+    return branch;
+}
+
+void CMerkleTree::UpdatePath(uint32_t position)
+{
+    for (size_t level = 0; vLevels[level].size() > 1; level++) {
+        if (level + 1 == vLevels.size())
+            vLevels.emplace_back();
+        const std::vector<uint256>& below = vLevels[level];
+        // Odd levels pair their last node with itself
+        const uint256& left = below[position & ~1U];
+        const uint256& right = (position | 1U) < below.size() ? below[position | 1U] : left;
+        const uint256 hash = Hash(BEGIN(left), END(left), BEGIN(right), END(right));
+        position >>= 1;
+        std::vector<uint256>& above = vLevels[level + 1];
+        if (position == above.size())
+            above.push_back(hash);
+        else
+            above[position] = hash;
+    }
+}
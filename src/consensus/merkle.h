@@ -29,4 +29,33 @@ uint256 BlockMerkleRoot(const CBlock& block, bool* mutated = NULL);
  */
 std::vector<uint256> BlockMerkleBranch(const CBlock& block, uint32_t position);
 
+/*
+ * Merkle tree that keeps every level in memory, so that appending a leaf or
+ * replacing one only rehashes the path from that leaf to the root.
+ * Produces the same root as ComputeMerkleRoot for the same leaves.
+ */
+class CMerkleTree
+{
+public:
+    CMerkleTree() {}
+    explicit CMerkleTree(const std::vector<uint256>& leaves);
+
+    /* Add a leaf at the end of the tree. */
+    void Append(const uint256& leaf);
+    /* Replace the leaf at position. */
+    void Update(uint32_t position, const uint256& leaf);
+
+    uint256 Root() const;
+    /* Same as ComputeMerkleBranch, but without hashing anything. */
+    std::vector<uint256> Branch(uint32_t position) const;
+    size_t size() const { return vLevels.empty() ? 0 : vLevels[0].size(); }
+
+private:
+    /* Rehash the parents of the leaf at position up to the root. */
+    void UpdatePath(uint32_t position);
+
+    /* vLevels[0] are the leaves, the last level holds the root. */
+    std::vector<std::vector<uint256> > vLevels;
+};
+
 #endif // DYNAMIC_MERKLE
@@ -36,21 +36,10 @@ const char *argon2_type2string(argon2_type type, int uppercase) {
     return NULL;
 }
 
-int argon2_ctx(argon2_context *context, argon2_type type) {
-    /* 1. Validate all inputs */
-    int result = validate_inputs(context);
+static void setup_instance(argon2_instance_t *instance,
+                           const argon2_context *context, argon2_type type) {
     uint32_t memory_blocks, segment_length;
-    argon2_instance_t instance;
 
-    if (ARGON2_OK != result) {
-        return result;
-    }
-
-    if (Argon2_d != type) {    
-        return ARGON2_INCORRECT_TYPE;
-    }
-
-    /* 2. Align memory size */
     /* Minimum memory_blocks = 8L blocks, where L is the number of lanes */
     memory_blocks = context->m_cost;
 
@@ -62,19 +51,36 @@ int argon2_ctx(argon2_context *context, argon2_type type) {
     /* Ensure that all segments have equal length */
     memory_blocks = segment_length * (context->lanes * ARGON2_SYNC_POINTS);
 
-    instance.memory = NULL;
-    instance.passes = context->t_cost;
-    instance.memory_blocks = memory_blocks;
-    instance.segment_length = segment_length;
-    instance.lane_length = segment_length * ARGON2_SYNC_POINTS;
-    instance.lanes = context->lanes;
-    instance.threads = context->threads;
-    instance.type = type;
+    instance->memory = NULL;
+    instance->passes = context->t_cost;
+    instance->memory_blocks = memory_blocks;
+    instance->segment_length = segment_length;
+    instance->lane_length = segment_length * ARGON2_SYNC_POINTS;
+    instance->lanes = context->lanes;
+    instance->threads = context->threads;
+    instance->type = type;
+
+    if (instance->threads > instance->lanes) {
+        instance->threads = instance->lanes;
+    }
+}
+
+int argon2_ctx(argon2_context *context, argon2_type type) {
+    /* 1. Validate all inputs */
+    int result = validate_inputs(context);
+    argon2_instance_t instance;
+
+    if (ARGON2_OK != result) {
+        return result;
+    }
 
-    if (instance.threads > instance.lanes) {
-        instance.threads = instance.lanes;
+    if (Argon2_d != type) {    
+        return ARGON2_INCORRECT_TYPE;
     }
 
+    /* 2. Align memory size */
+    setup_instance(&instance, context, type);
+
     /* 3. Initialization: Hashing inputs, allocating memory, filling first
      * blocks
      */
@@ -96,6 +102,59 @@ int argon2_ctx(argon2_context *context, argon2_type type) {
     return ARGON2_OK;
 }
 
+int argon2d_ctx_multi(argon2_context **contexts, uint32_t count) {
+    argon2_instance_t instances[ARGON2_MAX_MULTI_INSTANCES];
+    uint32_t i, initialized = 0;
+    int result = ARGON2_OK;
+
+    if (contexts == NULL || count == 0 || count > ARGON2_MAX_MULTI_INSTANCES) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+
+    /* 1. Validate all inputs, the instances must share the same geometry */
+    for (i = 0; i < count; ++i) {
+        result = validate_inputs(contexts[i]);
+        if (ARGON2_OK != result) {
+            return result;
+        }
+        if (contexts[i]->t_cost != contexts[0]->t_cost ||
+            contexts[i]->m_cost != contexts[0]->m_cost ||
+            contexts[i]->lanes != contexts[0]->lanes) {
+            return ARGON2_INCORRECT_PARAMETER;
+        }
+    }
+
+    /* 2. Align memory size and initialize every instance */
+    for (i = 0; i < count; ++i) {
+        setup_instance(&instances[i], contexts[i], Argon2_d);
+        result = initialize(&instances[i], contexts[i]);
+        if (ARGON2_OK != result) {
+            break;
+        }
+        ++initialized;
+    }
+
+    /* 3. Filling memory in lockstep */
+    if (ARGON2_OK == result) {
+        result = fill_memory_blocks_multi(instances, count);
+    }
+
+    if (ARGON2_OK != result) {
+        for (i = 0; i < initialized; ++i) {
+            free_memory(contexts[i], (uint8_t *)instances[i].memory,
+                        instances[i].memory_blocks, sizeof(block));
+        }
+        return result;
+    }
+
+    /* 4. Finalization */
+    for (i = 0; i < count; ++i) {
+        finalize(contexts[i], &instances[i]);
+    }
+
+    return ARGON2_OK;
+}
+
 int argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
                 const uint32_t parallelism, const void *pwd,
                 const size_t pwdlen, const void *salt, const size_t saltlen,
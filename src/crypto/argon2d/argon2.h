@@ -95,6 +95,9 @@ extern "C" {
 #define ARGON2_DEFAULT_FLAGS UINT32_C(0)
 #define ARGON2_FLAG_CLEAR_PASSWORD (UINT32_C(1) << 0)
 #define ARGON2_FLAG_CLEAR_SECRET (UINT32_C(1) << 1)
+/* Skip wiping the block memory on release (only for public inputs such as
+ * block headers, where the memory holds nothing secret). */
+#define ARGON2_FLAG_NO_WIPE_MEMORY (UINT32_C(1) << 2)
 
 /* Global flag to determine if we are wiping internal memory buffers. This flag
  * is defined in core.c and deafults to 1 (wipe internal memory). */
@@ -241,6 +244,20 @@ ARGON2_PUBLIC const char* argon2_type2string(argon2_type type, int uppercase);
  */
 ARGON2_PUBLIC int argon2_ctx(argon2_context* context, argon2_type type);
 
+/* Maximum number of instances hashed in lockstep by argon2d_ctx_multi */
+#define ARGON2_MAX_MULTI_INSTANCES 4
+
+/*
+ * Function that computes several independent Argon2d hashes in lockstep on the
+ * calling thread, interleaving their memory accesses so the latency of one
+ * instance is hidden behind the compression of the others
+ * @param  contexts  Array of pointers to Argon2 contexts, all with the same
+ * t_cost, m_cost and lanes (threads is ignored)
+ * @param  count  Number of contexts, 1 to ARGON2_MAX_MULTI_INSTANCES
+ * @return Error code if smth is wrong, ARGON2_OK otherwise
+ */
+ARGON2_PUBLIC int argon2d_ctx_multi(argon2_context** contexts, uint32_t count);
+
 ARGON2_PUBLIC int argon2d_hash_encoded(const uint32_t t_cost,
     const uint32_t m_cost,
     const uint32_t parallelism,
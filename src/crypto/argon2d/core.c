@@ -108,7 +108,9 @@ int allocate_memory(const argon2_context *context, uint8_t **memory,
 void free_memory(const argon2_context *context, uint8_t *memory,
                  size_t num, size_t size) {
     size_t memory_size = num*size;
-    clear_internal_memory(memory, memory_size);
+    if (!(context->flags & ARGON2_FLAG_NO_WIPE_MEMORY)) {
+        clear_internal_memory(memory, memory_size);
+    }
     if (context->free_cbk) {
         (context->free_cbk)(memory, memory_size);
     } else {
@@ -344,6 +346,25 @@ fail:
 
 #endif /* ARGON2_NO_THREADS */
 
+int fill_memory_blocks_multi(argon2_instance_t *instances, uint32_t count) {
+    uint32_t r, s, l;
+
+    if (instances == NULL || count == 0 ||
+        count > ARGON2_MAX_MULTI_INSTANCES || instances[0].lanes == 0) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+
+    for (r = 0; r < instances[0].passes; ++r) {
+        for (s = 0; s < ARGON2_SYNC_POINTS; ++s) {
+            for (l = 0; l < instances[0].lanes; ++l) {
+                argon2_position_t position = {r, l, (uint8_t)s, 0};
+                fill_segment_multi(instances, count, position);
+            }
+        }
+    }
+    return ARGON2_OK;
+}
+
 int fill_memory_blocks(argon2_instance_t *instance) {
 	if (instance == NULL || instance->lanes == 0) {
 	    return ARGON2_INCORRECT_PARAMETER;
@@ -227,4 +227,24 @@ void fill_segment(const argon2_instance_t *instance,
  */
 int fill_memory_blocks(argon2_instance_t *instance);
 
+/*
+ * Function that fills the same segment of several Argon2d instances sharing
+ * the same geometry, one block of each instance at a time
+ * @param instances Array of the instances
+ * @param count Number of instances, at most ARGON2_MAX_MULTI_INSTANCES
+ * @param position Current position
+ * @pre all block pointers must be valid
+ */
+void fill_segment_multi(const argon2_instance_t *instances, uint32_t count,
+                        argon2_position_t position);
+
+/*
+ * Function that fills the entire memory of several Argon2d instances sharing
+ * the same geometry in lockstep on the calling thread
+ * @param instances Array of the instances
+ * @param count Number of instances, at most ARGON2_MAX_MULTI_INSTANCES
+ * @return ARGON2_OK if successful
+ */
+int fill_memory_blocks_multi(argon2_instance_t *instances, uint32_t count);
+
 #endif
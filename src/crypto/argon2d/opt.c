@@ -262,3 +262,83 @@ void fill_segment(const argon2_instance_t *instance,
         fill_block(state, ref_block, curr_block, 0);   
     }
 }
+
+void fill_segment_multi(const argon2_instance_t *instances, uint32_t count,
+                        argon2_position_t position) {
+    block *ref_block[ARGON2_MAX_MULTI_INSTANCES];
+    uint64_t pseudo_rand, ref_index, ref_lane;
+    uint32_t prev_offset, curr_offset;
+    uint32_t starting_index, i, k, line;
+#if defined(__AVX512F__)
+    __m512i state[ARGON2_MAX_MULTI_INSTANCES][ARGON2_512BIT_WORDS_IN_BLOCK];
+#elif defined(__AVX2__)
+    __m256i state[ARGON2_MAX_MULTI_INSTANCES][ARGON2_HWORDS_IN_BLOCK];
+#else
+    __m128i state[ARGON2_MAX_MULTI_INSTANCES][ARGON2_OWORDS_IN_BLOCK];
+#endif
+    const argon2_instance_t *geometry = instances;
+
+    if (instances == NULL || count == 0 || count > ARGON2_MAX_MULTI_INSTANCES) {
+        return;
+    }
+
+    starting_index = 0;
+
+    if ((0 == position.pass) && (0 == position.slice)) {
+        starting_index = 2; /* we have already generated the first two blocks */
+    }
+
+    /* Offset of the current block, the same in every instance */
+    curr_offset = position.lane * geometry->lane_length +
+                  position.slice * geometry->segment_length + starting_index;
+
+    if (0 == curr_offset % geometry->lane_length) {
+        /* Last block in this lane */
+        prev_offset = curr_offset + geometry->lane_length - 1;
+    } else {
+        /* Previous block */
+        prev_offset = curr_offset - 1;
+    }
+
+    for (k = 0; k < count; ++k) {
+        memcpy(state[k], ((instances[k].memory + prev_offset)->v),
+               ARGON2_BLOCK_SIZE);
+    }
+
+    for (i = starting_index; i < geometry->segment_length;
+         ++i, ++curr_offset, ++prev_offset) {
+        /*1.1 Rotating prev_offset if needed */
+        if (curr_offset % geometry->lane_length == 1) {
+            prev_offset = curr_offset - 1;
+        }
+
+        position.index = i;
+
+        /* 1.2 Computing the reference block of every instance first and
+         * prefetching it, so its load overlaps the other instances' fill */
+        for (k = 0; k < count; ++k) {
+            pseudo_rand = instances[k].memory[prev_offset].v[0];
+
+            ref_lane = ((pseudo_rand >> 32)) % geometry->lanes;
+
+            if ((position.pass == 0) && (position.slice == 0)) {
+                /* Can not reference other lanes yet */
+                ref_lane = position.lane;
+            }
+
+            ref_index = index_alpha(geometry, &position, pseudo_rand & 0xFFFFFFFF,
+                                    ref_lane == position.lane);
+
+            ref_block[k] = instances[k].memory +
+                           geometry->lane_length * ref_lane + ref_index;
+            for (line = 0; line < ARGON2_BLOCK_SIZE; line += 64) {
+                _mm_prefetch((const char *)ref_block[k]->v + line, _MM_HINT_T0);
+            }
+        }
+
+        /* 2 Creating the new blocks */
+        for (k = 0; k < count; ++k) {
+            fill_block(state[k], ref_block[k], instances[k].memory + curr_offset, 0);
+        }
+    }
+}
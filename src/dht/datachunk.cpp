@@ -8,6 +8,49 @@
 #include "hash.h"
 #include "streams.h"
 #include "uint256.h"
+#include "utilstrencodings.h"
+
+std::string GetChunkSalt(const std::string& strOperationCode, const uint16_t nPlacement)
+{
+    char digits[5]; // uint16_t has at most 5 digits
+    char* pend = digits + sizeof(digits);
+    char* pbegin = pend;
+    uint16_t n = nPlacement;
+    do {
+        *--pbegin = '0' + n % 10;
+        n /= 10;
+    } while (n > 0);
+
+    std::string strSalt;
+    strSalt.reserve(strOperationCode.size() + 1 + (pend - pbegin));
+    strSalt.append(strOperationCode);
+    strSalt.push_back(':');
+    strSalt.append(pbegin, pend);
+    return strSalt;
+}
+
+void AppendChunkValue(const char* pbegin, const char* pend, const bool fDecodeHex, std::vector<unsigned char>& vchPayload)
+{
+    const size_t nSize = pend - pbegin;
+    if (fDecodeHex && nSize % 2 == 0) {
+        const size_t nStart = vchPayload.size();
+        vchPayload.resize(nStart + nSize / 2);
+        unsigned char* pOut = vchPayload.data() + nStart;
+        const char* p = pbegin;
+        for (; p != pend; p += 2) {
+            const signed char hi = HexDigit(p[0]);
+            const signed char lo = HexDigit(p[1]);
+            if (hi < 0 || lo < 0)
+                break;
+            *pOut++ = (unsigned char)((hi << 4) | lo);
+        }
+        if (p == pend)
+            return;
+        // not hex after all
+        vchPayload.resize(nStart);
+    }
+    vchPayload.insert(vchPayload.end(), pbegin, pend);
+}
 
 
 void CDataChunk::Serialize(std::vector<unsigned char>& vchData) 
@@ -12,6 +12,29 @@
 
 static constexpr unsigned int DHT_DATA_MAX_CHUNK_SIZE = 900;
 
+/** Returns the DHT salt of a record piece, "opcode:placement". Placement 0 is the record header. */
+std::string GetChunkSalt(const std::string& strOperationCode, const uint16_t nPlacement);
+
+/**
+ * Where one chunk lives inside the payload of a record. Offsets stay valid
+ * when the record is copied, so chunks are written straight from the payload
+ * into the value that gets put.
+ */
+struct CDataChunkSpan
+{
+    uint16_t nPlacement;
+    std::string Salt;
+    size_t nOffset;
+    size_t nSize;
+};
+
+/**
+ * Appends a chunk value received from the DHT to vchPayload. libtorrent shows
+ * binary values as hex, so when fDecodeHex is set hex values are decoded on
+ * the fly and anything else is appended as it is.
+ */
+void AppendChunkValue(const char* pbegin, const char* pend, const bool fDecodeHex, std::vector<unsigned char>& vchPayload);
+
 class CDataChunk
 {
 public:
@@ -9,6 +9,7 @@
 #include "util.h"
 #include "utilstrencodings.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -50,7 +51,7 @@ CDataRecord::CDataRecord(const std::string& opCode, const uint16_t slots, const
     dataHeader.nVersion = version;
     dataHeader.nExpireTime = expire;
     dataHeader.nFormat = (uint32_t)format;
-    dataHeader.Salt = strOperationCode + ":" + std::to_string(0);
+    dataHeader.Salt = GetChunkSalt(strOperationCode, 0);
     dataHeader.nUnlockTime = GetTime() + 30; // default to unlocks in 30 seconds
     dataHeader.nTimeStamp = GetTime(); // unlocks in 30 seconds
     if (format != DHT::DataFormat::Null) {
@@ -66,10 +67,9 @@ CDataRecord::CDataRecord(const std::string& opCode, const uint16_t slots, const
 
 bool CDataRecord::InitPut()
 {
-    std::vector<unsigned char> vchRaw;
     if (dataHeader.nVersion == 1)
     {
-        if (!Encrypt(vPubKeys, vchData, vchRaw, strErrorMessage))
+        if (!Encrypt(vPubKeys, vchData, vchPayload, strErrorMessage))
         {
             LogPrintf("CDataRecord::%s -- Encrypt failed: %s\n", __func__, strErrorMessage);
             return false;
@@ -77,66 +77,42 @@ bool CDataRecord::InitPut()
     }
     else if (dataHeader.nVersion == 0)
     {
-       vchRaw = vchData;
+       vchPayload = vchData;
     }
     else
     {
         strErrorMessage = "Unknown and unsupported version.";
         return false;
     }
-    if (vchRaw.size() > DHT_DATA_MAX_CHUNK_SIZE * nTotalSlots) {
+    if (vchPayload.size() > DHT_DATA_MAX_CHUNK_SIZE * nTotalSlots) {
         strErrorMessage = "Data is too large for this operation code.";
         return false;
     }
 
-    if (vchRaw.size() > DHT_DATA_MAX_CHUNK_SIZE) {
-        // We need to chunk into many pieces.
-        uint32_t size = 0;
-        uint16_t total_chunks = (vchRaw.size() / DHT_DATA_MAX_CHUNK_SIZE) + 1;
-        for (unsigned int i = 0; i < total_chunks; i++) {
-            uint16_t nPlacement = i + 1;
-            std::vector<unsigned char>::const_iterator first = vchRaw.begin() + (i * DHT_DATA_MAX_CHUNK_SIZE);
-            std::vector<unsigned char>::const_iterator last;
-            if (i + 1 == total_chunks)
-            {
-                last = vchRaw.end();
-            }
-            else
-            {
-                last = vchRaw.begin() + (i * DHT_DATA_MAX_CHUNK_SIZE) + DHT_DATA_MAX_CHUNK_SIZE;
-            }
-            std::vector<unsigned char> vchChunk(first, last);
-            std::string strSalt = strOperationCode + ":" + std::to_string(nPlacement);
-            CDataChunk chunk(i, nPlacement, strSalt, vchChunk);
-            vChunks.push_back(chunk);
-            size = size + vchChunk.size();
-        }
-        dataHeader.nChunks = total_chunks;
-        dataHeader.nChunkSize = DHT_DATA_MAX_CHUNK_SIZE;
-        dataHeader.nIndexLocation = 0;
-        dataHeader.nDataSize = size;
-    }
-    else
-    {
-        std::string strSalt = strOperationCode + ":" + std::to_string(1);
-        CDataChunk chunk(1, 1, strSalt, vchRaw);
-        vChunks.push_back(chunk);
-        dataHeader.nChunks = 1;
-        dataHeader.nChunkSize = vchRaw.size();
-        dataHeader.nIndexLocation = 0;
-        dataHeader.nDataSize = vchRaw.size();
+    // Chunks only point into the payload, their bytes are copied once when they are put
+    const uint16_t nChunks = std::max<size_t>((vchPayload.size() + DHT_DATA_MAX_CHUNK_SIZE - 1) / DHT_DATA_MAX_CHUNK_SIZE, 1);
+    vChunkSpans.reserve(nChunks);
+    for (uint16_t i = 0; i < nChunks; i++) {
+        const uint16_t nPlacement = i + 1;
+        const size_t nOffset = i * DHT_DATA_MAX_CHUNK_SIZE;
+        const size_t nSize = std::min<size_t>(vchPayload.size() - nOffset, DHT_DATA_MAX_CHUNK_SIZE);
+        vChunkSpans.push_back(CDataChunkSpan{nPlacement, GetChunkSalt(strOperationCode, nPlacement), nOffset, nSize});
     }
+    dataHeader.nChunks = nChunks;
+    dataHeader.nChunkSize = nChunks > 1 ? DHT_DATA_MAX_CHUNK_SIZE : vchPayload.size();
+    dataHeader.nIndexLocation = 0;
+    dataHeader.nDataSize = vchPayload.size();
     return true;
 }
 
 bool CDataRecord::InitClear()
 {
-    std::string strNullValue = ZeroString();
+    // All slots share the null value
+    vchPayload = ZeroCharVector();
+    vChunkSpans.reserve(nTotalSlots);
     for(unsigned int i = 0; i < nTotalSlots; i++) {
         uint16_t nPlacement = i + 1;
-        std::string strSalt = strOperationCode + ":" + std::to_string(nPlacement);
-        CDataChunk chunk(i, nPlacement, strSalt, strNullValue);
-        vChunks.push_back(chunk);
+        vChunkSpans.push_back(CDataChunkSpan{nPlacement, GetChunkSalt(strOperationCode, nPlacement), 0, vchPayload.size()});
     }
     dataHeader.nChunks = nTotalSlots;
     dataHeader.nChunkSize = 0;
@@ -145,8 +121,24 @@ bool CDataRecord::InitClear()
     return true;
 }
 
+std::vector<CDataChunk> CDataRecord::GetChunks() const
+{
+    std::vector<CDataChunk> vChunks;
+    vChunks.reserve(vChunkSpans.size());
+    for (const CDataChunkSpan& span : vChunkSpans) {
+        std::vector<unsigned char>::const_iterator first = vchPayload.begin() + span.nOffset;
+        vChunks.push_back(CDataChunk(span.nPlacement - 1, span.nPlacement, span.Salt, std::vector<unsigned char>(first, first + span.nSize)));
+    }
+    return vChunks;
+}
+
+void CDataRecord::WriteChunk(const CDataChunkSpan& span, std::string& strValue) const
+{
+    strValue.assign((const char*)vchPayload.data() + span.nOffset, span.nSize);
+}
+
 CDataRecord::CDataRecord(const std::string& opCode, const uint16_t slots, const CRecordHeader& header, const std::vector<CDataChunk>& chunks, const std::vector<unsigned char>& privateKey)
-        : strOperationCode(opCode), nTotalSlots(slots),  nMode(DHT::DataMode::Get), dataHeader(header), vChunks(chunks)
+        : strOperationCode(opCode), nTotalSlots(slots),  nMode(DHT::DataMode::Get), dataHeader(header)
 {
     if (header.nVersion > 0 && privateKey.size() == 0)
         throw std::runtime_error("Decrypt entry requires a private key seed.\n");
@@ -155,35 +147,57 @@ CDataRecord::CDataRecord(const std::string& opCode, const uint16_t slots, const
         throw std::runtime_error("Number of chunks in header mismatches the data.\n");
 
     if (!dataHeader.IsNull()) {
-        if (InitGet(privateKey)) {
+        std::vector<unsigned char> vchChunks;
+        vchChunks.reserve(MaxPayloadSize());
+        for (const CDataChunk& chunk : chunks) {
+            const char* pbegin = (const char*)chunk.vchValue.data();
+            AppendChunkValue(pbegin, pbegin + chunk.vchValue.size(), dataHeader.Encrypted(), vchChunks);
+        }
+        if (InitGet(vchChunks, privateKey)) {
             fValid = true;
         }
     }
 }
 
-bool CDataRecord::InitGet(const std::vector<unsigned char>& privateKey)
+CDataRecord::CDataRecord(const std::string& opCode, const uint16_t slots, const CRecordHeader& header, const std::vector<std::string>& chunkValues, const std::vector<unsigned char>& privateKey)
+        : strOperationCode(opCode), nTotalSlots(slots),  nMode(DHT::DataMode::Get), dataHeader(header)
 {
-    std::vector<unsigned char> vchChunks;
-    for(unsigned int i = 0; i < dataHeader.nChunks; i++) {
-        vchChunks.insert(vchChunks.end(), vChunks[i].vchValue.begin(), vChunks[i].vchValue.end());
-    }
-    std::vector<unsigned char> vchUnHexValue;
-    std::string strChunk = stringFromVch(vchChunks);
-    if (IsHex(strChunk)) {
-        vchUnHexValue = ParseHex(strChunk);
-    } else {
-        vchUnHexValue = vchChunks;
+    if (header.nVersion > 0 && privateKey.size() == 0)
+        throw std::runtime_error("Decrypt entry requires a private key seed.\n");
+
+    if (header.nChunks != chunkValues.size())
+        throw std::runtime_error("Number of chunks in header mismatches the data.\n");
+
+    if (!dataHeader.IsNull()) {
+        std::vector<unsigned char> vchChunks;
+        vchChunks.reserve(MaxPayloadSize());
+        for (const std::string& strValue : chunkValues)
+            AppendChunkValue(strValue.data(), strValue.data() + strValue.size(), dataHeader.Encrypted(), vchChunks);
+
+        if (InitGet(vchChunks, privateKey)) {
+            fValid = true;
+        }
     }
-    if (vchUnHexValue.size() != dataHeader.nDataSize)
+}
+
+size_t CDataRecord::MaxPayloadSize() const
+{
+    // The header comes from the DHT, don't let it reserve more than the chunks can hold
+    return std::min<size_t>(dataHeader.nDataSize, (size_t)dataHeader.nChunks * DHT_DATA_MAX_CHUNK_SIZE);
+}
+
+bool CDataRecord::InitGet(std::vector<unsigned char>& vchChunks, const std::vector<unsigned char>& privateKey)
+{
+    if (vchChunks.size() != dataHeader.nDataSize)
     {
-        LogPrintf("CDataRecord::%s --Warning, data size in header (%d) mismatches the total size (%d) from all chunks (%d).\n", __func__, dataHeader.nDataSize, vchUnHexValue.size(), dataHeader.nChunks);
+        LogPrintf("CDataRecord::%s --Warning, data size in header (%d) mismatches the total size (%d) from all chunks (%d).\n", __func__, dataHeader.nDataSize, vchChunks.size(), dataHeader.nChunks);
     }
     if (dataHeader.nVersion == 0) {
-        vchData = vchChunks;
+        vchData.swap(vchChunks);
     }
     else if (dataHeader.nVersion == 1) {
 
-        if (!Decrypt(privateKey, vchUnHexValue, vchData, strErrorMessage)) {
+        if (!Decrypt(privateKey, vchChunks, vchData, strErrorMessage)) {
             return false;
         }
     }
@@ -29,7 +29,9 @@ private:
 
     std::vector<unsigned char> vchData;
     CRecordHeader dataHeader;
-    std::vector<CDataChunk> vChunks;
+    // Put mode: the encrypted or clear data that is split into chunks
+    std::vector<unsigned char> vchPayload;
+    std::vector<CDataChunkSpan> vChunkSpans;
     std::string strErrorMessage;
     std::vector<std::vector<unsigned char>> vPubKeys;
     bool fValid = false;
@@ -42,6 +44,9 @@ public:
 
     CDataRecord(const std::string& opCode, const uint16_t slots, const CRecordHeader& header, const std::vector<CDataChunk>& chunks, const std::vector<unsigned char>& privateKey);
 
+    /** Reassembles a record from the chunk values as they came from the DHT, in placement order */
+    CDataRecord(const std::string& opCode, const uint16_t slots, const CRecordHeader& header, const std::vector<std::string>& chunkValues, const std::vector<unsigned char>& privateKey);
+
     std::vector<unsigned char> vchOwnerFQDN;
 
     std::string OperationCode() const { return strOperationCode; }
@@ -51,7 +56,10 @@ public:
     bool Encrypted() { return dataHeader.Encrypted(); }
     uint16_t Version() { return dataHeader.nVersion; }
 
-    std::vector<CDataChunk> GetChunks() const { return vChunks; }
+    std::vector<CDataChunk> GetChunks() const;
+    const std::vector<CDataChunkSpan>& GetChunkSpans() const { return vChunkSpans; }
+    /** Copies the bytes of a chunk into strValue, for example the string of the entry that is put */
+    void WriteChunk(const CDataChunkSpan& span, std::string& strValue) const;
     std::string Value() const;
     std::string ErrorMessage() { return strErrorMessage; }
     DHT::DataMode Mode() const { return nMode; }
@@ -61,7 +69,8 @@ public:
 private:
     bool InitPut();
     bool InitClear();
-    bool InitGet(const std::vector<unsigned char>& privateKey);
+    bool InitGet(std::vector<unsigned char>& vchChunks, const std::vector<unsigned char>& privateKey);
+    size_t MaxPayloadSize() const;
 };
 
 class CDataRecordBuffer
@@ -0,0 +1,87 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/eventbuffer.h"
+
+#include <algorithm>
+
+CEventBuffer::CEventBuffer(size_t nCapacity)
+{
+    vEvents.resize(std::max<size_t>(nCapacity, 1));
+}
+
+void CEventBuffer::Push(const CEvent& event)
+{
+    LOCK(cs);
+    int64_t nTime = event.Timestamp();
+    if (nCount > 0)
+        nTime = std::max(nTime, At(nCount - 1).first);
+
+    if (nCount == vEvents.size()) {
+        vEvents[nHead] = std::make_pair(nTime, event);
+        nHead = (nHead + 1) % vEvents.size();
+        return;
+    }
+    vEvents[(nHead + nCount) % vEvents.size()] = std::make_pair(nTime, event);
+    nCount++;
+}
+
+size_t CEventBuffer::Expire(int64_t nTime)
+{
+    LOCK(cs);
+    size_t nExpired = 0;
+    while (nCount > 0 && vEvents[nHead].first < nTime) {
+        // release the event strings
+        vEvents[nHead].second = CEvent();
+        nHead = (nHead + 1) % vEvents.size();
+        nCount--;
+        nExpired++;
+    }
+    return nExpired;
+}
+
+size_t CEventBuffer::LowerBound(int64_t nTime) const
+{
+    size_t nLow = 0;
+    size_t nHigh = nCount;
+    while (nLow < nHigh) {
+        const size_t nMid = nLow + (nHigh - nLow) / 2;
+        if (At(nMid).first < nTime) {
+            nLow = nMid + 1;
+        } else {
+            nHigh = nMid;
+        }
+    }
+    return nLow;
+}
+
+void CEventBuffer::GetEvents(int64_t nStartTime, std::vector<CEvent>& events) const
+{
+    LOCK(cs);
+    for (size_t n = LowerBound(nStartTime); n < nCount; n++)
+        events.push_back(At(n).second);
+}
+
+void CEventBuffer::GetEvents(int type, int64_t nStartTime, std::vector<CEvent>& events) const
+{
+    LOCK(cs);
+    for (size_t n = LowerBound(nStartTime); n < nCount; n++) {
+        if (At(n).second.Type() == type)
+            events.push_back(At(n).second);
+    }
+}
+
+void CEventBuffer::Clear()
+{
+    LOCK(cs);
+    std::fill(vEvents.begin(), vEvents.end(), std::make_pair(int64_t(0), CEvent()));
+    nHead = 0;
+    nCount = 0;
+}
+
+size_t CEventBuffer::size() const
+{
+    LOCK(cs);
+    return nCount;
+}
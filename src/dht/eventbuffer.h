@@ -0,0 +1,57 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_DHT_EVENT_BUFFER_H
+#define DYNAMIC_DHT_EVENT_BUFFER_H
+
+#include "dht/sessionevents.h"
+#include "sync.h"
+
+#include <utility>
+#include <vector>
+
+/** Session events kept per DHT session, older ones are overwritten */
+static const size_t DHT_EVENT_BUFFER_SIZE = 10000;
+/** Milliseconds session events are kept */
+static const int64_t DHT_EVENT_EXPIRE_MILLIS = 5 * 60 * 1000;
+
+/**
+ * Fixed capacity ring buffer of session events in time order.
+ *
+ * Events are appended in the order the listener pops them, so the buffer is
+ * sorted by time: adding and expiring events only touch its ends, and time
+ * range queries start at a binary search. Event times that go backwards are
+ * raised to the last time so the order holds across clock adjustments.
+ */
+class CEventBuffer
+{
+public:
+    explicit CEventBuffer(size_t nCapacity = DHT_EVENT_BUFFER_SIZE);
+
+    /** Append an event, overwriting the oldest one when full */
+    void Push(const CEvent& event);
+    /** Drop events older than nTime, returns the number dropped */
+    size_t Expire(int64_t nTime);
+    /** Append events at or after nStartTime to events, oldest first */
+    void GetEvents(int64_t nStartTime, std::vector<CEvent>& events) const;
+    /** Same, only events of type */
+    void GetEvents(int type, int64_t nStartTime, std::vector<CEvent>& events) const;
+    void Clear();
+
+    size_t size() const;
+    size_t capacity() const { return vEvents.size(); }
+
+private:
+    mutable CCriticalSection cs;
+    // (ordering time, event), nCount of them starting at nHead
+    std::vector<std::pair<int64_t, CEvent>> vEvents;
+    size_t nHead = 0;
+    size_t nCount = 0;
+
+    const std::pair<int64_t, CEvent>& At(size_t n) const { return vEvents[(nHead + n) % vEvents.size()]; }
+    /** Position of the first event at or after nTime */
+    size_t LowerBound(int64_t nTime) const;
+};
+
+#endif // DYNAMIC_DHT_EVENT_BUFFER_H
@@ -5,9 +5,11 @@
 #include "dht/mutable.h"
 
 #include "bdap/utils.h"
+#include "dht/ed25519.h"
 #include "hash.h"
 #include "streams.h"
 #include "tinyformat.h"
+#include "utilstrencodings.h"
 
 #include <univalue.h>
 
@@ -42,17 +44,17 @@ bool CMutableData::UnserializeFromData(const std::vector<unsigned char>& vchData
 
 std::string CMutableData::InfoHash() const
 {
-    return stringFromVch(vchInfoHash);
+    return HexStr(vchInfoHash);
 }
 
 std::string CMutableData::PublicKey() const
 {
-    return stringFromVch(vchPublicKey);
+    return HexStr(vchPublicKey);
 }
 
 std::string CMutableData::Signature() const
 {
-    return stringFromVch(vchSignature);
+    return HexStr(vchSignature);
 }
 
 std::string CMutableData::Salt() const
@@ -69,4 +71,17 @@ std::string CMutableData::ToString() const
 {
     return strprintf("CMutableData(\nInfoHash = %s\n, PublicKey = %s\n, Salt = %s\n, Seq = %d\n, Signature = %s\n, Value = %s)\n",
         InfoHash(), PublicKey(), Salt(), SequenceNumber, Signature(), Value());
-}
\ No newline at end of file
+}
+
+bool CMutableData::UpgradeFromHex()
+{
+    if (nVersion >= BINARY_VERSION)
+        return true;
+
+    vchInfoHash = ParseHex(stringFromVch(vchInfoHash));
+    vchPublicKey = ParseHex(stringFromVch(vchPublicKey));
+    vchSignature = ParseHex(stringFromVch(vchSignature));
+    nVersion = CURRENT_VERSION;
+    return vchInfoHash.size() == uint160().size() && vchPublicKey.size() == ED25519_PUBLIC_KEY_BYTE_LENGTH &&
+           vchSignature.size() == ED25519_SIGTATURE_BYTE_LENGTH;
+}
@@ -10,9 +10,18 @@
 
 #include "uint256.h"
 
+/**
+ * Mutable DHT item stored by this node.
+ *
+ * The info hash (20 byte target), public key (32 bytes) and signature
+ * (64 bytes) are held as raw bytes, the accessors return them hex encoded.
+ * Version 1 records kept the hex strings and repeated the info hash in the
+ * value; from version 2 on the target is only stored in the database key.
+ */
 class CMutableData {
 public:
-    static const int CURRENT_VERSION = 1;
+    static const int BINARY_VERSION = 2;
+    static const int CURRENT_VERSION = BINARY_VERSION;
     int nVersion;
     CharString vchInfoHash;  // key
     CharString vchPublicKey;
@@ -45,7 +54,8 @@ public:
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
         READWRITE(this->nVersion);
-        READWRITE(vchInfoHash);
+        if (this->nVersion < BINARY_VERSION)
+            READWRITE(vchInfoHash);
         READWRITE(vchPublicKey);
         READWRITE(vchSignature);
         READWRITE(VARINT(SequenceNumber));
@@ -83,6 +93,9 @@ public:
     std::string Value() const;
     std::string ToString() const;
 
+    /** Convert a version 1 record with hex encoded fields, false if malformed */
+    bool UpgradeFromHex();
+
 };
 
 #endif // DYNAMIC_DHT_MUTABLE_DATA_H
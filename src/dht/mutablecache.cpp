@@ -0,0 +1,176 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/mutablecache.h"
+
+#include "dht/mutable.h"
+#include "hash.h"
+#include "memusage.h"
+#include "random.h"
+
+#include <limits>
+
+SaltedTargetHasher::SaltedTargetHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+size_t SaltedTargetHasher::operator()(const uint160& target) const
+{
+    return CSipHasher(k0, k1).Write(target.begin(), target.size()).Finalize();
+}
+
+CMutableDataCache::CMutableDataCache(size_t nMaxUsageIn) : nMaxUsage(nMaxUsageIn), nValueUsage(0), fEvicted(false)
+{
+}
+
+size_t CMutableDataCache::ValueUsage(const CMutableData& data)
+{
+    return memusage::MallocUsage(sizeof(CMutableData)) + memusage::DynamicUsage(data.vchInfoHash) +
+           memusage::DynamicUsage(data.vchPublicKey) + memusage::DynamicUsage(data.vchSignature) +
+           memusage::DynamicUsage(data.vchSalt) + memusage::DynamicUsage(data.vchValue) +
+           memusage::MallocUsage(sizeof(uint160) + 2 * sizeof(void*)); // LRU list node
+}
+
+CMutableDataCache::IndexMap::iterator CMutableDataCache::Insert(const uint160& target)
+{
+    IndexMap::iterator it = mapIndex.find(target);
+    if (it != mapIndex.end())
+        return it;
+
+    it = mapIndex.emplace(target, CIndexEntry()).first;
+    it->second.nPos = vTargets.size();
+    it->second.itLRU = listLRU.end();
+    vTargets.push_back(target);
+    return it;
+}
+
+void CMutableDataCache::DropValue(CIndexEntry& entry)
+{
+    if (!entry.pData)
+        return;
+
+    nValueUsage -= ValueUsage(*entry.pData);
+    entry.pData.reset();
+    listLRU.erase(entry.itLRU);
+    entry.itLRU = listLRU.end();
+}
+
+size_t CMutableDataCache::IndexUsage() const
+{
+    return memusage::DynamicUsage(mapIndex) + memusage::DynamicUsage(vTargets);
+}
+
+void CMutableDataCache::Evict(size_t nKeep)
+{
+    // Drop least recently used values until they fit next to the index
+    while (nValueUsage + IndexUsage() > nMaxUsage && listLRU.size() > nKeep) {
+        DropValue(mapIndex.find(listLRU.back())->second);
+        fEvicted = true;
+    }
+}
+
+void CMutableDataCache::Put(const uint160& target, const CMutableData& data)
+{
+    LOCK(cs);
+    CIndexEntry& entry = Insert(target)->second;
+    DropValue(entry);
+    entry.pData.reset(new CMutableData(data));
+    nValueUsage += ValueUsage(data);
+    listLRU.push_front(target);
+    entry.itLRU = listLRU.begin();
+
+    // Always keep the new value
+    Evict(1);
+}
+
+void CMutableDataCache::AddTarget(const uint160& target)
+{
+    LOCK(cs);
+    Insert(target);
+    Evict(0);
+}
+
+bool CMutableDataCache::Get(const uint160& target, CMutableData& data)
+{
+    LOCK(cs);
+    IndexMap::iterator it = mapIndex.find(target);
+    if (it == mapIndex.end() || !it->second.pData)
+        return false;
+
+    data = *it->second.pData;
+    listLRU.splice(listLRU.begin(), listLRU, it->second.itLRU);
+    return true;
+}
+
+bool CMutableDataCache::Contains(const uint160& target) const
+{
+    LOCK(cs);
+    return mapIndex.count(target) > 0;
+}
+
+void CMutableDataCache::Erase(const uint160& target)
+{
+    LOCK(cs);
+    IndexMap::iterator it = mapIndex.find(target);
+    if (it == mapIndex.end())
+        return;
+
+    DropValue(it->second);
+    // Move the last target into the hole to keep vTargets dense
+    const size_t nPos = it->second.nPos;
+    if (nPos + 1 != vTargets.size()) {
+        vTargets[nPos] = vTargets.back();
+        mapIndex.find(vTargets[nPos])->second.nPos = nPos;
+    }
+    vTargets.pop_back();
+    mapIndex.erase(it);
+}
+
+void CMutableDataCache::Clear()
+{
+    LOCK(cs);
+    mapIndex.clear();
+    vTargets.clear();
+    listLRU.clear();
+    nValueUsage = 0;
+    fEvicted = false;
+}
+
+bool CMutableDataCache::SelectRandom(uint160& target) const
+{
+    LOCK(cs);
+    if (vTargets.empty())
+        return false;
+
+    target = vTargets[GetRand(vTargets.size())];
+    return true;
+}
+
+std::vector<uint160> CMutableDataCache::GetTargets() const
+{
+    LOCK(cs);
+    return vTargets;
+}
+
+size_t CMutableDataCache::size() const
+{
+    LOCK(cs);
+    return vTargets.size();
+}
+
+size_t CMutableDataCache::CachedValues() const
+{
+    LOCK(cs);
+    return listLRU.size();
+}
+
+bool CMutableDataCache::IsFull() const
+{
+    LOCK(cs);
+    return fEvicted || nValueUsage + IndexUsage() >= nMaxUsage;
+}
+
+size_t CMutableDataCache::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    return nValueUsage + IndexUsage();
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_DHT_MUTABLE_CACHE_H
+#define DYNAMIC_DHT_MUTABLE_CACHE_H
+
+#include "dht/mutable.h"
+#include "sync.h"
+#include "uint256.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/** Default for -dhtcachemb, memory for the DHT item index and cached values */
+static const int64_t DEFAULT_DHT_CACHE_MB = 64;
+
+class SaltedTargetHasher
+{
+private:
+    /** Salt */
+    const uint64_t k0, k1;
+
+public:
+    SaltedTargetHasher();
+
+    size_t operator()(const uint160& target) const;
+};
+
+/**
+ * In-memory layer over the local DHT mutable item database.
+ *
+ * Every stored item is indexed by its 20 byte target, so lookups of unknown
+ * targets never reach LevelDB and a uniformly random target is picked in O(1).
+ * Values are only kept for the most recently used items, until they and the
+ * index together use nMaxUsage bytes; older ones are read back from the
+ * database. The index itself is never evicted, so it may exceed nMaxUsage on
+ * its own, with no values cached.
+ */
+class CMutableDataCache
+{
+public:
+    explicit CMutableDataCache(size_t nMaxUsageIn);
+
+    /** Index a target and cache its value */
+    void Put(const uint160& target, const CMutableData& data);
+    /** Index a target without caching its value */
+    void AddTarget(const uint160& target);
+    /** Cached value of target, false if unknown or not cached */
+    bool Get(const uint160& target, CMutableData& data);
+    bool Contains(const uint160& target) const;
+    void Erase(const uint160& target);
+    void Clear();
+    /** Pick a uniformly random indexed target */
+    bool SelectRandom(uint160& target) const;
+    std::vector<uint160> GetTargets() const;
+
+    size_t size() const;
+    size_t CachedValues() const;
+    /** True when new values only fit by evicting others */
+    bool IsFull() const;
+    size_t DynamicMemoryUsage() const;
+
+private:
+    struct CIndexEntry {
+        size_t nPos; // in vTargets
+        std::unique_ptr<CMutableData> pData; // null when not cached
+        std::list<uint160>::iterator itLRU;
+    };
+    typedef std::unordered_map<uint160, CIndexEntry, SaltedTargetHasher> IndexMap;
+
+    IndexMap::iterator Insert(const uint160& target);
+    void DropValue(CIndexEntry& entry);
+    /** Drop least recently used values over the limit, keeping at least nKeep */
+    void Evict(size_t nKeep);
+    size_t IndexUsage() const;
+    static size_t ValueUsage(const CMutableData& data);
+
+    mutable CCriticalSection cs;
+    const size_t nMaxUsage;
+    size_t nValueUsage;
+    // values were evicted to make room since the last Clear
+    bool fEvicted;
+    IndexMap mapIndex;
+    std::vector<uint160> vTargets;
+    // targets with a cached value, most recently used first
+    std::list<uint160> listLRU;
+};
+
+#endif // DYNAMIC_DHT_MUTABLE_CACHE_H
@@ -6,16 +6,33 @@
 
 #include "dht/mutable.h"
 #include "util.h"
+#include "utilstrencodings.h"
 
 #include <univalue.h>
 
 #include <boost/thread.hpp>
 
-#include "map"
+CMutableDataDB *pMutableDataDB = NULL;
 
-static std::map<std::vector<unsigned char>, CMutableData> mapDataStorage;
+// Callers pass hex encoded info hashes, items are keyed on their 20 bytes
+static bool GetTarget(const std::vector<unsigned char>& vchInfoHash, uint160& target)
+{
+    const std::vector<unsigned char> vchTarget = ParseHex(std::string(vchInfoHash.begin(), vchInfoHash.end()));
+    if (vchTarget.size() != target.size())
+        return false;
 
-CMutableDataDB *pMutableDataDB = NULL;
+    target = uint160(vchTarget);
+    return true;
+}
+
+static bool GetDataTarget(const CMutableData& data, uint160& target)
+{
+    if (data.vchInfoHash.size() != target.size())
+        return false;
+
+    target = uint160(data.vchInfoHash);
+    return true;
+}
 
 bool AddLocalMutableData(const std::vector<unsigned char>& vchInfoHash,const  CMutableData& data)
 {
@@ -47,13 +64,22 @@ bool GetLocalMutableData(const std::vector<unsigned char>& vchInfoHash, CMutable
     return !data.IsNull();
 }
 
+bool GetLocalMutableData(const uint160& target, CMutableData& data)
+{
+    if (!pMutableDataDB || !pMutableDataDB->ReadMutableData(target, data)) {
+        return false;
+    }
+    return !data.IsNull();
+}
+
 bool PutLocalMutableData(const std::vector<unsigned char>& vchInfoHash, const CMutableData& data)
 {
     if (!pMutableDataDB) {
         return false;
     }
     CMutableData readMutableData;
-    if (pMutableDataDB->ReadMutableData(vchInfoHash, readMutableData)) {
+    uint160 target;
+    if (GetDataTarget(data, target) && pMutableDataDB->ReadMutableData(target, readMutableData)) {
         UpdateLocalMutableData(vchInfoHash, data);
     }
     else {
@@ -64,10 +90,11 @@ bool PutLocalMutableData(const std::vector<unsigned char>& vchInfoHash, const CM
 
 bool EraseLocalMutableData(const std::vector<unsigned char>& vchInfoHash)
 {
-    if (!pMutableDataDB) {
+    uint160 target;
+    if (!pMutableDataDB || !GetTarget(vchInfoHash, target)) {
         return false;
     }
-    if (!pMutableDataDB->EraseMutableData(vchInfoHash)) {
+    if (!pMutableDataDB->EraseMutableData(target)) {
         return false;
     }
     return true;
@@ -84,6 +111,14 @@ bool GetAllLocalMutableData(std::vector<CMutableData>& vchMutableData)
     return true;
 }
 
+bool GetAllLocalMutableTargets(std::vector<uint160>& vTargets)
+{
+    if (!pMutableDataDB)
+        return false;
+
+    return pMutableDataDB->ListTargets(vTargets);
+}
+
 bool InitMemoryMap()
 {
     if (!pMutableDataDB)
@@ -116,67 +151,88 @@ bool CheckMutableItemDB()
 
 bool CMutableDataDB::AddMutableData(const CMutableData& data)
 {
+    uint160 target;
+    if (!GetDataTarget(data, target))
+        return false;
+
     bool writeState = false;
     {
         LOCK(cs_dht_entry);
-        writeState = CDBWrapper::Write(make_pair(std::string("ih"), data.vchInfoHash), data);  // use info hash as key
-        if (count >= 0) {
-            mapDataStorage[data.vchInfoHash] = data;
-            count++;
-        }
+        writeState = CDBWrapper::Write(std::make_pair(DB_MUTABLE_ITEM, target), data);
+        if (writeState && fLoaded)
+            cache.Put(target, data);
     }
     return writeState;
 }
 
 bool CMutableDataDB::ReadMutableData(const std::vector<unsigned char>& vchInfoHash, CMutableData& data)
 {
-    if (count >= 0) {
-        data = mapDataStorage[vchInfoHash];
-        if (!data.IsNull())
+    uint160 target;
+    if (!GetTarget(vchInfoHash, target))
+        return false;
+
+    return ReadMutableData(target, data);
+}
+
+bool CMutableDataDB::ReadMutableData(const uint160& target, CMutableData& data)
+{
+    if (fLoaded) {
+        if (cache.Get(target, data))
             return true;
+        // Every stored item is indexed
+        if (!cache.Contains(target))
+            return false;
     }
 
     LOCK(cs_dht_entry);
-    return CDBWrapper::Read(make_pair(std::string("ih"), vchInfoHash), data);
+    if (!CDBWrapper::Read(std::make_pair(DB_MUTABLE_ITEM, target), data))
+        return false;
+
+    data.vchInfoHash.assign(target.begin(), target.end());
+    if (fLoaded)
+        cache.Put(target, data);
+    return true;
 }
 
-bool CMutableDataDB::EraseMutableData(const std::vector<unsigned char>& vchInfoHash)
+bool CMutableDataDB::EraseMutableData(const uint160& target)
 {
     LOCK(cs_dht_entry);
-    if (count >= 0)
-        mapDataStorage.erase(vchInfoHash);
+    if (fLoaded)
+        cache.Erase(target);
 
-    return CDBWrapper::Erase(make_pair(std::string("ih"), vchInfoHash));
+    return CDBWrapper::Erase(std::make_pair(DB_MUTABLE_ITEM, target));
 }
 
 bool CMutableDataDB::UpdateMutableData(const CMutableData& data)
 {
-    LOCK(cs_dht_entry);
-
-    if (!EraseMutableData(data.vchInfoHash))
+    uint160 target;
+    if (!GetDataTarget(data, target))
         return false;
 
-    bool writeState = false;
-    writeState = CDBWrapper::Update(make_pair(std::string("ih"), data.vchInfoHash), data);
-    if (count >= 0)
-        mapDataStorage[data.vchInfoHash] = data;
+    LOCK(cs_dht_entry);
+    // Overwrites the previous value stored under the same key
+    bool writeState = CDBWrapper::Update(std::make_pair(DB_MUTABLE_ITEM, target), data);
+    if (writeState && fLoaded)
+        cache.Put(target, data);
 
     return writeState;
 }
 
 bool CMutableDataDB::ListMutableData(std::vector<CMutableData>& vchMutableData)
 {
-    std::pair<std::string, CharString> infoHash;
+    std::pair<char, uint160> key;
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->SeekToFirst();
+    pcursor->Seek(std::make_pair(DB_MUTABLE_ITEM, uint160()));
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
         CMutableData data;
         try {
-            if (pcursor->GetKey(infoHash) && infoHash.first == "ih") {
-                pcursor->GetValue(data);
-                vchMutableData.push_back(data);
-            }
+            if (!pcursor->GetKey(key) || key.first != DB_MUTABLE_ITEM)
+                break;
+
+            pcursor->GetValue(data);
+            data.vchInfoHash.assign(key.second.begin(), key.second.end());
+            vchMutableData.push_back(data);
             pcursor->Next();
         }
         catch (std::exception& e) {
@@ -186,40 +242,103 @@ bool CMutableDataDB::ListMutableData(std::vector<CMutableData>& vchMutableData)
     return true;
 }
 
+bool CMutableDataDB::ListTargets(std::vector<uint160>& vTargets) const
+{
+    if (!fLoaded)
+        return false;
+
+    vTargets = cache.GetTargets();
+    return true;
+}
+
 bool CMutableDataDB::LoadMemoryMap()
 {
-    std::pair<std::string, CharString> infoHash;
+    std::pair<char, uint160> key;
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->SeekToFirst();
-    count = 0;
+    pcursor->Seek(std::make_pair(DB_MUTABLE_ITEM, uint160()));
+    cache.Clear();
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        CMutableData data;
         try {
-            if (pcursor->GetKey(infoHash) && infoHash.first == "ih") {
+            if (!pcursor->GetKey(key) || key.first != DB_MUTABLE_ITEM)
+                break;
+
+            // Index every item, but only warm the cache up to its limit
+            if (cache.IsFull()) {
+                cache.AddTarget(key.second);
+            }
+            else {
+                CMutableData data;
                 pcursor->GetValue(data);
-                mapDataStorage[infoHash.second] = data;
+                data.vchInfoHash.assign(key.second.begin(), key.second.end());
+                cache.Put(key.second, data);
             }
             pcursor->Next();
-            count++;
         }
         catch (std::exception& e) {
             return error("%s() : deserialize error", __PRETTY_FUNCTION__);
         }
     }
+    fLoaded = true;
+    LogPrintf("%s -- %d items, %d cached, %d bytes\n", __func__, cache.size(), cache.CachedValues(), cache.DynamicMemoryUsage());
     return true;
 }
 
-bool CMutableDataDB::SelectRandomMutableItem(CMutableData& randomItem) {
-    if (count < 1)
+bool CMutableDataDB::SelectRandomMutableItem(CMutableData& randomItem)
+{
+    uint160 target;
+    if (!fLoaded || !cache.SelectRandom(target))
         return false;
 
-    unsigned int nAdvance = 0;
-    std::map<std::vector<unsigned char>, CMutableData>::iterator it = mapDataStorage.begin();
-    if (count != 1) {
-        nAdvance = RandomIntegerRange(0, count - 1);
+    return ReadMutableData(target, randomItem);
+}
+
+/** Upgrade the database from older formats.
+ *
+ * Currently implemented: from version 1 items, keyed on "ih" and the hex info
+ * hash with hex encoded public keys and signatures, to binary records keyed on
+ * DB_MUTABLE_ITEM and the target.
+ */
+bool CMutableDataDB::Upgrade()
+{
+    const std::pair<std::string, CharString> firstKey = std::make_pair(std::string("ih"), CharString());
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(firstKey);
+    if (!pcursor->Valid())
+        return true;
+
+    int64_t nUpgraded = 0, nDropped = 0;
+    LogPrintf("Upgrading DHT database...\n");
+    const size_t nBatchSize = 1 << 24;
+    CDBBatch batch(*this);
+    std::pair<std::string, CharString> key;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        if (!pcursor->GetKey(key) || key.first != "ih")
+            break;
+
+        CMutableData data;
+        uint160 target;
+        if (pcursor->GetValue(data) && data.UpgradeFromHex() && GetDataTarget(data, target)) {
+            batch.Write(std::make_pair(DB_MUTABLE_ITEM, target), data);
+            nUpgraded++;
+        }
+        else {
+            nDropped++;
+        }
+        batch.Erase(key);
+        if (batch.SizeEstimate() > nBatchSize) {
+            if (!WriteBatch(batch))
+                return error("%s: failed to write upgraded DHT items", __func__);
+            batch.Clear();
+        }
+        pcursor->Next();
     }
-    std::advance(it, nAdvance);
-    randomItem = it->second;
+    if (!WriteBatch(batch, true))
+        return error("%s: failed to write upgraded DHT items", __func__);
+
+    // "ii" is the next prefix, so this covers every "ih" key and nothing else that exists
+    CompactRange(firstKey, std::make_pair(std::string("ii"), CharString()));
+    LogPrintf("%s -- upgraded %d items, dropped %d malformed\n", __func__, nUpgraded, nDropped);
     return true;
-}
\ No newline at end of file
+}
@@ -6,36 +6,53 @@
 #define DYNAMIC_DHT_MUTABLE_DB_H
 
 #include "dbwrapper.h"
+#include "dht/mutablecache.h"
 #include "sync.h"
 
+#include <atomic>
+
 static CCriticalSection cs_dht_entry;
 
+/** Key prefix of mutable items, followed by their 20 byte target */
+static const char DB_MUTABLE_ITEM = 'm';
+
 class CMutableData;
 
 class CMutableDataDB : public CDBWrapper {
 public:
-    CMutableDataDB(size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate) : CDBWrapper(GetDataDir() / "dht", nCacheSize, fMemory, fWipe, obfuscate) {
+    CMutableDataDB(size_t nCacheSize, size_t nItemCacheSize, bool fMemory, bool fWipe, bool obfuscate) : CDBWrapper(GetDataDir() / "dht", nCacheSize, fMemory, fWipe, obfuscate), cache(nItemCacheSize) {
+    }
+    /** Database in path, for DHT nodes that do not serve this node's data directory */
+    CMutableDataDB(const boost::filesystem::path& path, size_t nCacheSize, size_t nItemCacheSize, bool fMemory, bool fWipe) : CDBWrapper(path, nCacheSize, fMemory, fWipe), cache(nItemCacheSize) {
     }
 
     bool AddMutableData(const CMutableData& data);
     bool UpdateMutableData(const CMutableData& data);
     bool ReadMutableData(const std::vector<unsigned char>& vchInfoHash, CMutableData& data);
-    bool EraseMutableData(const std::vector<unsigned char>& vchInfoHash);
+    bool ReadMutableData(const uint160& target, CMutableData& data);
+    bool EraseMutableData(const uint160& target);
     bool ListMutableData(std::vector<CMutableData>& vchMutableData);
+    bool ListTargets(std::vector<uint160>& vTargets) const;
     bool LoadMemoryMap();
+    bool Upgrade();
     bool SelectRandomMutableItem(CMutableData& randomItem);
-    int64_t Size() const { return count; }
+    int64_t Size() const { return fLoaded ? cache.size() : -1; }
+    size_t CacheUsage() const { return cache.DynamicMemoryUsage(); }
 
 private:
-	int64_t count = -1;
+    // The cache is used once LoadMemoryMap indexed every stored item
+    std::atomic<bool> fLoaded{false};
+    CMutableDataCache cache;
 
 };
 
 bool AddLocalMutableData(const std::vector<unsigned char>& vchInfoHash, const CMutableData& data);
 bool UpdateLocalMutableData(const std::vector<unsigned char>& vchInfoHash, const CMutableData& data);
 bool GetLocalMutableData(const std::vector<unsigned char>& vchInfoHash, CMutableData& data);
+bool GetLocalMutableData(const uint160& target, CMutableData& data);
 bool PutLocalMutableData(const std::vector<unsigned char>& vchInfoHash, const CMutableData& data);
 bool GetAllLocalMutableData(std::vector<CMutableData>& vchMutableData);
+bool GetAllLocalMutableTargets(std::vector<uint160>& vTargets);
 bool InitMemoryMap();
 bool SelectRandomMutableItem(CMutableData& randomItem);
 bool CheckMutableItemDB();
@@ -0,0 +1,137 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/reannounce.h"
+
+#include <algorithm>
+
+CReannounceScheduler reannounceScheduler;
+
+CReannounceScheduler::CReannounceScheduler(int64_t nIntervalIn) : nInterval(nIntervalIn)
+{
+}
+
+void CReannounceScheduler::Schedule(const uint160& target, CItemState& state, int64_t nNext)
+{
+    setQueue.erase(std::make_pair(state.nNextAnnounce, target));
+    state.nNextAnnounce = nNext;
+    setQueue.insert(std::make_pair(nNext, target));
+}
+
+void CReannounceScheduler::Sync(const std::vector<uint160>& vTargets, const std::function<bool(const uint160&)>& fnAnnounce)
+{
+    std::vector<uint160> vSorted(vTargets);
+    std::sort(vSorted.begin(), vSorted.end());
+
+    // fnAnnounce may read the database, check the new targets without holding cs
+    std::vector<uint160> vNew;
+    {
+        LOCK(cs);
+        for (const uint160& target : vSorted) {
+            if (!mapItems.count(target) && !setSkipped.count(target))
+                vNew.push_back(target);
+        }
+    }
+    std::vector<uint160> vAnnounce, vSkip;
+    for (const uint160& target : vNew) {
+        if (!fnAnnounce || fnAnnounce(target))
+            vAnnounce.push_back(target);
+        else
+            vSkip.push_back(target);
+    }
+
+    LOCK(cs);
+    std::map<uint160, CItemState>::iterator it = mapItems.begin();
+    while (it != mapItems.end()) {
+        if (!std::binary_search(vSorted.begin(), vSorted.end(), it->first)) {
+            setQueue.erase(std::make_pair(it->second.nNextAnnounce, it->first));
+            it = mapItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::set<uint160>::iterator itSkipped = setSkipped.begin();
+    while (itSkipped != setSkipped.end()) {
+        if (!std::binary_search(vSorted.begin(), vSorted.end(), *itSkipped))
+            itSkipped = setSkipped.erase(itSkipped);
+        else
+            ++itSkipped;
+    }
+    setSkipped.insert(vSkip.begin(), vSkip.end());
+    for (const uint160& target : vAnnounce) {
+        if (mapItems.count(target))
+            continue;
+        CItemState& state = mapItems[target];
+        state.nSequence = 0;
+        state.nAnnouncedSequence = -1;
+        state.nNextAnnounce = NEW_ITEM;
+        setQueue.insert(std::make_pair(NEW_ITEM, target));
+    }
+}
+
+void CReannounceScheduler::Update(const uint160& target, int64_t nSequence)
+{
+    LOCK(cs);
+    std::map<uint160, CItemState>::iterator it = mapItems.find(target);
+    if (it == mapItems.end()) {
+        CItemState& state = mapItems[target];
+        state.nSequence = nSequence;
+        state.nAnnouncedSequence = -1;
+        state.nNextAnnounce = UPDATED_ITEM;
+        setQueue.insert(std::make_pair(UPDATED_ITEM, target));
+        return;
+    }
+    CItemState& state = it->second;
+    state.nSequence = std::max(state.nSequence, nSequence);
+    if (state.nSequence > state.nAnnouncedSequence)
+        Schedule(target, state, UPDATED_ITEM);
+}
+
+void CReannounceScheduler::Remove(const uint160& target)
+{
+    LOCK(cs);
+    std::map<uint160, CItemState>::iterator it = mapItems.find(target);
+    if (it == mapItems.end())
+        return;
+
+    setQueue.erase(std::make_pair(it->second.nNextAnnounce, target));
+    mapItems.erase(it);
+}
+
+std::vector<uint160> CReannounceScheduler::PopDue(int64_t nNow, size_t nMax)
+{
+    std::vector<uint160> vDue;
+    LOCK(cs);
+    while (vDue.size() < nMax && !setQueue.empty() && setQueue.begin()->first <= nNow) {
+        const uint160 target = setQueue.begin()->second;
+        CItemState& state = mapItems[target];
+        state.nAnnouncedSequence = state.nSequence;
+        Schedule(target, state, nNow + nInterval);
+        vDue.push_back(target);
+    }
+    return vDue;
+}
+
+void CReannounceScheduler::PutResult(const uint160& target, int nNodes, int64_t nNow)
+{
+    if (nNodes >= DHT_REANNOUNCE_MIN_NODES)
+        return;
+
+    LOCK(cs);
+    std::map<uint160, CItemState>::iterator it = mapItems.find(target);
+    if (it != mapItems.end() && it->second.nNextAnnounce > nNow + DHT_REANNOUNCE_RETRY)
+        Schedule(target, it->second, nNow + DHT_REANNOUNCE_RETRY);
+}
+
+size_t CReannounceScheduler::size() const
+{
+    LOCK(cs);
+    return mapItems.size();
+}
+
+size_t CReannounceScheduler::DueCount(int64_t nNow) const
+{
+    LOCK(cs);
+    return std::distance(setQueue.begin(), setQueue.lower_bound(std::make_pair(nNow + 1, uint160())));
+}
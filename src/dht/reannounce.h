@@ -0,0 +1,81 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_DHT_REANNOUNCE_H
+#define DYNAMIC_DHT_REANNOUNCE_H
+
+#include "sync.h"
+#include "uint256.h"
+
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+/** Default for -dhtannouncerate, stored items re-announced per second */
+static const int64_t DEFAULT_DHT_ANNOUNCE_RATE = 10;
+/** Seconds between re-announcements of an item */
+static const int64_t DHT_REANNOUNCE_INTERVAL = 60 * 60;
+/** Seconds until an item stored on too few nodes is announced again */
+static const int64_t DHT_REANNOUNCE_RETRY = 5 * 60;
+/** Puts that reached fewer nodes than this are retried early */
+static const int DHT_REANNOUNCE_MIN_NODES = 8;
+/** Seconds between syncing the schedule with the local item database */
+static const int64_t DHT_REANNOUNCE_SYNC_INTERVAL = 5 * 60;
+
+/**
+ * Schedule for re-announcing the mutable items stored by this Dynode.
+ *
+ * Items are queued on their next announce time. Stored items with a sequence
+ * number above the last announced one go first, then items never announced,
+ * then the rest in order of their last announcement. The schedule only holds
+ * items found in the local database, so it is bounded by the database.
+ */
+class CReannounceScheduler
+{
+public:
+    explicit CReannounceScheduler(int64_t nIntervalIn = DHT_REANNOUNCE_INTERVAL);
+
+    /**
+     * Track exactly vTargets, scheduling new ones and dropping the others. New
+     * targets that fnAnnounce rejects are never scheduled, and are remembered
+     * so they aren't checked again.
+     */
+    void Sync(const std::vector<uint160>& vTargets, const std::function<bool(const uint160&)>& fnAnnounce = nullptr);
+    /** An item was stored with nSequence, a new sequence number is announced first */
+    void Update(const uint160& target, int64_t nSequence);
+    void Remove(const uint160& target);
+    /** Take up to nMax items due at nNow, most urgent first, and schedule their next round */
+    std::vector<uint160> PopDue(int64_t nNow, size_t nMax);
+    /** Feedback from a put of target that nNodes stored */
+    void PutResult(const uint160& target, int nNodes, int64_t nNow);
+
+    size_t size() const;
+    size_t DueCount(int64_t nNow) const;
+
+private:
+    struct CItemState {
+        int64_t nSequence;
+        int64_t nAnnouncedSequence;
+        int64_t nNextAnnounce;
+    };
+    // queue positions of items that jump ahead of everything due
+    static const int64_t UPDATED_ITEM = 0;
+    static const int64_t NEW_ITEM = 1;
+
+    void Schedule(const uint160& target, CItemState& state, int64_t nNext);
+
+    mutable CCriticalSection cs;
+    const int64_t nInterval;
+    std::map<uint160, CItemState> mapItems;
+    // targets in the database that fnAnnounce rejected
+    std::set<uint160> setSkipped;
+    // (next announce time, target)
+    std::set<std::pair<int64_t, uint160>> setQueue;
+};
+
+extern CReannounceScheduler reannounceScheduler;
+
+#endif // DYNAMIC_DHT_REANNOUNCE_H
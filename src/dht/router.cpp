@@ -0,0 +1,71 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/router.h"
+
+#include "crypto/common.h"
+#include "hash.h"
+
+#include <algorithm>
+
+void CSessionRouter::Reset(size_t nSessionsIn)
+{
+    std::vector<std::pair<uint64_t, size_t>> vNewRing;
+    vNewRing.reserve(nSessionsIn * DHT_ROUTER_VIRTUAL_NODES);
+    for (size_t i = 0; i < nSessionsIn; i++) {
+        for (unsigned int j = 0; j < DHT_ROUTER_VIRTUAL_NODES; j++) {
+            CHashWriter ss(SER_GETHASH, 0);
+            ss << uint64_t(i) << j;
+            vNewRing.push_back(std::make_pair(ss.GetHash().GetCheapHash(), i));
+        }
+    }
+    std::sort(vNewRing.begin(), vNewRing.end());
+
+    LOCK(cs);
+    nSessions = nSessionsIn;
+    vRing.swap(vNewRing);
+}
+
+int CSessionRouter::Route(const uint160& key, const AvailableFn& fnAvailable, const InFlightFn& fnInFlight) const
+{
+    LOCK(cs);
+    if (vRing.empty())
+        return -1;
+
+    // Info hashes are SHA-1 digests, their first bytes are already uniform
+    const uint64_t nPosition = ReadLE64(key.begin());
+    std::vector<std::pair<uint64_t, size_t>>::const_iterator it = std::lower_bound(vRing.begin(), vRing.end(), std::make_pair(nPosition, size_t(0)));
+    const size_t nStart = it - vRing.begin();
+    int nOwner = -1;
+    int nBest = -1;
+    int nBestInFlight = 0;
+    std::vector<size_t> vSeen;
+    const size_t nCandidates = std::min<size_t>(DHT_ROUTER_CANDIDATES, nSessions);
+    unsigned int nFound = 0;
+    for (size_t i = 0; i < vRing.size() && nFound < nCandidates && vSeen.size() < nSessions; i++) {
+        const size_t nSession = vRing[(nStart + i) % vRing.size()].second;
+        if (std::find(vSeen.begin(), vSeen.end(), nSession) != vSeen.end())
+            continue;
+
+        vSeen.push_back(nSession);
+        if (nOwner < 0)
+            nOwner = nSession;
+        if (!fnAvailable(nSession))
+            continue;
+
+        nFound++;
+        const int nInFlight = fnInFlight(nSession);
+        if (nBest < 0 || nInFlight < nBestInFlight) {
+            nBest = nSession;
+            nBestInFlight = nInFlight;
+        }
+    }
+    return nBest < 0 ? nOwner : nBest;
+}
+
+size_t CSessionRouter::Sessions() const
+{
+    LOCK(cs);
+    return nSessions;
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_DHT_ROUTER_H
+#define DYNAMIC_DHT_ROUTER_H
+
+#include "sync.h"
+#include "uint256.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+/** Points on the hash ring per session */
+static const unsigned int DHT_ROUTER_VIRTUAL_NODES = 64;
+/** Distinct sessions following a key on the ring that may serve it */
+static const unsigned int DHT_ROUTER_CANDIDATES = 2;
+
+/**
+ * Maps DHT requests to session threads by consistent hashing of their info
+ * hash.
+ *
+ * A key is served by the first DHT_ROUTER_CANDIDATES available sessions that
+ * follow it on the ring, taking the one with the fewest requests in flight and
+ * the ring owner on ties. Unavailable sessions are skipped, so their keys fail
+ * over to the next sessions on the ring while all other keys stay put.
+ */
+class CSessionRouter
+{
+public:
+    typedef std::function<bool(size_t)> AvailableFn;
+    typedef std::function<int(size_t)> InFlightFn;
+
+    /** Rebuild the ring for sessions 0 .. nSessions - 1 */
+    void Reset(size_t nSessions);
+    /** Session serving key, -1 if there are no sessions. Falls back to the owner when none is available */
+    int Route(const uint160& key, const AvailableFn& fnAvailable, const InFlightFn& fnInFlight) const;
+    size_t Sessions() const;
+
+private:
+    mutable CCriticalSection cs;
+    size_t nSessions = 0;
+    // (ring position, session) sorted by position
+    std::vector<std::pair<uint64_t, size_t>> vRing;
+};
+
+#endif // DYNAMIC_DHT_ROUTER_H
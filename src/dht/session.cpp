@@ -13,6 +13,8 @@
 #include "dht/dataheader.h"
 #include "dht/mutable.h"
 #include "dht/mutabledb.h"
+#include "dht/reannounce.h"
+#include "dht/router.h"
 #include "dht/settings.h"
 #include "dynode-sync.h"
 #include "net.h"
@@ -33,29 +35,30 @@
 #include <boost/filesystem.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <algorithm>
 #include <cstdio> // for snprintf
 #include <cinttypes> // for PRId64 et.al.
 #include <cstdlib>
+#include <deque>
 #include <functional>
 #include <fstream>
+#include <limits>
 #include <thread>
 
 using namespace libtorrent;
 
 static constexpr size_t nThreads = 8;
-static constexpr int64_t nReannouceSleepMilliSleep = (60 * 1000); // re-announce one item every minute.
 
 bool fMultiThreads;
 
 typedef std::array<std::pair<std::shared_ptr<std::thread>, std::shared_ptr<CHashTableSession>>, nThreads> SessionThreadGroup;
 
 static SessionThreadGroup arraySessions;
+static CSessionRouter sessionRouter;
 
 static std::shared_ptr<std::thread> pDHTTorrentThread;
 static std::shared_ptr<boost::thread> pReannounceThread = nullptr;
 static std::map<HashRecordKey, uint32_t> mPutCommands;
-//             <InfoHash   ,      pair<seq    , epoch>
-static std::map<std::string, std::pair<int64_t, int64_t>> mReannouceInfoHashes;
 static uint64_t nPutRecords = 0;
 static uint64_t nPutPieces = 0;
 static uint64_t nPutBytes = 0;
@@ -68,6 +71,29 @@ static bool fStarted;
 static bool fReannounceStarted = false;
 static bool fRun;
 
+// Session serving requests for key, skipping sessions whose alerts are backed up
+static std::shared_ptr<CHashTableSession> RouteSession(const uint160& key)
+{
+    const int nSession = sessionRouter.Route(key,
+        [](size_t i) { return arraySessions[i].second && !arraySessions[i].second->IsBackedUp(); },
+        [](size_t i) { return arraySessions[i].second ? arraySessions[i].second->nInFlight.load() : 0; });
+    if (nSession < 0)
+        return nullptr;
+
+    return arraySessions[nSession].second;
+}
+
+// Counts a request against its session for the router while it is waited on
+class CRequestInFlight
+{
+private:
+    std::shared_ptr<CHashTableSession> pSession;
+
+public:
+    explicit CRequestInFlight(const std::shared_ptr<CHashTableSession>& pSessionIn) : pSession(pSessionIn) { pSession->nInFlight++; }
+    ~CRequestInFlight() { pSession->nInFlight--; }
+};
+
 namespace DHT {
     typedef std::vector<std::pair<std::string, libtorrent::entry>> PutBytes;
     std::vector<std::pair<int64_t, PutBytes>> vPutBytes;
@@ -90,7 +116,7 @@ namespace DHT {
         bencode(std::back_inserter(bufSign), e);
         dht::signature sign;
         seq = iSeq;
-        LogPrint("dht", "%s --\nSalt = %s\nSequence = %d, e = %s\n", __func__, salt, seq, e.to_string());
+        LogPrint("dht", "%s --\nSalt = %s\nSequence = %d, size = %u\n", __func__, salt, seq, bufSign.size());
         sign = sign_mutable_item(bufSign, salt, dht::sequence_number(seq)
             , dht::public_key(pk.data())
             , dht::secret_key(sk.data()));
@@ -137,7 +163,11 @@ namespace DHT {
 
 void CHashTableSession::StopEventListener()
 {
-    fShutdown = true;
+    {
+        LOCK(cs_DHTGetEventMap);
+        fShutdown = true;
+    }
+    cvDHTGetEvent.notify_all();
     LogPrintf("%s -- stopping DHT session thread %s.\n", __func__, strName);
     MilliSleep(333);
 }
@@ -145,15 +175,17 @@ void CHashTableSession::StopEventListener()
 bool CHashTableSession::ReannounceEntry(const CMutableData& mutableData)
 {
     libtorrent::entry mut_item;
+    if (mutableData.vchPublicKey.size() != ED25519_PUBLIC_KEY_BYTE_LENGTH || mutableData.vchSignature.size() != ED25519_SIGTATURE_BYTE_LENGTH)
+        return false;
+
     if (mutableData.vchSalt.size() > 0 && ConvertMutableEntryValue(mutableData, mut_item)) {
-        libtorrent::sha1_hash infohash(mutableData.InfoHash().c_str());
         std::array<char, ED25519_PUBLIC_KEY_BYTE_LENGTH> pubkey;
-        aux::from_hex(mutableData.PublicKey(), pubkey.data());
+        std::memcpy(pubkey.data(), mutableData.vchPublicKey.data(), pubkey.size());
         std::array<char, ED25519_SIGTATURE_BYTE_LENGTH> signature_bytes;
-        aux::from_hex(mutableData.Signature(), signature_bytes.data());
+        std::memcpy(signature_bytes.data(), mutableData.vchSignature.data(), signature_bytes.size());
         Session->dht_put_item(pubkey, std::bind(&DHT::put_signed_bytes, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, 
              pubkey, signature_bytes, mut_item, mutableData.SequenceNumber), mutableData.Salt());
-        LogPrint("dht", "%s -- Re-annoucing item infohash %s, entry \n%s\n", __func__, infohash.to_string(), mut_item.to_string());
+        LogPrint("dht", "%s -- Re-annoucing item infohash %s, entry \n%s\n", __func__, mutableData.InfoHash(), mut_item.to_string());
         return true;
     }
     return false;
@@ -181,6 +213,8 @@ void StartEventListener(std::shared_ptr<CHashTableSession> dhtSession)
         dhtSession->Session->wait_for_alert(std::chrono::milliseconds(333));
         std::vector<alert*> alerts;
         dhtSession->Session->pop_alerts(&alerts);
+        dhtSession->nLastAlertCount = alerts.size();
+        dhtSession->nLastAlertPoll = GetTimeMillis();
         for (std::vector<alert*>::iterator iAlert = alerts.begin(), end(alerts.end()); iAlert != end; ++iAlert) {
             if ((*iAlert) == nullptr)
                 continue;
@@ -195,16 +229,26 @@ void StartEventListener(std::shared_ptr<CHashTableSession> dhtSession)
                     dht_mutable_item_alert* pGet = alert_cast<dht_mutable_item_alert>((*iAlert));
                     if (pGet == nullptr)
                         continue;
-                    LogPrint("dht", "%s -- PubKey = %s, Salt = %s, Value = %s\nMessage = %s, Alert Type =%s, Alert Category = %u\n"
-                        , __func__, aux::to_hex(pGet->key), pGet->salt, pGet->item.to_string(), strAlertMessage, strAlertTypeName, iAlertCategory);
+                    // Binary values come out hex encoded, do it once per item
+                    const std::string strValue = pGet->item.to_string();
+                    LogPrint("dht", "%s -- PubKey = %s, Salt = %s, Value size = %u\nMessage = %s, Alert Type =%s, Alert Category = %u\n"
+                        , __func__, aux::to_hex(pGet->key), pGet->salt, strValue.size(), strAlertMessage, strAlertTypeName, iAlertCategory);
 
-                    if (pGet->item.to_string() != "<uninitialized>") {
+                    if (strValue != "<uninitialized>") {
                         const CMutableGetEvent event(strAlertMessage, iAlertType, iAlertCategory, strAlertTypeName, 
-                          aux::to_hex(pGet->key), pGet->salt, pGet->seq, pGet->item.to_string(), aux::to_hex(pGet->signature), pGet->authoritative);
+                          aux::to_hex(pGet->key), pGet->salt, pGet->seq, strValue, aux::to_hex(pGet->signature), pGet->authoritative);
 
-                        std::string infoHash = GetInfoHash(event.PublicKey(), event.Salt());
-                        dhtSession->AddToDHTGetEventMap(infoHash, event);
+                        dhtSession->AddToDHTGetEventMap(GetMutableTarget(pGet->key, pGet->salt), event);
                     }
+                } else {
+                    // DHT Put Mutable Event, tells how many nodes stored the item
+                    dht_put_alert* pPut = alert_cast<dht_put_alert>((*iAlert));
+                    if (pPut == nullptr)
+                        continue;
+                    const uint160 infoHash = GetMutableTarget(pPut->public_key, pPut->salt);
+                    if (dhtSession->pReannounceScheduler)
+                        dhtSession->pReannounceScheduler->PutResult(infoHash, pPut->num_success, GetTime());
+                    dhtSession->AddPutResult(infoHash, pPut->num_success);
                 }
             } else if (iAlertType == DHT_STATS_ALERT_TYPE_CODE) {
                 LogPrintf("%s -- DHT Status Alert Message: AlertType = %s\n", __func__, strAlertTypeName);
@@ -216,7 +260,7 @@ void StartEventListener(std::shared_ptr<CHashTableSession> dhtSession)
                 dhtSession->SessionStats = pAlert;
             } else {
                 const CEvent event(strAlertMessage, iAlertType, iAlertCategory, strAlertTypeName);
-                dhtSession->AddToEventMap(iAlertType, event);
+                dhtSession->AddToEventMap(event);
             }
         }
         if (dhtSession->fShutdown)
@@ -225,7 +269,7 @@ void StartEventListener(std::shared_ptr<CHashTableSession> dhtSession)
         counter++;
         if (counter % 60 == 0) {
             LogPrint("dht", "DHTEventListener -- Before CleanUpEventMap. counter = %u\n", counter);
-            dhtSession->CleanUpEventMap(300000);
+            dhtSession->CleanUpEventMap(DHT_EVENT_EXPIRE_MILLIS);
         }
     }
 }
@@ -252,57 +296,47 @@ bool ConvertMutableEntryValue(const CMutableData& local_mut_data, libtorrent::en
 
 void ReannounceEntries()
 {
-    if (InitMemoryMap()) {
-        try {
-            while (fReannounceStarted) {
-                // cleanup mReannouceInfoHashes map, make sure it doesn't get too big.
-                MilliSleep(nReannouceSleepMilliSleep);
-                boost::this_thread::interruption_point();
-                CMutableData randomMutableItem;
-                // select one local item at random.  
-                if (SelectRandomMutableItem(randomMutableItem)) {
-                    // Check if already re-annouced item
-                    int64_t nCurrentTime = GetTime();
-                    std::map<std::string, std::pair<int64_t, int64_t>>::iterator it = mReannouceInfoHashes.find(randomMutableItem.InfoHash());
-                    if (it == mReannouceInfoHashes.end()) {
-                        mReannouceInfoHashes[randomMutableItem.InfoHash()] = std::make_pair(randomMutableItem.SequenceNumber, nCurrentTime);
-                    } else {
-                        // check if we have a higher sequence number
-                        if (randomMutableItem.SequenceNumber > it->second.first) {
-                            mReannouceInfoHashes[randomMutableItem.InfoHash()] = std::make_pair(randomMutableItem.SequenceNumber, nCurrentTime);
-                        // check if we re-annouced over an hour ago
-                        } else if (nCurrentTime - it->second.second > (60 * 60)) {
-                            mReannouceInfoHashes[randomMutableItem.InfoHash()] = std::make_pair(randomMutableItem.SequenceNumber, nCurrentTime);
-                        } else {
-                            // already re-annouced entry within the hour with the same sequence number.  Do not re-annouce entry.
-                            continue;
-                        }
-                    }
-                    // TODO (DHT): Check if fewer than 8 nodes returned the item with the most recent sequence number before re-announcing item
-                    if (randomMutableItem.vchSalt.size() > 0) {
-                        arraySessions[0].second->ReannounceEntry(randomMutableItem);
-                    }
+    if (!InitMemoryMap()) {
+        LogPrintf("%s -- InitMemoryMap failed.\n", __func__);
+        return;
+    }
+    const size_t nAnnounceRate = std::max<int64_t>(1, GetArg("-dhtannouncerate", DEFAULT_DHT_ANNOUNCE_RATE));
+    int64_t nLastSync = 0;
+    try {
+        while (fReannounceStarted) {
+            MilliSleep(1000);
+            boost::this_thread::interruption_point();
+            const int64_t nCurrentTime = GetTime();
+            if (nCurrentTime - nLastSync >= DHT_REANNOUNCE_SYNC_INTERVAL) {
+                std::vector<uint160> vTargets;
+                // Items without a salt can't be put, keep them out of the schedule
+                if (GetAllLocalMutableTargets(vTargets))
+                    reannounceScheduler.Sync(vTargets, [](const uint160& target) {
+                        CMutableData mutableItem;
+                        return GetLocalMutableData(target, mutableItem) && !mutableItem.vchSalt.empty();
+                    });
+                nLastSync = nCurrentTime;
+                LogPrint("dht", "%s -- %d items scheduled, %d due\n", __func__, reannounceScheduler.size(), reannounceScheduler.DueCount(nCurrentTime));
+            }
+            // Spend this second's budget on the most urgent items, routed over all sessions.
+            // Items that reach too few nodes are retried early through the put alerts.
+            for (const uint160& target : reannounceScheduler.PopDue(nCurrentTime, nAnnounceRate)) {
+                CMutableData mutableItem;
+                if (!GetLocalMutableData(target, mutableItem)) {
+                    reannounceScheduler.Remove(target);
+                    continue;
                 }
+
+                std::shared_ptr<CHashTableSession> pSession = RouteSession(target);
+                if (pSession)
+                    pSession->ReannounceEntry(mutableItem);
             }
-        } catch (const boost::thread_interrupted& ex) {
-            LogPrintf("%s -- thread_interrupted\n", __func__);
-        } catch (const std::exception& ex) {
-            LogPrintf("%s -- ex %s\n", __func__, ex.what());
         }
+    } catch (const boost::thread_interrupted& ex) {
+        LogPrintf("%s -- thread_interrupted\n", __func__);
+    } catch (const std::exception& ex) {
+        LogPrintf("%s -- ex %s\n", __func__, ex.what());
     }
-    else {
-        LogPrintf("%s -- InitMemoryMap failed.\n", __func__);
-    }
-    /*
-    1. pick one random item (i) from the local repository (except
-       items already announced this round)
-    2. If all items in the local repository have been announced
-      2.1 terminate
-    3. look up item i in the DHT
-    4. If fewer than 8 nodes returned the item
-      4.1 announce i to the DHT
-      4.2 goto 1
-    */
 }
 
 bool CHashTableSession::Bootstrap()
@@ -410,8 +444,10 @@ void static StartDHTNetwork(const CChainParams& chainparams, CConnman& connman)
                 std::shared_ptr<CHashTableSession> pDHTSession(new CHashTableSession());
                 CDHTSettings settings(i, nThreads, fMultiThreads);
                 pDHTSession->strName = strprintf("dht-%d", std::to_string(i));
-                if (fDynodeMode)
+                if (fDynodeMode) {
                     settings.LoadPeerID(strDynodePeerID);
+                    pDHTSession->pReannounceScheduler = &reannounceScheduler;
+                }
                 settings.LoadSettings();
                 pDHTSession->Session = settings.GetSession();
                 std::shared_ptr<std::thread> pSessionThread = std::make_shared<std::thread>(std::bind(&StartEventListener, std::ref(pDHTSession)));
@@ -425,14 +461,17 @@ void static StartDHTNetwork(const CChainParams& chainparams, CConnman& connman)
             std::shared_ptr<CHashTableSession> pDHTSession(new CHashTableSession());
             CDHTSettings settings(i, nThreads, fMultiThreads);
             pDHTSession->strName = strprintf("dht-%d", std::to_string(i));
-            if (fDynodeMode)
+            if (fDynodeMode) {
                 settings.LoadPeerID(strDynodePeerID);
+                pDHTSession->pReannounceScheduler = &reannounceScheduler;
+            }
             settings.LoadSettings();
             pDHTSession->Session = settings.GetSession();
             std::shared_ptr<std::thread> pSessionThread = std::make_shared<std::thread>(std::bind(&StartEventListener, std::ref(pDHTSession)));
             arraySessions[i] = std::make_pair(pSessionThread, pDHTSession);
             LogPrintf("%s -- Session PeerID %s\n", __func__, pDHTSession->Session->get_settings().get_str(settings_pack::peer_fingerprint));
         }
+        sessionRouter.Reset(nRunningThreads);
         if (fDynodeMode) {
             // Start thread used to balance the hash table by re-announcing entries
             fReannounceStarted = true;
@@ -547,6 +586,34 @@ bool CHashTableSession::SubmitPut(const std::array<char, 32> public_key, const s
     return true;
 }
 
+bool CHashTableSession::SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64> private_key, const int64_t lastSequence, const std::string& strSalt, const libtorrent::entry& entryValue,
+                            const int64_t& timeout, int& nSuccess)
+{
+    const uint160 infoHash = GetMutableTarget(public_key, strSalt);
+    {
+        LOCK(cs_DHTGetEventMap);
+        mapPendingPuts[infoHash] = -1;
+    }
+    SubmitPut(public_key, private_key, lastSequence, strSalt, entryValue);
+
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    WAIT_LOCK(cs_DHTGetEventMap, lock);
+    nSuccess = -1;
+    while (!fShutdown) {
+        DHTPutResultMap::iterator it = mapPendingPuts.find(infoHash);
+        if (it != mapPendingPuts.end() && it->second >= 0) {
+            nSuccess = it->second;
+            break;
+        }
+        if (cvDHTGetEvent.wait_until(lock, deadline) == std::cv_status::timeout)
+            break;
+    }
+    mapPendingPuts.erase(infoHash);
+    if (nSuccess < 0)
+        LogPrint("dht", "CHashTableSession::%s -- timeout, salt = %s\n", __func__, strSalt);
+    return nSuccess >= 0;
+}
+
 bool CHashTableSession::SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt)
 {
     if (!Session) {
@@ -563,35 +630,32 @@ bool CHashTableSession::SubmitGet(const std::array<char, 32>& public_key, const
     return true;
 }
 
+static std::string GetEventValue(const CMutableGetEvent& event)
+{
+    const std::string& strData = event.Value();
+    // TODO (DHT): check the last position for the single quote character
+    if (strData.size() >= 2 && strData[0] == '\'')
+        return std::string(strData, 1, strData.size() - 2);
+
+    return strData;
+}
+
 bool CHashTableSession::SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt, const int64_t& timeout, 
                             std::string& recordValue, int64_t& lastSequence, bool& fAuthoritative)
 {
-    std::string infoHash = GetInfoHash(aux::to_hex(public_key),recordSalt);
+    const uint160 infoHash = GetMutableTarget(public_key, recordSalt);
     RemoveDHTGetEvent(infoHash);
     if (!SubmitGet(public_key, recordSalt))
         return false;
-    MilliSleep(40);
     CMutableGetEvent data;
-    int64_t startTime = GetTimeMillis();
-    while (timeout > GetTimeMillis() - startTime)
-    {
-        if (FindDHTGetEvent(infoHash, data)) {
-            std::string strData = data.Value();
-            // TODO (DHT): check the last position for the single quote character
-            if (strData.substr(0, 1) == "'") {
-                recordValue = strData.substr(1, strData.size() - 2);
-            }
-            else {
-                recordValue = strData;
-            }
-            lastSequence = data.SequenceNumber();
-            fAuthoritative = data.Authoritative();
-            LogPrint("dht", "CHashTableSession::%s -- salt = %s, value = %s, seq = %d, auth = %u\n", __func__, recordSalt, recordValue, lastSequence, fAuthoritative);
-            return true;
-        }
-        MilliSleep(10);
-    }
-    return false;
+    if (!WaitForDHTGetEvent(infoHash, timeout, data))
+        return false;
+
+    recordValue = GetEventValue(data);
+    lastSequence = data.SequenceNumber();
+    fAuthoritative = data.Authoritative();
+    LogPrint("dht", "CHashTableSession::%s -- salt = %s, value = %s, seq = %d, auth = %u\n", __func__, recordSalt, recordValue, lastSequence, fAuthoritative);
+    return true;
 }
 
 static std::vector<unsigned char> Array32ToVector(const std::array<char, 32>& key32)
@@ -609,14 +673,14 @@ bool CHashTableSession::SubmitGetRecord(const std::array<char, 32>& public_key,
     uint16_t nTotalSlots = 32;
     uint16_t nHeaderAttempts = 3;
     std::string strHeaderHex;
-    std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
+    std::string strHeaderSalt = GetChunkSalt(strOperationType, 0);
     CRecordHeader header;
-    if (!SubmitGet(public_key, strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative)) {
+    if (!SubmitGet(public_key, strHeaderSalt, DHT_GET_TIMEOUT_MILLIS, strHeaderHex, iSequence, fAuthoritative)) {
         unsigned int i = 0;
         while (i < nHeaderAttempts) {
             strHeaderHex = "";
             if (header.IsNull()) {
-                if (SubmitGet(public_key, strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative)) {
+                if (SubmitGet(public_key, strHeaderSalt, DHT_GET_TIMEOUT_MILLIS, strHeaderHex, iSequence, fAuthoritative)) {
                     break;
                 }
             }
@@ -630,21 +694,14 @@ bool CHashTableSession::SubmitGetRecord(const std::array<char, 32>& public_key,
         return false; // Header failed, so don't try to get the rest of the record.
 
     header.LoadHex(strHeaderHex);
-    if (!header.IsNull() && header.nChunks > 0) {
-        std::vector<CDataChunk> vChunks;
-        for(unsigned int i = 0; i < header.nChunks; i++) {
-            std::string strChunkSalt = strOperationType + ":" + std::to_string(i+1);
-            std::string strChunk;
-            if (!SubmitGet(public_key, strChunkSalt, 2000, strChunk, iSequence, fAuthoritative)) {
-                strErrorMessage = "Failed to get record chunk.";
-                return false;
-            }
-            CDataChunk chunk(i, i + 1, strChunkSalt, strChunk);
-            vChunks.push_back(chunk);
-        }
-        CDataRecord getRecord(strOperationType, nTotalSlots, header, vChunks, Array32ToVector(private_seed));
-        if (record.HasError()) {
-            strErrorMessage = strprintf("Record has errors: %s\n", __func__, getRecord.ErrorMessage());
+    if (!header.IsNull() && header.nChunks > 0 && nTotalSlots >= header.nChunks) {
+        std::vector<std::string> vChunkValues;
+        if (!SubmitGetChunks(public_key, strOperationType, header, iSequence, vChunkValues))
+            return false;
+
+        CDataRecord getRecord(strOperationType, nTotalSlots, header, vChunkValues, Array32ToVector(private_seed));
+        if (getRecord.HasError()) {
+            strErrorMessage = strprintf("Record has errors: %s\n", getRecord.ErrorMessage());
             nGetErrors++;
             return false;
         }
@@ -656,14 +713,98 @@ bool CHashTableSession::SubmitGetRecord(const std::array<char, 32>& public_key,
     return false;
 }
 
-bool CHashTableSession::GetDataFromMap(const std::array<char, 32>& public_key, const std::string& recordSalt, CMutableGetEvent& event)
+bool CHashTableSession::SubmitGetChunks(const std::array<char, 32>& public_key, const std::string& strOperationType, const CRecordHeader& header, const int64_t iSequence, std::vector<std::string>& vChunkValues)
 {
-    std::string infoHash = GetInfoHash(aux::to_hex(public_key), recordSalt);
-    if (FindDHTGetEvent(infoHash, event)) {
-        LogPrint("dht", "CHashTableSession::%s -- pubkey = %s, salt = %s, value = %s, seq = %d, auth = %u\n", __func__, event.PublicKey(), event.Salt(), event.Value(), event.SequenceNumber(), event.Authoritative());
-        return true;
+    std::vector<std::string> vSalts(header.nChunks);
+    std::vector<uint160> vInfoHashes(header.nChunks);
+    std::vector<std::string> vValues(header.nChunks);
+    std::vector<unsigned int> vAttempts(header.nChunks, 0);
+    for (unsigned int i = 0; i < header.nChunks; i++) {
+        vSalts[i] = GetChunkSalt(strOperationType, i + 1);
+        vInfoHashes[i] = GetMutableTarget(public_key, vSalts[i]);
+        RemoveDHTGetEvent(vInfoHashes[i]);
     }
-    return false;
+
+    // chunk index -> deadline in milliseconds
+    std::map<unsigned int, int64_t> mapInFlight;
+    std::deque<unsigned int> queueRetry;
+    unsigned int nNext = 0;
+    unsigned int nDone = 0;
+    while (nDone < header.nChunks) {
+        // Keep the pipeline full, retries first
+        while (mapInFlight.size() < DHT_MAX_CHUNK_GETS_IN_FLIGHT && (!queueRetry.empty() || nNext < header.nChunks)) {
+            unsigned int i;
+            if (!queueRetry.empty()) {
+                i = queueRetry.front();
+                queueRetry.pop_front();
+            }
+            else {
+                i = nNext++;
+            }
+            if (!SubmitGet(public_key, vSalts[i]))
+                return false;
+            vAttempts[i]++;
+            mapInFlight[i] = GetTimeMillis() + DHT_GET_TIMEOUT_MILLIS;
+        }
+
+        {
+            WAIT_LOCK(cs_DHTGetEventMap, lock);
+            if (fShutdown)
+                return false;
+
+            bool fProgress = false;
+            int64_t nDeadline = std::numeric_limits<int64_t>::max();
+            for (std::map<unsigned int, int64_t>::iterator it = mapInFlight.begin(); it != mapInFlight.end(); ) {
+                const unsigned int i = it->first;
+                DHTGetEventMap::iterator iMutableEvent = m_DHTGetEventMap.find(vInfoHashes[i]);
+                if (iMutableEvent != m_DHTGetEventMap.end()) {
+                    const CMutableGetEvent& event = iMutableEvent->second;
+                    if (event.SequenceNumber() == iSequence) {
+                        vValues[i] = GetEventValue(event);
+                        nDone++;
+                        fProgress = true;
+                        it = mapInFlight.erase(it);
+                        continue;
+                    }
+                    // Chunk of another version of the record, wait for a newer
+                    // result unless the nodes already agreed on this one
+                    LogPrint("dht", "CHashTableSession::%s -- salt = %s, seq = %d, header seq = %d\n", __func__, vSalts[i], event.SequenceNumber(), iSequence);
+                    if (event.Authoritative())
+                        it->second = 0;
+                    m_DHTGetEventMap.erase(iMutableEvent);
+                }
+                nDeadline = std::min(nDeadline, it->second);
+                ++it;
+            }
+            if (!fProgress && !mapInFlight.empty() && nDeadline > GetTimeMillis()) {
+                std::vector<std::multiset<uint160>::iterator> vPending;
+                for (const std::pair<const unsigned int, int64_t>& inFlight : mapInFlight)
+                    vPending.push_back(setPendingGets.insert(vInfoHashes[inFlight.first]));
+                cvDHTGetEvent.wait_for(lock, std::chrono::milliseconds(nDeadline - GetTimeMillis()));
+                for (const std::multiset<uint160>::iterator& itPending : vPending)
+                    setPendingGets.erase(itPending);
+            }
+        }
+
+        // Expired gets go back to the queue until they run out of attempts
+        const int64_t nNow = GetTimeMillis();
+        for (std::map<unsigned int, int64_t>::iterator it = mapInFlight.begin(); it != mapInFlight.end(); ) {
+            if (it->second > nNow) {
+                ++it;
+                continue;
+            }
+            if (vAttempts[it->first] >= DHT_GET_CHUNK_ATTEMPTS) {
+                strErrorMessage = "Failed to get record chunk.";
+                LogPrint("dht", "CHashTableSession::%s -- failed, salt = %s, attempts = %u\n", __func__, vSalts[it->first], vAttempts[it->first]);
+                return false;
+            }
+            queueRetry.push_back(it->first);
+            it = mapInFlight.erase(it);
+        }
+    }
+
+    vChunkValues.swap(vValues);
+    return true;
 }
 
 bool CHashTableSession::SubmitGetAllRecordsSync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords)
@@ -691,178 +832,226 @@ static std::array<char, 32> EncodedVectorCharToArray32(const std::vector<unsigne
     return array32;
 }
 
+/** Progress of one record fetched by SubmitGetAllRecordsAsync */
+struct CRecordGetState {
+    CLinkInfo linkInfo;
+    std::array<char, 32> arrPubKey;
+    uint160 headerInfoHash;
+    CRecordHeader header;
+    int64_t iSequence = 0;
+    bool fHeader = false;
+    bool fFailed = false;
+    unsigned int nHeaderAttempts = 0;
+    int64_t nHeaderDeadline = 0;
+    std::vector<std::string> vSalts;
+    std::vector<uint160> vInfoHashes;
+    std::vector<std::string> vValues;
+    std::vector<bool> vReceived;
+    std::vector<unsigned int> vAttempts;
+    std::vector<int64_t> vDeadlines;
+    unsigned int nReceived = 0;
+
+    bool IsComplete() const { return fHeader && nReceived == header.nChunks; }
+};
+
 bool CHashTableSession::SubmitGetAllRecordsAsync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords)
 {
     uint16_t nTotalSlots = 32;
     strErrorMessage = "";
-    // Get the headers first
-    for (const CLinkInfo& linkInfo : vchLinkInfo) {
-        std::string strHeaderHex;
-        std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
-        SubmitGet(EncodedVectorCharToArray32(linkInfo.vchSenderPubKey), strHeaderSalt);
-        MilliSleep(10);
-    }
-
-    MilliSleep(300); // Wait for headers data
-    std::vector<std::pair<CLinkInfo, CMutableGetEvent>> eventHeaders;
-    for (const CLinkInfo& linkInfo : vchLinkInfo) {
-        std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
-        const std::array<char, 32>& public_key = EncodedVectorCharToArray32(linkInfo.vchSenderPubKey);
-        CMutableGetEvent mutableGetData;
-        if (GetDataFromMap(public_key, strHeaderSalt, mutableGetData))
-        {
-            eventHeaders.push_back(std::make_pair(linkInfo, mutableGetData));
-        }
-    }
-    for (const std::pair<CLinkInfo, CMutableGetEvent>& eventHeader: eventHeaders)
-    {
-        std::string strHeaderHex = eventHeader.second.Value();
-        if (strHeaderHex.substr(0, 1) == "'") {
-            strHeaderHex = strHeaderHex.substr(1, strHeaderHex.size() - 2);
-        }
-        CRecordHeader header(strHeaderHex);
-        if (!header.IsNull() && nTotalSlots >= header.nChunks) {
-            std::vector<CDataChunk> vChunks;
-            for(unsigned int i = 0; i < header.nChunks; i++) {
-                std::string strChunkSalt = strOperationType + ":" + std::to_string(i+1);
-                std::array <char, 32> arrPubKey;
-                aux::from_hex(eventHeader.second.PublicKey(), arrPubKey.data());
-                SubmitGet(arrPubKey, strChunkSalt);
-                MilliSleep(20);
-            }
+    const std::string strHeaderSalt = GetChunkSalt(strOperationType, 0);
+    std::vector<CRecordGetState> vGets(vchLinkInfo.size());
+    for (unsigned int n = 0; n < vchLinkInfo.size(); n++) {
+        CRecordGetState& get = vGets[n];
+        get.linkInfo = vchLinkInfo[n];
+        get.arrPubKey = EncodedVectorCharToArray32(get.linkInfo.vchSenderPubKey);
+        get.headerInfoHash = GetMutableTarget(get.arrPubKey, strHeaderSalt);
+        RemoveDHTGetEvent(get.headerInfoHash);
+        if (!SubmitGet(get.arrPubKey, strHeaderSalt)) {
+            get.fFailed = true;
+            continue;
         }
+        get.nHeaderAttempts = 1;
+        get.nHeaderDeadline = GetTimeMillis() + DHT_GET_TIMEOUT_MILLIS;
     }
-    if (eventHeaders.size() > 0) {
-        MilliSleep(350); // Wait for records data
-        for (const std::pair<CLinkInfo, CMutableGetEvent>& eventHeader: eventHeaders)
-        {
-            std::string strHeaderHex = eventHeader.second.Value();
-            if (strHeaderHex.substr(0, 1) == "'") {
-                strHeaderHex = strHeaderHex.substr(1, strHeaderHex.size() - 2);
-            }
-            CRecordHeader header(strHeaderHex);
-            if (!header.IsNull() && nTotalSlots >= header.nChunks) {
-                bool fSkip = false;
-                std::vector<CDataChunk> vChunks;
-                for(unsigned int i = 0; i < header.nChunks; i++) {
-                    std::string strChunkSalt = strOperationType + ":" + std::to_string(i+1);
-                    std::array <char, 32> arrPubKey;
-                    aux::from_hex(eventHeader.second.PublicKey(), arrPubKey.data());
-                    CMutableGetEvent eventData;
-                    if (GetDataFromMap(arrPubKey, strChunkSalt, eventData)) {
-                        std::string strHexValue = eventData.Value();
-                        if (strHexValue.substr(0, 1) == "'") {
-                            strHexValue = strHexValue.substr(1, strHexValue.size() - 2);
-                        }
-                        CDataChunk chunk(i, i + 1, strChunkSalt, strHexValue);
-                        vChunks.push_back(chunk);
-                    }
-                    else {
-                        bool fAuthoritative;
-                        int64_t iSequence;
-                        std::string strHeaderHex;
-                        if (SubmitGet(arrPubKey, strChunkSalt, 2000, strHeaderHex, iSequence, fAuthoritative)) {
-                            CDataChunk chunk(i, i + 1, strChunkSalt, strHeaderHex);
-                            vChunks.push_back(chunk);
-                        }
-                        else {
-                            LogPrintf("%s -- Skipped %s record for %s, chunk salt = %s\n", __func__, strOperationType, stringFromVch(eventHeader.first.vchFullObjectPath), strChunkSalt);
-                            fSkip = true;
-                            i = header.nChunks + 1; 
+
+    // Each header that arrives schedules the gets of its chunks right away and
+    // gets without a result are re-issued like in SubmitGetChunks. Stop once
+    // every record is complete or failed, or at the deadline.
+    const int64_t nDeadline = GetTimeMillis() + DHT_GET_ALL_RECORDS_TIMEOUT_MILLIS;
+    std::vector<std::pair<std::array<char, 32>, std::string>> vSubmit;
+    while (true) {
+        for (const std::pair<std::array<char, 32>, std::string>& submit : vSubmit)
+            SubmitGet(submit.first, submit.second);
+        vSubmit.clear();
+
+        WAIT_LOCK(cs_DHTGetEventMap, lock);
+        const int64_t nNow = GetTimeMillis();
+        int64_t nWake = nDeadline;
+        bool fProgress = false;
+        std::vector<uint160> vWaiting;
+        for (CRecordGetState& get : vGets) {
+            if (get.fFailed || get.IsComplete())
+                continue;
+
+            if (!get.fHeader) {
+                DHTGetEventMap::iterator iMutableEvent = m_DHTGetEventMap.find(get.headerInfoHash);
+                if (iMutableEvent == m_DHTGetEventMap.end()) {
+                    if (get.nHeaderDeadline <= nNow) {
+                        if (get.nHeaderAttempts >= DHT_GET_CHUNK_ATTEMPTS) {
+                            LogPrint("dht", "CHashTableSession::%s -- no header, salt = %s, attempts = %u\n", __func__, strHeaderSalt, get.nHeaderAttempts);
+                            get.fFailed = true;
+                            continue;
                         }
+                        get.nHeaderAttempts++;
+                        get.nHeaderDeadline = nNow + DHT_GET_TIMEOUT_MILLIS;
+                        vSubmit.push_back(std::make_pair(get.arrPubKey, strHeaderSalt));
                     }
+                    nWake = std::min(nWake, get.nHeaderDeadline);
+                    vWaiting.push_back(get.headerInfoHash);
+                    continue;
+                }
+                fProgress = true;
+                get.header.LoadHex(GetEventValue(iMutableEvent->second));
+                get.iSequence = iMutableEvent->second.SequenceNumber();
+                if (get.header.IsNull() || get.header.nChunks == 0 || nTotalSlots < get.header.nChunks) {
+                    get.fFailed = true;
+                    continue;
                 }
-                if (!fSkip) {
-                    // TODO: make sure all chunks and header have the same sequence number.
-                    CDataRecord record(strOperationType, nTotalSlots, header, vChunks, Array32ToVector(eventHeader.first.arrReceivePrivateSeed));
-                    if (record.HasError()) {
-                        strErrorMessage = strErrorMessage + strprintf("\nRecord has errors: %s\n", __func__, record.ErrorMessage());
+                get.fHeader = true;
+                get.vValues.resize(get.header.nChunks);
+                get.vReceived.resize(get.header.nChunks, false);
+                get.vAttempts.resize(get.header.nChunks, 1);
+                get.vDeadlines.resize(get.header.nChunks, nNow + DHT_GET_TIMEOUT_MILLIS);
+                for (unsigned int i = 0; i < get.header.nChunks; i++) {
+                    const std::string strChunkSalt = GetChunkSalt(strOperationType, i + 1);
+                    get.vSalts.push_back(strChunkSalt);
+                    get.vInfoHashes.push_back(GetMutableTarget(get.arrPubKey, strChunkSalt));
+                    m_DHTGetEventMap.erase(get.vInfoHashes.back());
+                    vSubmit.push_back(std::make_pair(get.arrPubKey, strChunkSalt));
+                }
+                continue;
+            }
+
+            for (unsigned int i = 0; i < get.header.nChunks; i++) {
+                if (get.vReceived[i])
+                    continue;
+                DHTGetEventMap::iterator iMutableEvent = m_DHTGetEventMap.find(get.vInfoHashes[i]);
+                if (iMutableEvent != m_DHTGetEventMap.end()) {
+                    if (iMutableEvent->second.SequenceNumber() == get.iSequence) {
+                        get.vValues[i] = GetEventValue(iMutableEvent->second);
+                        get.vReceived[i] = true;
+                        get.nReceived++;
+                        fProgress = true;
+                        continue;
                     }
-                    else {
-                        LogPrintf("%s -- Found %s record for %s\n", __func__, strOperationType, stringFromVch(eventHeader.first.vchFullObjectPath));
-                        record.vchOwnerFQDN = eventHeader.first.vchFullObjectPath;
-                        vchRecords.push_back(record);
+                    // Chunk of another version of the record, wait for a newer result
+                    LogPrint("dht", "CHashTableSession::%s -- salt = %s, seq = %d, header seq = %d\n", __func__, get.vSalts[i], iMutableEvent->second.SequenceNumber(), get.iSequence);
+                    m_DHTGetEventMap.erase(iMutableEvent);
+                }
+                if (get.vDeadlines[i] <= nNow) {
+                    if (get.vAttempts[i] >= DHT_GET_CHUNK_ATTEMPTS) {
+                        LogPrint("dht", "CHashTableSession::%s -- no chunk, salt = %s, attempts = %u\n", __func__, get.vSalts[i], get.vAttempts[i]);
+                        get.fFailed = true;
+                        break;
                     }
+                    get.vAttempts[i]++;
+                    get.vDeadlines[i] = nNow + DHT_GET_TIMEOUT_MILLIS;
+                    vSubmit.push_back(std::make_pair(get.arrPubKey, get.vSalts[i]));
                 }
+                nWake = std::min(nWake, get.vDeadlines[i]);
+                vWaiting.push_back(get.vInfoHashes[i]);
             }
         }
+
+        if (!vSubmit.empty() || fProgress)
+            continue;
+        if (vWaiting.empty() || fShutdown || nNow >= nDeadline)
+            break;
+
+        std::vector<std::multiset<uint160>::iterator> vPending;
+        for (const uint160& infoHash : vWaiting)
+            vPending.push_back(setPendingGets.insert(infoHash));
+        cvDHTGetEvent.wait_for(lock, std::chrono::milliseconds(std::max<int64_t>(nWake - GetTimeMillis(), 0)));
+        for (const std::multiset<uint160>::iterator& itPending : vPending)
+            setPendingGets.erase(itPending);
+    }
+
+    for (const CRecordGetState& get : vGets) {
+        if (!get.IsComplete()) {
+            if (get.fHeader) {
+                LogPrintf("%s -- Missing %s record for %s, got %u of %u chunks\n", __func__, strOperationType, stringFromVch(get.linkInfo.vchFullObjectPath), get.nReceived, get.header.nChunks);
+            }
+            else {
+                LogPrintf("%s -- Missing %s record for %s, no header after %u attempts\n", __func__, strOperationType, stringFromVch(get.linkInfo.vchFullObjectPath), get.nHeaderAttempts);
+            }
+            continue;
+        }
+        CDataRecord record(strOperationType, nTotalSlots, get.header, get.vValues, Array32ToVector(get.linkInfo.arrReceivePrivateSeed));
+        if (record.HasError()) {
+            strErrorMessage = strErrorMessage + strprintf("\nRecord has errors: %s\n", record.ErrorMessage());
+        }
+        else {
+            LogPrintf("%s -- Found %s record for %s\n", __func__, strOperationType, stringFromVch(get.linkInfo.vchFullObjectPath));
+            record.vchOwnerFQDN = get.linkInfo.vchFullObjectPath;
+            vchRecords.push_back(record);
+        }
     }
     return true;
 }
 
-void CHashTableSession::AddToDHTGetEventMap(const std::string& infoHash, const CMutableGetEvent& event)
+void CHashTableSession::AddToDHTGetEventMap(const uint160& infoHash, const CMutableGetEvent& event)
 {
-    LOCK(cs_DHTGetEventMap);
-    if (m_DHTGetEventMap.find(infoHash) == m_DHTGetEventMap.end()) {
-        // event not found. Add a new entry to DHT event map
-        LogPrint("dht", "AddToDHTGetEventMap Not found -- infohash = %s\n", infoHash);
-        m_DHTGetEventMap.insert(std::make_pair(infoHash, event));
-    }
-    else {
-        // event found. Update entry in DHT event map
-        LogPrint("dht", "AddToDHTGetEventMap Found -- Updateinfohash = %s\n", infoHash);
+    bool fWaiting;
+    {
+        LOCK(cs_DHTGetEventMap);
+        LogPrint("dht", "AddToDHTGetEventMap -- infohash = %s\n", HexStr(infoHash.begin(), infoHash.end()));
         m_DHTGetEventMap[infoHash] = event;
+        fWaiting = setPendingGets.count(infoHash) > 0;
     }
+    if (fWaiting)
+        cvDHTGetEvent.notify_all();
 }
 
-void CHashTableSession::AddToEventMap(const int type, const CEvent& event)
+void CHashTableSession::AddPutResult(const uint160& infoHash, const int nSuccess)
 {
-    LOCK(cs_EventMap);
-    m_EventTypeMap.insert(std::make_pair(type, std::make_pair(event.Timestamp(), event)));
+    {
+        LOCK(cs_DHTGetEventMap);
+        DHTPutResultMap::iterator it = mapPendingPuts.find(infoHash);
+        if (it == mapPendingPuts.end())
+            return;
+        it->second = nSuccess;
+    }
+    cvDHTGetEvent.notify_all();
 }
 
-void CHashTableSession::CleanUpEventMap(const uint32_t timeout)
+void CHashTableSession::AddToEventMap(const CEvent& event)
 {
-    unsigned int deleted = 0;
-    unsigned int counter = 0;
-    int64_t iTime = GetTimeMillis();
-    LOCK(cs_EventMap);
-    for (auto it = m_EventTypeMap.begin(); it != m_EventTypeMap.end(); ) {
-        CEvent event = it->second.second;
-        if ((iTime - event.Timestamp()) > timeout) {
-            it = m_EventTypeMap.erase(it);
-            deleted++;
-        }
-        else {
-            ++it;
-        }
-        counter++;
-    }
-    LogPrint("dht", "DHTEventListener -- CleanUpEventMap. deleted = %u, count = %u\n", deleted, counter);
+    eventBuffer.Push(event);
+}
+
+void CHashTableSession::CleanUpEventMap(const int64_t timeout)
+{
+    const size_t deleted = eventBuffer.Expire(GetTimeMillis() - timeout);
+    LogPrint("dht", "DHTEventListener -- CleanUpEventMap. deleted = %u, count = %u\n", deleted, eventBuffer.size());
 }
 
 bool CHashTableSession::GetLastTypeEvent(const int& type, const int64_t& startTime, std::vector<CEvent>& events)
 {
-    //LOCK(cs_EventMap);
-    LogPrint("dht", "GetLastTypeEvent -- m_EventTypeMap.size = %u, type = %u.\n", m_EventTypeMap.size(), type);
-    std::multimap<int, EventPair>::iterator iEvents = m_EventTypeMap.find(type);
-    while (iEvents != m_EventTypeMap.end()) {
-        if (iEvents->second.first >= startTime) {
-            events.push_back(iEvents->second.second);
-        }
-        iEvents++;
-    }
-    LogPrint("dht", "GetLastTypeEvent -- events.size() = %u\n", events.size());
+    eventBuffer.GetEvents(type, startTime, events);
+    LogPrint("dht", "GetLastTypeEvent -- type = %u, events.size() = %u\n", type, events.size());
     return events.size() > 0;
 }
 
 void CHashTableSession::GetEvents(const int64_t& startTime, std::vector<CEvent>& events)
 {
-    LOCK(cs_EventMap);
-    std::multimap<int, EventPair>::iterator iEvents = m_EventTypeMap.begin();
-    while (iEvents != m_EventTypeMap.end()) {
-        if (iEvents->second.first >= startTime) {
-            events.push_back(iEvents->second.second);
-        }
-        iEvents++;
-    }
+    eventBuffer.GetEvents(startTime, events);
     LogPrintf("%s -- events.size() = %u\n", __func__, events.size());
 }
 
-bool CHashTableSession::FindDHTGetEvent(const std::string& infoHash, CMutableGetEvent& event)
+bool CHashTableSession::FindDHTGetEvent(const uint160& infoHash, CMutableGetEvent& event)
 {
-    //LOCK(cs_DHTGetEventMap);
-    std::map<std::string, CMutableGetEvent>::iterator iMutableEvent = m_DHTGetEventMap.find(infoHash);
+    LOCK(cs_DHTGetEventMap);
+    DHTGetEventMap::iterator iMutableEvent = m_DHTGetEventMap.find(infoHash);
     if (iMutableEvent != m_DHTGetEventMap.end()) {
         // event found.
         event = iMutableEvent->second;
@@ -871,7 +1060,29 @@ bool CHashTableSession::FindDHTGetEvent(const std::string& infoHash, CMutableGet
     return false;
 }
 
-bool CHashTableSession::RemoveDHTGetEvent(const std::string& infoHash)
+bool CHashTableSession::WaitForDHTGetEvent(const uint160& infoHash, const int64_t& timeout, CMutableGetEvent& event)
+{
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    WAIT_LOCK(cs_DHTGetEventMap, lock);
+    std::multiset<uint160>::iterator itPending = setPendingGets.insert(infoHash);
+    bool fFound = false;
+    while (!fShutdown) {
+        DHTGetEventMap::iterator iMutableEvent = m_DHTGetEventMap.find(infoHash);
+        if (iMutableEvent != m_DHTGetEventMap.end()) {
+            event = iMutableEvent->second;
+            fFound = true;
+            break;
+        }
+        if (cvDHTGetEvent.wait_until(lock, deadline) == std::cv_status::timeout)
+            break;
+    }
+    setPendingGets.erase(itPending);
+    if (!fFound)
+        LogPrint("dht", "CHashTableSession::%s -- timeout, infohash = %s\n", __func__, HexStr(infoHash.begin(), infoHash.end()));
+    return fFound;
+}
+
+bool CHashTableSession::RemoveDHTGetEvent(const uint160& infoHash)
 {
     LOCK(cs_DHTGetEventMap);
     m_DHTGetEventMap.erase(infoHash);
@@ -880,13 +1091,19 @@ bool CHashTableSession::RemoveDHTGetEvent(const std::string& infoHash)
 
 bool CHashTableSession::GetAllDHTGetEvents(std::vector<CMutableGetEvent>& vchGetEvents)
 {
-    //LOCK(cs_DHTGetEventMap);
-    for (std::map<std::string, CMutableGetEvent>::iterator it=m_DHTGetEventMap.begin(); it!=m_DHTGetEventMap.end(); ++it) {
-        vchGetEvents.push_back(it->second);
+    LOCK(cs_DHTGetEventMap);
+    for (const std::pair<const uint160, CMutableGetEvent>& getEvent : m_DHTGetEventMap) {
+        vchGetEvents.push_back(getEvent.second);
     }
     return true;
 }
 
+bool CHashTableSession::IsBackedUp() const
+{
+    const int64_t nLastPoll = nLastAlertPoll;
+    return nLastPoll == 0 || GetTimeMillis() - nLastPoll > DHT_ALERT_STALL_MILLIS || nLastAlertCount >= DHT_ALERT_BACKLOG;
+}
+
 namespace DHT
 {
 
@@ -902,7 +1119,7 @@ bool SessionStatus()
 
 bool SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64> private_key, const int64_t lastSequence, const CDataRecord& record, std::string& strErrorMessage)
 {
-    if (record.GetChunks().size() > nThreads - 1) {
+    if (record.GetChunkSpans().size() > nThreads - 1) {
         strErrorMessage = strprintf("Data is too large to put with %d DHT sessions", nThreads);
         return false;
     }
@@ -917,26 +1134,24 @@ bool SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64>
 
     mPutCommands[recordKey] = nCurrentTime;
     const std::string strHeaderSalt = record.GetHeader().Salt;
-    libtorrent::entry entryHeaderHex(record.HeaderHex);
     DHT::PutBytes newPut;
-    newPut.push_back(std::make_pair(strHeaderSalt, entryHeaderHex));
-    for (const CDataChunk& chunk : record.GetChunks()) {
-        libtorrent::entry entryChunkRaw(stringFromVch(chunk.vchValue));
-        newPut.push_back(std::make_pair(chunk.Salt, entryChunkRaw));
-        LogPrintf("%s -- chunk salt: %s, value: %s\n", __func__, chunk.Salt, entryChunkRaw.to_string());
+    newPut.reserve(record.GetChunkSpans().size() + 1);
+    newPut.push_back(std::make_pair(strHeaderSalt, libtorrent::entry(record.HeaderHex)));
+    for (const CDataChunkSpan& span : record.GetChunkSpans()) {
+        // the chunk bytes go straight into the string of the entry
+        newPut.push_back(std::make_pair(span.Salt, libtorrent::entry(libtorrent::entry::string_t)));
+        record.WriteChunk(span, newPut.back().second.string());
     }
-    DHT::vPutBytes.push_back(std::make_pair(nCurrentTime, newPut));
-    size_t nCounter = 0;
     for (const std::pair<std::string, libtorrent::entry>& pair : newPut) {
-        if (!arraySessions[nCounter].second) {
-            strErrorMessage = strprintf("Session %d null.", nCounter);
+        std::shared_ptr<CHashTableSession> pSession = RouteSession(GetMutableTarget(public_key, pair.first));
+        if (!pSession) {
+            strErrorMessage = "DHT session null.";
             return false;
         }
-        arraySessions[nCounter].second->SubmitPut(public_key, private_key, lastSequence, pair.first, pair.second);
-        LogPrintf("%s -- thread: %d, salt: %s, value: %s\n", __func__, nCounter, pair.first, pair.second.to_string());
-        if (fMultiThreads)
-            nCounter++;
+        pSession->SubmitPut(public_key, private_key, lastSequence, pair.first, pair.second);
+        LogPrint("dht", "%s -- session: %s, salt: %s, size: %u\n", __func__, pSession->strName, pair.first, pair.second.string().size());
     }
+    DHT::vPutBytes.push_back(std::make_pair(nCurrentTime, std::move(newPut)));
     nPutRecords++;
     nPutPieces += record.GetHeader().nChunks + 1;
     nPutBytes += record.GetHeader().nDataSize + record.GetHeader().HexValue().size();
@@ -950,73 +1165,82 @@ bool SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64>
     return true;
 }
 
-bool SubmitGet(const size_t nSessionThread, const std::array<char, 32>& public_key, const std::string& recordSalt)
+bool SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt)
 {
-    if (nSessionThread >= nThreads)
-        return false;
-
-    if (!arraySessions[nSessionThread].second)
+    std::shared_ptr<CHashTableSession> pSession = RouteSession(GetMutableTarget(public_key, recordSalt));
+    if (!pSession)
         return false;
 
-    return arraySessions[nSessionThread].second->SubmitGet(public_key, recordSalt);
+    return pSession->SubmitGet(public_key, recordSalt);
 }
 
-bool SubmitGet(const size_t nSessionThread, const std::array<char, 32>& public_key, const std::string& recordSalt, const int64_t& timeout, 
+bool SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt, const int64_t& timeout, 
                             std::string& recordValue, int64_t& lastSequence, bool& fAuthoritative)
 {
-    if (nSessionThread >= nThreads)
+    std::shared_ptr<CHashTableSession> pSession = RouteSession(GetMutableTarget(public_key, recordSalt));
+    if (!pSession)
         return false;
 
-    if (!arraySessions[nSessionThread].second)
-        return false;
-
-    return arraySessions[nSessionThread].second->SubmitGet(public_key, recordSalt, timeout, recordValue, lastSequence, fAuthoritative);
+    CRequestInFlight request(pSession);
+    return pSession->SubmitGet(public_key, recordSalt, timeout, recordValue, lastSequence, fAuthoritative);
 }
 
-bool SubmitGetRecord(const size_t nSessionThread, const std::array<char, 32>& public_key, const std::array<char, 32>& private_seed, 
+bool SubmitGetRecord(const std::array<char, 32>& public_key, const std::array<char, 32>& private_seed, 
                         const std::string& strOperationType, int64_t& iSequence, CDataRecord& record)
 {
-    if (nSessionThread >= nThreads)
-        return false;
-
-    if (!arraySessions[nSessionThread].second)
+    // All pieces of a record are fetched through the session of its operation
+    std::shared_ptr<CHashTableSession> pSession = RouteSession(GetMutableTarget(public_key, strOperationType));
+    if (!pSession)
         return false;
 
     nGetRecords++;
-    return arraySessions[nSessionThread].second->SubmitGetRecord(public_key, private_seed, strOperationType, iSequence, record);
+    CRequestInFlight request(pSession);
+    return pSession->SubmitGetRecord(public_key, private_seed, strOperationType, iSequence, record);
 }
 
-bool SubmitGetAllRecordsSync(const size_t nSessionThread, const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords)
+// Requests for many records are routed on the operation and the link paths
+static uint160 GetLinksRouteKey(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType)
 {
-    if (nSessionThread >= nThreads)
-        return false;
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << strOperationType;
+    for (const CLinkInfo& linkInfo : vchLinkInfo)
+        ss << linkInfo.vchFullObjectPath;
+    const uint256 hash = ss.GetHash();
+    uint160 key;
+    std::memcpy(key.begin(), hash.begin(), key.size());
+    return key;
+}
 
-    if (!arraySessions[nSessionThread].second)
+bool SubmitGetAllRecordsSync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords)
+{
+    std::shared_ptr<CHashTableSession> pSession = RouteSession(GetLinksRouteKey(vchLinkInfo, strOperationType));
+    if (!pSession)
         return false;
 
-    return arraySessions[nSessionThread].second->SubmitGetAllRecordsSync(vchLinkInfo, strOperationType, vchRecords);
+    CRequestInFlight request(pSession);
+    return pSession->SubmitGetAllRecordsSync(vchLinkInfo, strOperationType, vchRecords);
 }
 
-bool SubmitGetAllRecordsAsync(const size_t nSessionThread, const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords)
+bool SubmitGetAllRecordsAsync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords)
 {
-    if (nSessionThread >= nThreads)
+    std::shared_ptr<CHashTableSession> pSession = RouteSession(GetLinksRouteKey(vchLinkInfo, strOperationType));
+    if (!pSession)
         return false;
 
-    if (!arraySessions[nSessionThread].second)
-        return false;
-
-    return arraySessions[nSessionThread].second->SubmitGetAllRecordsAsync(vchLinkInfo, strOperationType, vchRecords);
+    CRequestInFlight request(pSession);
+    return pSession->SubmitGetAllRecordsAsync(vchLinkInfo, strOperationType, vchRecords);
 }
 
-bool GetAllDHTGetEvents(const size_t nSessionThread, std::vector<CMutableGetEvent>& vchGetEvents)
+bool GetAllDHTGetEvents(std::vector<CMutableGetEvent>& vchGetEvents)
 {
-    if (nSessionThread >= nThreads)
-        return false;
-
-    if (!arraySessions[nSessionThread].second)
+    if (!SessionStatus())
         return false;
 
-    return arraySessions[nSessionThread].second->GetAllDHTGetEvents(vchGetEvents);
+    const size_t nRunningThreads = fMultiThreads ? nThreads : 1;
+    for (size_t i = 0; i < nRunningThreads; i++) {
+        arraySessions[i].second->GetAllDHTGetEvents(vchGetEvents);
+    }
+    return true;
 }
 
 void GetDHTStats(CSessionStats& stats)
@@ -1069,10 +1293,14 @@ void GetDHTStats(CSessionStats& stats)
 
 bool ReannounceEntry(const CMutableData& mutableData)
 {
-    if (arraySessions.size() == 0 || !arraySessions[0].second)
+    if (mutableData.vchInfoHash.size() != sizeof(uint160))
+        return false;
+
+    std::shared_ptr<CHashTableSession> pSession = RouteSession(uint160(mutableData.vchInfoHash));
+    if (!pSession)
         return false;
 
-    return arraySessions[0].second->ReannounceEntry(mutableData);
+    return pSession->ReannounceEntry(mutableData);
 }
 
 void GetEvents(const int64_t& startTime, std::vector<CEvent>& events)
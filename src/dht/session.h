@@ -6,6 +6,8 @@
 #define DYNAMIC_DHT_SESSION_H
 
 #include "dht/datarecord.h"
+#include "dht/eventbuffer.h"
+#include "dht/mutablecache.h" // for SaltedTargetHasher
 #include "dht/sessionevents.h"
 #include "sync.h"
 
@@ -15,7 +17,11 @@
 #include "libtorrent/session.hpp"
 #include "libtorrent/session_status.hpp"
 
-#include <map> // for std::map and std::multimap
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 class CChainParams;
 class CConnman;
@@ -24,10 +30,10 @@ class CKeyEd25519;
 class CLinkInfo;
 class CMutableData;
 class CMutableGetEvent;
+class CReannounceScheduler;
 
-typedef std::pair<int64_t, CEvent> EventPair;
-typedef std::multimap<int, EventPair> EventTypeMap;
-typedef std::map<std::string, CMutableGetEvent> DHTGetEventMap;
+typedef std::unordered_map<uint160, CMutableGetEvent, SaltedTargetHasher> DHTGetEventMap;
+typedef std::unordered_map<uint160, int, SaltedTargetHasher> DHTPutResultMap;
 
 static constexpr int DHT_BOOTSTRAP_ALERT_TYPE_CODE = 62;
 static constexpr int STATS_ALERT_TYPE_CODE = 70;
@@ -37,7 +43,18 @@ static constexpr int DHT_PUT_ALERT_TYPE_CODE = 76;
 static constexpr int DHT_STATS_ALERT_TYPE_CODE = 83;
 
 static constexpr int64_t DHT_RECORD_LOCK_SECONDS = 16;
+static constexpr int64_t DHT_GET_TIMEOUT_MILLIS = 2000;
+/** Attempts per record chunk before a get record fails */
+static constexpr unsigned int DHT_GET_CHUNK_ATTEMPTS = 3;
+/** Chunk gets of one record outstanding at the same time */
+static constexpr unsigned int DHT_MAX_CHUNK_GETS_IN_FLIGHT = 8;
+/** Time SubmitGetAllRecordsAsync waits for records still incomplete, enough for every attempt at a header and then a chunk */
+static constexpr int64_t DHT_GET_ALL_RECORDS_TIMEOUT_MILLIS = 2 * DHT_GET_CHUNK_ATTEMPTS * DHT_GET_TIMEOUT_MILLIS;
 static constexpr uint32_t DHT_KEEP_PUT_BUFFER_SECONDS = 300;
+/** Alerts popped at once that mark a session's alert queue as backed up, half the libtorrent default queue */
+static constexpr size_t DHT_ALERT_BACKLOG = 500;
+/** Time without an alert poll after which a session counts as backed up */
+static constexpr int64_t DHT_ALERT_STALL_MILLIS = 3000;
 
 typedef std::pair<std::array<char, 32>, std::string> HashRecordKey; // public key and salt pair
 
@@ -64,41 +81,62 @@ public:
     libtorrent::session* Session = nullptr;
     std::string strErrorMessage;
     bool fShutdown = false;
-    EventTypeMap m_EventTypeMap;
+    CEventBuffer eventBuffer;
+    // Latest get result by item target
     DHTGetEventMap m_DHTGetEventMap;
     libtorrent::dht_stats_alert* DHTStats = nullptr;
     libtorrent::session_stats_alert* SessionStats = nullptr;
-    CCriticalSection cs_EventMap;
-    CCriticalSection cs_DHTGetEventMap;
+    Mutex cs_DHTGetEventMap;
+    // Signaled when a get result arrives for an info hash in setPendingGets
+    std::condition_variable cvDHTGetEvent;
+    // Info hashes callers are blocked on, so unrelated results wake nobody
+    std::multiset<uint160> setPendingGets;
+    // Nodes that stored puts callers wait for, -1 until the put completes
+    DHTPutResultMap mapPendingPuts;
+    // Requests routed to this session and not answered yet
+    std::atomic<int> nInFlight{0};
+    // Time and size of the event listener's last alert poll
+    std::atomic<int64_t> nLastAlertPoll{0};
+    std::atomic<size_t> nLastAlertCount{0};
+    // Told how many nodes stored each put, nullptr for sessions that don't re-announce
+    CReannounceScheduler* pReannounceScheduler = nullptr;
 
     CHashTableSession() : strName(""), vDataEntries(CDataRecordBuffer(32)), strErrorMessage(""), fShutdown(false) {};
 
     bool SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64> private_key, const int64_t lastSequence, const std::string& strSalt, const libtorrent::entry& entryValue);
+    /** Put a mutable item and wait until it completes, nSuccess is the number of nodes that stored it */
+    bool SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64> private_key, const int64_t lastSequence, const std::string& strSalt, const libtorrent::entry& entryValue,
+                            const int64_t& timeout, int& nSuccess);
 
     bool SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt);
     bool SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt, const int64_t& timeout, 
                             std::string& recordValue, int64_t& lastSequence, bool& fAuthoritative);
     /** Get a mutable record in the libtorrent DHT */
     bool SubmitGetRecord(const std::array<char, 32>& public_key, const std::array<char, 32>& private_seed, const std::string& strOperationType, int64_t& iSequence, CDataRecord& record);
+    /** Get all chunks of a record concurrently, they must have the header sequence number */
+    bool SubmitGetChunks(const std::array<char, 32>& public_key, const std::string& strOperationType, const CRecordHeader& header, const int64_t iSequence, std::vector<std::string>& vChunkValues);
     bool SubmitGetAllRecordsAsync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords);
     bool SubmitGetAllRecordsSync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords);
     bool Bootstrap();
     bool GetAllDHTGetEvents(std::vector<CMutableGetEvent>& vchGetEvents);
-    void AddToDHTGetEventMap(const std::string& infoHash, const CMutableGetEvent& event);
-    void AddToEventMap(const int type, const CEvent& event);
-    void CleanUpEventMap(const uint32_t timeout);
+    void AddToDHTGetEventMap(const uint160& infoHash, const CMutableGetEvent& event);
+    void AddPutResult(const uint160& infoHash, const int nSuccess);
+    void AddToEventMap(const CEvent& event);
+    void CleanUpEventMap(const int64_t timeout);
     void StopEventListener();
     bool ReannounceEntry(const CMutableData& mutableData);
     void GetEvents(const int64_t& startTime, std::vector<CEvent>& events);
+    /** True when the event listener is behind on this session's alerts */
+    bool IsBackedUp() const;
 
 private:
-    bool GetDataFromMap(const std::array<char, 32>& public_key, const std::string& recordSalt, CMutableGetEvent& event);
     //bool LoadSessionState();
     //int SaveSessionState();
     //std::string GetSessionStatePath();
-    bool RemoveDHTGetEvent(const std::string& infoHash);
+    bool RemoveDHTGetEvent(const uint160& infoHash);
     bool GetLastTypeEvent(const int& type, const int64_t& startTime, std::vector<CEvent>& events);
-    bool FindDHTGetEvent(const std::string& infoHash, CMutableGetEvent& event);
+    bool FindDHTGetEvent(const uint160& infoHash, CMutableGetEvent& event);
+    bool WaitForDHTGetEvent(const uint160& infoHash, const int64_t& timeout, CMutableGetEvent& event);
 
 };
 
@@ -117,14 +155,15 @@ namespace DHT
 {
     bool SessionStatus();
     bool SubmitPut(const std::array<char, 32> public_key, const std::array<char, 64> private_key, const int64_t lastSequence, const CDataRecord& record, std::string& strErrorMessage);
-    bool SubmitGet(const size_t nSessionThread, const std::array<char, 32>& public_key, const std::string& recordSalt);
-    bool SubmitGet(const size_t nSessionThread, const std::array<char, 32>& public_key, const std::string& recordSalt, const int64_t& timeout, 
+    bool SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt);
+    bool SubmitGet(const std::array<char, 32>& public_key, const std::string& recordSalt, const int64_t& timeout, 
                             std::string& recordValue, int64_t& lastSequence, bool& fAuthoritative);
-    bool SubmitGetRecord(const size_t nSessionThread, const std::array<char, 32>& public_key, const std::array<char, 32>& private_seed, 
+    bool SubmitGetRecord(const std::array<char, 32>& public_key, const std::array<char, 32>& private_seed, 
                             const std::string& strOperationType, int64_t& iSequence, CDataRecord& record);
-    bool SubmitGetAllRecordsSync(const size_t nSessionThread, const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords);
-    bool SubmitGetAllRecordsAsync(const size_t nSessionThread, const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords);
-    bool GetAllDHTGetEvents(const size_t nSessionThread, std::vector<CMutableGetEvent>& vchGetEvents);
+    bool SubmitGetAllRecordsSync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords);
+    bool SubmitGetAllRecordsAsync(const std::vector<CLinkInfo>& vchLinkInfo, const std::string& strOperationType, std::vector<CDataRecord>& vchRecords);
+    /** Get events of all sessions */
+    bool GetAllDHTGetEvents(std::vector<CMutableGetEvent>& vchGetEvents);
     void GetDHTStats(CSessionStats& stats);
     bool ReannounceEntry(const CMutableData& mutableData);
     void GetEvents(const int64_t& startTime, std::vector<CEvent>& events);
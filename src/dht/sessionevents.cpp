@@ -18,6 +18,8 @@
 #include <libtorrent/session_status.hpp>
 #include <libtorrent/time.hpp>
 
+#include <cstring> // for memcpy
+
 using namespace libtorrent;
 
 CEvent::CEvent(const std::string& _message, const int _type, const uint32_t _category, const std::string& _what)
@@ -29,6 +31,15 @@ CEvent::CEvent(const std::string& _message, const int _type, const uint32_t _cat
     timestamp = GetTimeMillis();
 }
 
+CEvent::CEvent(const std::string& _message, const int _type, const uint32_t _category, const std::string& _what, const int64_t _timestamp)
+{
+    message = _message;
+    type = _type;
+    category = _category;
+    what = _what;
+    timestamp = _timestamp;
+}
+
 std::string CEvent::ToString() const 
 {
     return strprintf("CEvent(Message = %s\n, Type = %d\n, Category = %d\n, What = %s\n, Timestamp = %u)\n",
@@ -45,6 +56,16 @@ std::string GetInfoHash(const std::string& pubkey, const std::string& salt)
     return aux::to_hex(infoHash.to_string());
 }
 
+uint160 GetMutableTarget(const std::array<char, 32>& public_key, const std::string& salt)
+{
+    dht::public_key pk;
+    pk.bytes = public_key;
+    const sha1_hash infoHash = dht::item_target_id(salt, pk);
+    uint160 target;
+    std::memcpy(target.begin(), infoHash.data(), target.size());
+    return target;
+}
+
 std::string GetDynodeHashID(const std::string& service_address)
 {
     hasher hashNodeID(service_address.c_str(), service_address.size());
@@ -6,7 +6,9 @@
 #define DYNAMIC_DHT_SESSION_EVENTS_H
 
 #include "dht/ed25519.h"
+#include "uint256.h"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -24,8 +26,9 @@ private:
     std::int64_t timestamp;
 
 public:
-    CEvent() {};
+    CEvent() : type(0), category(0), timestamp(0) {};
     CEvent(const std::string& _message, const int _type, const uint32_t _category, const std::string& _what);
+    CEvent(const std::string& _message, const int _type, const uint32_t _category, const std::string& _what, const int64_t _timestamp);
 
     std::string Message() const { return message; }
     int Type() const { return type; }
@@ -62,7 +65,7 @@ public:
     std::string PublicKey() const { return pubkey; }
     std::string Salt() const { return salt; }
     std::int64_t SequenceNumber() const { return seq; }
-    std::string Value() const { return value; }
+    const std::string& Value() const { return value; }
     std::string Signature() const { return signature; }
     bool Authoritative() const { return authoritative; }
     std::string InfoHash() const { return infohash; }
@@ -155,6 +158,8 @@ public:
 };
 
 std::string GetInfoHash(const std::string& pubkey, const std::string& salt);
+/** Binary target of the mutable item with public_key and salt */
+uint160 GetMutableTarget(const std::array<char, 32>& public_key, const std::string& salt);
 std::string GetDynodeHashID(const std::string& service_address);
 
 #endif // DYNAMIC_DHT_SESSION_EVENTS_H
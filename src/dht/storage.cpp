@@ -9,6 +9,7 @@
 #include "dht/limits.h"
 #include "dht/mutable.h"
 #include "dht/mutabledb.h"
+#include "dht/reannounce.h"
 #include "util.h"
 #include "validation.h"
 
@@ -77,18 +78,46 @@ void CDHTStorage::put_immutable_item(sha1_hash const& target, span<char const> b
     LogPrint("dht", "CDHTStorage -- put_immutable_item target = %s, buf = %s, addr = %s\n", aux::to_hex(target.to_string()), std::string(buf.data()), addr.to_string());
 }
 
+// Memory and database lookups are keyed on the raw target
+static uint160 TargetToUint160(sha1_hash const& target)
+{
+    uint160 result;
+    std::memcpy(result.begin(), target.data(), result.size());
+    return result;
+}
+
+bool CDHTStorage::IsStoring() const
+{
+    // Only Dynodes store DHT data, standalone nodes always do
+    return pDataDB || fDynodeMode;
+}
+
+bool CDHTStorage::ReadItem(const uint160& target, CMutableData& data) const
+{
+    if (!pDataDB)
+        return GetLocalMutableData(target, data);
+
+    return pDataDB->ReadMutableData(target, data) && !data.IsNull();
+}
+
+bool CDHTStorage::WriteItem(const CMutableData& data, bool fNew)
+{
+    if (!pDataDB)
+        return fNew ? PutLocalMutableData(data.vchInfoHash, data) : UpdateLocalMutableData(data.vchInfoHash, data);
+
+    return fNew ? pDataDB->AddMutableData(data) : pDataDB->UpdateMutableData(data);
+}
+
 bool CDHTStorage::get_mutable_item_seq(sha1_hash const& target, sequence_number& seq) const
 {
-    if (!fDynodeMode) // Only try to get DHT data if Dynode
+    if (!IsStoring())
         return false;
     //bool ret = pDefaultStorage->get_mutable_item_seq(target, seq);
     //return ret;
-    // TODO (DHT): Try to find entry in memory before searching leveldb
     CMutableData mutableData;
     std::string strInfoHash = aux::to_hex(target.to_string());
-    CharString vchInfoHash = vchFromString(strInfoHash);
     LogPrint("dht", "CDHTStorage -- get_mutable_item_seq infohash = %s\n", strInfoHash);
-    if (!GetLocalMutableData(vchInfoHash, mutableData)) {
+    if (!ReadItem(TargetToUint160(target), mutableData)) {
         LogPrintf("********** CDHTStorage -- get_mutable_item_seq failed to get mutable entry sequence_number for infohash = %s.\n", strInfoHash);
         return false;
     }
@@ -109,15 +138,13 @@ static entry get_bdecode(T start, T end)
 
 bool CDHTStorage::get_mutable_item(sha1_hash const& target, sequence_number const seq, bool const force_fill, entry& item) const
 {
-    if (!fDynodeMode) // Only try to get DHT data if Dynode
+    if (!IsStoring())
         return false;
     //bool ret = pDefaultStorage->get_mutable_item(target, seq, force_fill, item);
     //return ret;
-    // TODO (DHT): Try to find entry in memory before searching leveldb
     CMutableData mutableData;
-    std::string strInfoHash = aux::to_hex(target.to_string());
-    CharString vchInfoHash = vchFromString(strInfoHash);
-    if (!GetLocalMutableData(vchInfoHash, mutableData)) {
+    if (!ReadItem(TargetToUint160(target), mutableData)) {
+        std::string strInfoHash = aux::to_hex(target.to_string());
         LogPrintf("********** CDHTStorage -- get_mutable_item failed to get mutable entry for infohash = %s.\n", strInfoHash);
         return false;
     }
@@ -125,12 +152,14 @@ bool CDHTStorage::get_mutable_item(sha1_hash const& target, sequence_number cons
     if (force_fill || (sequence_number(0) <= seq && seq < sequence_number(mutableData.SequenceNumber)))
     {
         LogPrint("dht", "********** CDHTStorage -- get_mutable_item data found.\n");
+        if (mutableData.vchSignature.size() != ED25519_SIGTATURE_BYTE_LENGTH || mutableData.vchPublicKey.size() != ED25519_PUBLIC_KEY_BYTE_LENGTH)
+            return false;
         item["v"] = get_bdecode(mutableData.vchValue.begin(), mutableData.vchValue.end());
-        std::array<char, 64> sig;
-        aux::from_hex(mutableData.Signature(), sig.data());
+        std::array<char, ED25519_SIGTATURE_BYTE_LENGTH> sig;
+        std::memcpy(sig.data(), mutableData.vchSignature.data(), sig.size());
         item["sig"] = sig;
-        std::array<char, 32> pubKey;
-        aux::from_hex(mutableData.PublicKey(), pubKey.data());
+        std::array<char, ED25519_PUBLIC_KEY_BYTE_LENGTH> pubKey;
+        std::memcpy(pubKey.data(), mutableData.vchPublicKey.data(), pubKey.size());
         item["k"] = pubKey;
     }
     LogPrint("dht", "CDHTStorage -- get_mutable_item target = %s, item = %s\n", aux::to_hex(target.to_string()), item.to_string());
@@ -152,25 +181,21 @@ void CDHTStorage::put_mutable_item(sha1_hash const& target
     , span<char const> salt
     , address const& addr)
 {
-    if (!fDynodeMode) // Do not store DHT data if not a Dynode
+    if (!IsStoring())
         return;
     // TODO (DHT): Store entries in memory as well
     //pDefaultStorage->put_mutable_item(target, buf, sig, seq, pk, salt, addr);
 
-    std::string strInfoHash = aux::to_hex(target.to_string());
-    CharString vchInfoHash = vchFromString(strInfoHash);
-
-    std::unique_ptr<char[]> value;
-    ExtractValueFromSpan(value, buf);
-    std::string strPutValue = std::string(value.get(), buf.size());
-    CharString vchPutValue = vchFromString(strPutValue);
+    const uint160 infoHash = TargetToUint160(target);
+    CharString vchInfoHash(infoHash.begin(), infoHash.end());
 
-    std::string strSignature = aux::to_hex(std::string(sig.bytes.data(), ED25519_SIGTATURE_BYTE_LENGTH));
-    CharString vchSignature = vchFromString(strSignature);
+    CharString vchPutValue(buf.begin(), buf.end());
+    CharString vchSignature(sig.bytes.begin(), sig.bytes.end());
+    CharString vchPublicKey(pk.bytes.begin(), pk.bytes.end());
 
-    std::string strPublicKey = aux::to_hex(std::string(pk.bytes.data(), ED25519_PUBLIC_KEY_BYTE_LENGTH));
-    CharString vchPublicKey = vchFromString(strPublicKey);
-    if (!CheckPubKey(vchPublicKey)) {
+    // Account and link records keep their DHT public key hex encoded
+    const std::string strPublicKey = aux::to_hex(std::string(pk.bytes.data(), ED25519_PUBLIC_KEY_BYTE_LENGTH));
+    if (!pDataDB && !CheckPubKey(vchFromString(strPublicKey))) {
         LogPrintf("%s -- Invalid pubkey used (%s).  DHT put storage request failed.\n", __func__, strPublicKey);
         return;
     }
@@ -188,18 +213,22 @@ void CDHTStorage::put_mutable_item(sha1_hash const& target
 
     CMutableData putMutableData(vchInfoHash, vchPublicKey, vchSignature, seq.value, vchSalt, vchPutValue);
     LogPrint("dht", "CDHTStorage::%s -- put_mutable_item info_hash = %s, buf_value = %s, salt = %s, seq = %d, put_size = %d, sig_size = %d, pubkey_size = %d, salt_size = %d\n", 
-                    __func__, strInfoHash, strPutValue, strSalt, putMutableData.SequenceNumber, 
+                    __func__, putMutableData.InfoHash(), putMutableData.Value(), strSalt, putMutableData.SequenceNumber, 
                     vchPutValue.size(), vchSignature.size(), vchPublicKey.size(), vchSalt.size());
 
     CMutableData previousData;
-    if (!GetLocalMutableData(vchInfoHash, previousData)) {
-        if (PutLocalMutableData(vchInfoHash, putMutableData)) {
+    if (!ReadItem(infoHash, previousData)) {
+        if (WriteItem(putMutableData, true)) {
+            if (!pDataDB)
+                reannounceScheduler.Update(infoHash, putMutableData.SequenceNumber);
             LogPrintf("CDHTStorage::%s added successfully\n", __func__);
         }
     }
     else {
         if (putMutableData.SequenceNumber > previousData.SequenceNumber) {
-            if (UpdateLocalMutableData(vchInfoHash, putMutableData)) {
+            if (WriteItem(putMutableData, false)) {
+                if (!pDataDB)
+                    reannounceScheduler.Update(infoHash, putMutableData.SequenceNumber);
                 LogPrintf("CDHTStorage::%s updated successfully\n", __func__);
             }
         }
@@ -232,4 +261,9 @@ dht_storage_counters CDHTStorage::counters() const
 std::unique_ptr<dht_storage_interface> CDHTStorageConstructor(dht_settings const& settings)
 {
     return std::unique_ptr<CDHTStorage>(new CDHTStorage(settings));
+}
+
+std::unique_ptr<dht_storage_interface> CDHTStorageConstructor(dht_settings const& settings, CMutableDataDB* pDataDB)
+{
+    return std::unique_ptr<CDHTStorage>(new CDHTStorage(settings, pDataDB));
 }
\ No newline at end of file
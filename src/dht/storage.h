@@ -11,6 +11,10 @@
 using namespace libtorrent;
 using namespace libtorrent::dht;
 
+class CMutableDataDB;
+class CMutableData;
+class uint160;
+
 class CDHTStorage final : public dht_storage_interface
 {
 public:
@@ -20,6 +24,16 @@ public:
         pDefaultStorage = dht_default_storage_constructor(settings);
     }
 
+    /**
+     * Storage of a standalone node, such as a testbed node, that keeps items
+     * in its own database. It stores items whether or not this is a Dynode and
+     * does not check public keys against BDAP accounts.
+     */
+    CDHTStorage(dht_settings const& settings, CMutableDataDB* pDataDBIn) : pDataDB(pDataDBIn)
+    {
+        pDefaultStorage = dht_default_storage_constructor(settings);
+    }
+
     ~CDHTStorage() override = default;
 
     CDHTStorage(CDHTStorage const&) = delete;
@@ -50,11 +64,18 @@ public:
 
 private:
     std::unique_ptr<dht_storage_interface> pDefaultStorage;
+    // Database of a standalone node, nullptr for the local Dynode database
+    CMutableDataDB* pDataDB = nullptr;
+
+    bool IsStoring() const;
+    bool ReadItem(const uint160& target, CMutableData& data) const;
+    bool WriteItem(const CMutableData& data, bool fNew);
 
 };
 
 void ExtractValueFromSpan(std::unique_ptr<char[]>& value, const span<char const>& buf);
 
 std::unique_ptr<dht_storage_interface> CDHTStorageConstructor(dht_settings const& settings);
+std::unique_ptr<dht_storage_interface> CDHTStorageConstructor(dht_settings const& settings, CMutableDataDB* pDataDB);
 
 #endif // DYNAMIC_DHT_STORAGE_H
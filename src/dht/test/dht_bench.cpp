@@ -0,0 +1,227 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bdap/utils.h"
+#include "chainparams.h"
+#include "dht/datarecord.h"
+#include "dht/ed25519.h"
+#include "dht/session.h"
+#include "dht/test/testbed.h"
+#include "random.h"
+#include "util.h"
+#include "utilstrencodings.h"
+#include "utiltime.h"
+
+#include <libtorrent/entry.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Salts of the "test" operation code, the only one meant for benchmarks
+static const std::string BENCH_OPERATION = "test";
+static const std::string BENCH_ITEM_SALT = BENCH_OPERATION + ":1";
+static const uint16_t BENCH_RECORD_SLOTS = 8;
+
+static void Usage()
+{
+    std::fprintf(stderr,
+        "Usage: dht_bench [options]\n\n"
+        "Starts a DHT network of in-process nodes on 127.0.0.1, then puts and gets\n"
+        "items and records through them and reports latencies and success rates.\n\n"
+        "Options:\n"
+        "  -nodes=<n>          DHT nodes to start (default: 8)\n"
+        "  -port=<port>        UDP port of the first node, the others follow (default: 34611)\n"
+        "  -puts=<n>           Items to put (default: 200)\n"
+        "  -gets=<n>           Gets of the items put (default: 400)\n"
+        "  -records=<n>        Records to put and get back (default: 20)\n"
+        "  -valuesize=<n>      Bytes per item value, at most 1000 (default: 256)\n"
+        "  -recordsize=<n>     Bytes per record (default: 2048)\n"
+        "  -concurrency=<n>    Requests in flight (default: 4)\n"
+        "  -timeout=<ms>       Timeout per request (default: 5000)\n"
+        "  -printtoconsole     Send the DHT log to the console\n");
+}
+
+/** Latencies of the successful requests of one workload and its failure count */
+class CLatencyStats
+{
+private:
+    std::mutex cs;
+    std::vector<int64_t> vLatency;
+    size_t nFailed = 0;
+
+public:
+    void Add(int64_t nMillis, bool fSuccess)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (fSuccess) {
+            vLatency.push_back(nMillis);
+        } else {
+            nFailed++;
+        }
+    }
+
+    void Print(const std::string& strName, int64_t nElapsedMillis)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        std::sort(vLatency.begin(), vLatency.end());
+        const size_t nTotal = vLatency.size() + nFailed;
+        auto percentile = [this](double p) -> int64_t {
+            if (vLatency.empty())
+                return 0;
+            return vLatency[std::min(vLatency.size() - 1, size_t(p * vLatency.size()))];
+        };
+        std::printf("%-8s requests = %5u, success = %5.1f%%, rate = %7.1f/s, p50 = %5dms, p90 = %5dms, p99 = %5dms, max = %5dms\n",
+            strName.c_str(), (unsigned int)nTotal, nTotal ? 100.0 * vLatency.size() / nTotal : 0.0,
+            nElapsedMillis ? 1000.0 * nTotal / nElapsedMillis : 0.0,
+            (int)percentile(0.5), (int)percentile(0.9), (int)percentile(0.99), (int)percentile(1.0));
+    }
+};
+
+/** Run fn(0) .. fn(nCount - 1) on nThreads threads, returns the elapsed milliseconds */
+static int64_t RunWorkload(size_t nCount, size_t nThreads, const std::function<void(size_t)>& fn)
+{
+    const int64_t nStart = GetTimeMillis();
+    std::atomic<size_t> nNext{0};
+    std::vector<std::thread> vThreads;
+    for (size_t t = 0; t < nThreads; t++) {
+        vThreads.emplace_back([&nNext, nCount, &fn]() {
+            for (size_t i = nNext++; i < nCount; i = nNext++)
+                fn(i);
+        });
+    }
+    for (std::thread& thread : vThreads)
+        thread.join();
+
+    return GetTimeMillis() - nStart;
+}
+
+static std::string RandomValue(size_t nSize)
+{
+    std::vector<unsigned char> vch((nSize + 1) / 2);
+    GetRandBytes(vch.data(), vch.size());
+    return HexStr(vch).substr(0, nSize);
+}
+
+int main(int argc, char* argv[])
+{
+    ParseParameters(argc, argv);
+    if (IsArgSet("-?") || IsArgSet("-h") || IsArgSet("-help")) {
+        Usage();
+        return 0;
+    }
+    RandomInit();
+    SetupEnvironment();
+    fPrintToDebugLog = false; // don't want to write to debug.log file
+    fPrintToConsole = GetBoolArg("-printtoconsole", false);
+    SelectParams(CBaseChainParams::MAIN);
+
+    const size_t nNodes = std::max<int64_t>(GetArg("-nodes", 8), 2);
+    const uint16_t nPort = GetArg("-port", 34611);
+    const size_t nPuts = std::max<int64_t>(GetArg("-puts", 200), 0);
+    const size_t nGets = std::max<int64_t>(GetArg("-gets", 400), 0);
+    const size_t nRecords = std::max<int64_t>(GetArg("-records", 20), 0);
+    const size_t nValueSize = std::min<int64_t>(std::max<int64_t>(GetArg("-valuesize", 256), 1), 1000);
+    const size_t nRecordSize = std::max<int64_t>(GetArg("-recordsize", 2048), 1);
+    const size_t nConcurrency = std::max<int64_t>(GetArg("-concurrency", 4), 1);
+    const int64_t nTimeout = std::max<int64_t>(GetArg("-timeout", 5000), 1);
+
+    const boost::filesystem::path pathData = boost::filesystem::temp_directory_path() / strprintf("dht_bench_%lu_%i", (unsigned long)GetTime(), (int)GetRand(100000));
+    boost::filesystem::create_directories(pathData);
+
+    int nRet = 0;
+    {
+        CDHTTestbed testbed(pathData, nPort);
+        std::printf("Starting %u DHT nodes on 127.0.0.1:%u-%u\n", (unsigned int)nNodes, nPort, (unsigned int)(nPort + nNodes - 1));
+        const int64_t nStart = GetTimeMillis();
+        if (!testbed.Start(nNodes)) {
+            std::fprintf(stderr, "Error: DHT nodes failed to bootstrap\n");
+            nRet = 1;
+        }
+        else {
+            std::printf("Bootstrapped in %dms\n", (int)(GetTimeMillis() - nStart));
+
+            // Each item has its own key and is put from a node picked by its index
+            std::vector<CKeyEd25519> vKeys(nPuts);
+            std::vector<std::string> vValues(nPuts);
+            CLatencyStats putStats;
+            int64_t nElapsed = RunWorkload(nPuts, nConcurrency, [&](size_t i) {
+                vValues[i] = RandomValue(nValueSize);
+                const int64_t nPutStart = GetTimeMillis();
+                int nSuccess = 0;
+                const bool fPut = testbed.Node(i % nNodes)->SubmitPut(vKeys[i].GetDHTPubKey(), vKeys[i].GetDHTPrivKey(), 0, BENCH_ITEM_SALT,
+                                    libtorrent::entry(vValues[i]), nTimeout, nSuccess);
+                putStats.Add(GetTimeMillis() - nPutStart, fPut && nSuccess > 0);
+            });
+            putStats.Print("put", nElapsed);
+
+            // Gets go to another node than the one that put the item
+            CLatencyStats getStats;
+            if (nPuts > 0) {
+                nElapsed = RunWorkload(nGets, nConcurrency, [&](size_t n) {
+                    const size_t i = n % nPuts;
+                    const size_t nNode = (i + 1 + GetRand(nNodes - 1)) % nNodes;
+                    std::string strValue;
+                    int64_t nSequence = 0;
+                    bool fAuthoritative = false;
+                    const int64_t nGetStart = GetTimeMillis();
+                    const bool fGet = testbed.Node(nNode)->SubmitGet(vKeys[i].GetDHTPubKey(), BENCH_ITEM_SALT, nTimeout, strValue, nSequence, fAuthoritative);
+                    getStats.Add(GetTimeMillis() - nGetStart, fGet && strValue == vValues[i]);
+                });
+                getStats.Print("get", nElapsed);
+            }
+
+            // Records are put piece by piece like DHT::SubmitPut and read back with SubmitGetRecord
+            CLatencyStats putRecordStats;
+            CLatencyStats getRecordStats;
+            std::vector<CKeyEd25519> vRecordKeys(nRecords);
+            std::vector<std::string> vRecordValues(nRecords);
+            nElapsed = RunWorkload(nRecords, nConcurrency, [&](size_t i) {
+                const CKeyEd25519& key = vRecordKeys[i];
+                vRecordValues[i] = RandomValue(nRecordSize);
+                const int64_t nPutStart = GetTimeMillis();
+                std::vector<std::vector<unsigned char>> vvchPubKeys;
+                vvchPubKeys.push_back(key.GetPubKeyBytes());
+                CDataRecord record(BENCH_OPERATION, BENCH_RECORD_SLOTS, vvchPubKeys, vchFromString(vRecordValues[i]), 1, GetTime() + 3600, DHT::DataFormat::BinaryBlob);
+                bool fPut = !record.HasError();
+                std::vector<std::pair<std::string, libtorrent::entry>> vPieces;
+                vPieces.push_back(std::make_pair(record.GetHeader().Salt, libtorrent::entry(record.HeaderHex)));
+                for (const CDataChunkSpan& span : record.GetChunkSpans()) {
+                    vPieces.push_back(std::make_pair(span.Salt, libtorrent::entry(libtorrent::entry::string_t)));
+                    record.WriteChunk(span, vPieces.back().second.string());
+                }
+                for (const std::pair<std::string, libtorrent::entry>& piece : vPieces) {
+                    int nSuccess = 0;
+                    if (!fPut)
+                        break;
+                    fPut = testbed.Node(i % nNodes)->SubmitPut(key.GetDHTPubKey(), key.GetDHTPrivKey(), 0, piece.first, piece.second, nTimeout, nSuccess) && nSuccess > 0;
+                }
+                putRecordStats.Add(GetTimeMillis() - nPutStart, fPut);
+            });
+            putRecordStats.Print("putrecord", nElapsed);
+
+            nElapsed = RunWorkload(nRecords, nConcurrency, [&](size_t i) {
+                const CKeyEd25519& key = vRecordKeys[i];
+                const size_t nNode = (i + 1 + GetRand(nNodes - 1)) % nNodes;
+                int64_t nSequence = 0;
+                CDataRecord record;
+                const int64_t nGetStart = GetTimeMillis();
+                const bool fGet = testbed.Node(nNode)->SubmitGetRecord(key.GetDHTPubKey(), key.GetDHTPrivSeed(), BENCH_OPERATION, nSequence, record);
+                getRecordStats.Add(GetTimeMillis() - nGetStart, fGet && record.Value() == vRecordValues[i]);
+            });
+            getRecordStats.Print("getrecord", nElapsed);
+
+            std::printf("Items stored on all nodes: %u\n", (unsigned int)testbed.StoredItems());
+        }
+        testbed.Stop();
+    }
+    boost::filesystem::remove_all(pathData);
+    return nRet;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/test/testbed.h"
+
+#include "dht/mutabledb.h"
+#include "dht/session.h"
+#include "dht/storage.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <libtorrent/alert.hpp>
+#include <libtorrent/kademlia/dht_settings.hpp>
+#include <libtorrent/session.hpp>
+#include <libtorrent/settings_pack.hpp>
+
+#include <algorithm>
+#include <functional>
+
+using namespace libtorrent;
+
+CDHTTestbed::CDHTTestbed(const boost::filesystem::path& pathDataIn, uint16_t nBasePortIn) : pathData(pathDataIn), nBasePort(nBasePortIn)
+{
+}
+
+CDHTTestbed::~CDHTTestbed()
+{
+    Stop();
+}
+
+bool CDHTTestbed::Start(size_t nNodes)
+{
+    Stop();
+    const int64_t nStartTime = GetTimeMillis();
+    for (size_t i = 0; i < nNodes; i++) {
+        CTestbedNode node;
+        node.pDataDB.reset(new CMutableDataDB(pathData / strprintf("node%u", i), 1 << 20, DEFAULT_DHT_CACHE_MB << 20, false, true));
+        node.pDataDB->LoadMemoryMap();
+
+        std::string strBootstrapNodes;
+        for (size_t j = 0; j < nNodes; j++) {
+            if (j != i)
+                strBootstrapNodes += strprintf("127.0.0.1:%u,", nBasePort + j);
+        }
+        if (!strBootstrapNodes.empty())
+            strBootstrapNodes.pop_back(); // removes trailing comma
+
+        // The storage is set while the DHT is off, like CDHTSettings does
+        settings_pack settings;
+        settings.set_bool(settings_pack::enable_dht, false);
+        session* pSession = new session(settings);
+        CMutableDataDB* pDataDB = node.pDataDB.get();
+        pSession->set_dht_storage([pDataDB](dht_settings const& dhtSettings) { return CDHTStorageConstructor(dhtSettings, pDataDB); });
+
+        settings.set_int(settings_pack::alert_mask, alert::dht_notification | alert::error_notification);
+        settings.set_bool(settings_pack::enable_dht, true);
+        settings.set_bool(settings_pack::enable_lsd, false);
+        settings.set_bool(settings_pack::enable_upnp, false);
+        settings.set_bool(settings_pack::enable_natpmp, false);
+        settings.set_str(settings_pack::listen_interfaces, strprintf("127.0.0.1:%u", nBasePort + i));
+        settings.set_str(settings_pack::dht_bootstrap_nodes, strBootstrapNodes);
+
+        // All nodes share one address
+        dht_settings dhtSettings;
+        dhtSettings.restrict_routing_ips = false;
+        dhtSettings.restrict_search_ips = false;
+        dhtSettings.enforce_node_id = false;
+        dhtSettings.ignore_dark_internet = false;
+        dhtSettings.max_dht_items = 100000;
+        pSession->set_dht_settings(dhtSettings);
+        pSession->apply_settings(settings);
+
+        node.pSession = std::make_shared<CHashTableSession>();
+        node.pSession->strName = strprintf("testbed-%u", i);
+        node.pSession->Session = pSession;
+        node.pListener = std::make_shared<std::thread>(std::bind(&StartEventListener, node.pSession));
+        vNodes.push_back(std::move(node));
+    }
+
+    // Nodes started first had nobody to bootstrap from
+    for (size_t i = 0; i < vNodes.size(); i++) {
+        for (size_t j = 0; j < vNodes.size(); j++) {
+            if (j != i)
+                vNodes[i].pSession->Session->add_dht_node(std::make_pair(std::string("127.0.0.1"), int(nBasePort + j)));
+        }
+    }
+    if (!WaitForBootstrap(nStartTime))
+        return false;
+
+    MilliSleep(DHT_TESTBED_SETTLE_MILLIS);
+    return true;
+}
+
+bool CDHTTestbed::WaitForBootstrap(int64_t nStartTime)
+{
+    std::vector<bool> vBootstrapped(vNodes.size(), false);
+    size_t nBootstrapped = 0;
+    while (nBootstrapped < vNodes.size()) {
+        if (GetTimeMillis() - nStartTime > DHT_TESTBED_BOOTSTRAP_MILLIS) {
+            LogPrintf("CDHTTestbed::%s -- %u of %u nodes bootstrapped\n", __func__, nBootstrapped, vNodes.size());
+            return false;
+        }
+        MilliSleep(250);
+        for (size_t i = 0; i < vNodes.size(); i++) {
+            if (vBootstrapped[i])
+                continue;
+            std::vector<CEvent> events;
+            vNodes[i].pSession->GetEvents(nStartTime, events);
+            for (const CEvent& event : events) {
+                if (event.Type() == DHT_BOOTSTRAP_ALERT_TYPE_CODE) {
+                    vBootstrapped[i] = true;
+                    nBootstrapped++;
+                    break;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void CDHTTestbed::Stop()
+{
+    for (CTestbedNode& node : vNodes)
+        node.pSession->StopEventListener();
+
+    for (CTestbedNode& node : vNodes) {
+        node.pListener->join();
+        // Deleting the session waits for libtorrent to shut down
+        delete node.pSession->Session;
+        node.pSession->Session = nullptr;
+    }
+    vNodes.clear();
+}
+
+std::shared_ptr<CHashTableSession> CDHTTestbed::Node(size_t n) const
+{
+    return vNodes[n].pSession;
+}
+
+size_t CDHTTestbed::StoredItems() const
+{
+    size_t nItems = 0;
+    for (const CTestbedNode& node : vNodes)
+        nItems += std::max<int64_t>(node.pDataDB->Size(), 0);
+    return nItems;
+}
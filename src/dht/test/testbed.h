@@ -0,0 +1,58 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_DHT_TEST_TESTBED_H
+#define DYNAMIC_DHT_TEST_TESTBED_H
+
+#include <boost/filesystem/path.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+class CHashTableSession;
+class CMutableDataDB;
+
+/** Time the testbed waits for all nodes to bootstrap */
+static const int64_t DHT_TESTBED_BOOTSTRAP_MILLIS = 30000;
+/** Time the nodes get to fill their routing tables after bootstrapping */
+static const int64_t DHT_TESTBED_SETTLE_MILLIS = 3000;
+
+/**
+ * A DHT network of in-process nodes on 127.0.0.1.
+ *
+ * Each node is a CHashTableSession with its own libtorrent session, event
+ * listener thread and item database under the testbed directory. The nodes
+ * only know each other, so puts and gets never leave the machine.
+ */
+class CDHTTestbed
+{
+public:
+    CDHTTestbed(const boost::filesystem::path& pathDataIn, uint16_t nBasePortIn);
+    ~CDHTTestbed();
+
+    /** Start nNodes nodes on consecutive UDP ports and wait until they bootstrapped from each other */
+    bool Start(size_t nNodes);
+    void Stop();
+
+    size_t size() const { return vNodes.size(); }
+    std::shared_ptr<CHashTableSession> Node(size_t n) const;
+    /** Items stored by all nodes together */
+    size_t StoredItems() const;
+
+private:
+    struct CTestbedNode {
+        std::shared_ptr<CHashTableSession> pSession;
+        std::unique_ptr<CMutableDataDB> pDataDB;
+        std::shared_ptr<std::thread> pListener;
+    };
+
+    boost::filesystem::path pathData;
+    uint16_t nBasePort;
+    std::vector<CTestbedNode> vNodes;
+
+    bool WaitForBootstrap(int64_t nStartTime);
+};
+
+#endif // DYNAMIC_DHT_TEST_TESTBED_H
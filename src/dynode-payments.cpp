@@ -21,6 +21,8 @@
 #include "util.h"
 #include "utilmoneystr.h"
 
+#include <algorithm>
+
 #include <boost/lexical_cast.hpp>
 
 /** Object for who's going to get paid on which blocks */
@@ -223,6 +225,8 @@ void CDynodePayments::Clear()
     LOCK2(cs_mapDynodeBlocks, cs_mapDynodePaymentVotes);
     mapDynodeBlocks.clear();
     mapDynodePaymentVotes.clear();
+    mapPaidPayees.clear();
+    mapPayeeLastPaid.clear();
 }
 
 bool CDynodePayments::UpdateLastVote(const CDynodePaymentVote& vote)
@@ -1102,6 +1106,116 @@ void CDynodePayments::UpdatedBlockTip(const CBlockIndex* pindex, CConnman& connm
     ProcessBlock(nFutureBlock, connman);
 }
 
+void CDynodePayments::AddPaidBlock(const CTransaction& txCoinbase, const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_mapDynodeBlocks);
+
+    RemovePaidBlock(pindex->nHeight);
+
+    CAmount nDynodePayment = GetFluidDynodeReward(pindex->nHeight);
+    std::vector<CScript> vPayees;
+    for (const auto& txout : txCoinbase.vout) {
+        if (txout.nValue == nDynodePayment && std::find(vPayees.begin(), vPayees.end(), txout.scriptPubKey) == vPayees.end()) {
+            vPayees.push_back(txout.scriptPubKey);
+            mapPayeeLastPaid[txout.scriptPubKey][pindex->nHeight] = pindex->nTime;
+        }
+    }
+    // Blocks without a Dynode payment are kept too, so they aren't read again
+    mapPaidPayees.emplace(pindex->nHeight, std::move(vPayees));
+}
+
+void CDynodePayments::RemovePaidBlock(int nBlockHeight)
+{
+    AssertLockHeld(cs_mapDynodeBlocks);
+
+    auto it = mapPaidPayees.find(nBlockHeight);
+    if (it == mapPaidPayees.end())
+        return;
+
+    for (const CScript& payee : it->second) {
+        auto itPayee = mapPayeeLastPaid.find(payee);
+        if (itPayee == mapPayeeLastPaid.end())
+            continue;
+        itPayee->second.erase(nBlockHeight);
+        if (itPayee->second.empty())
+            mapPayeeLastPaid.erase(itPayee);
+    }
+    mapPaidPayees.erase(it);
+}
+
+void CDynodePayments::BlockConnected(const CTransaction& txCoinbase, const CBlockIndex* pindex)
+{
+    if (!pindex)
+        return;
+
+    int nLimit = GetStorageLimit();
+
+    LOCK(cs_mapDynodeBlocks);
+
+    AddPaidBlock(txCoinbase, pindex);
+
+    // Payments older than the stored votes can't count as paid
+    while (!mapPaidPayees.empty() && mapPaidPayees.begin()->first <= pindex->nHeight - nLimit)
+        RemovePaidBlock(mapPaidPayees.begin()->first);
+}
+
+void CDynodePayments::BlockDisconnected(int nBlockHeight)
+{
+    LOCK(cs_mapDynodeBlocks);
+    RemovePaidBlock(nBlockHeight);
+}
+
+void CDynodePayments::LoadLastPaidIndex(const CBlockIndex* pindex)
+{
+    if (!pindex)
+        return;
+
+    int nLimit = GetStorageLimit();
+
+    LOCK(cs_mapDynodeBlocks);
+
+    // Only blocks with votes can count as paid, the others don't need reading.
+    // Votes keep arriving during and after sync, so this runs every time and
+    // picks up the voted blocks that were connected before the index existed.
+    int nBlocksRead = 0;
+    for (auto it = mapDynodeBlocks.upper_bound(pindex->nHeight - nLimit); it != mapDynodeBlocks.end() && it->first <= pindex->nHeight; ++it) {
+        if (mapPaidPayees.count(it->first))
+            continue;
+
+        const CBlockIndex* pindexRead = pindex->GetAncestor(it->first);
+        CBlock block;
+        if (!pindexRead || !ReadBlockFromDisk(block, pindexRead, Params().GetConsensus())) // shouldn't really happen
+            continue;
+
+        AddPaidBlock(*block.vtx[0], pindexRead);
+        nBlocksRead++;
+    }
+
+    if (nBlocksRead > 0)
+        LogPrint("dnpayments", "CDynodePayments::LoadLastPaidIndex -- read %d blocks, %d payees\n", nBlocksRead, mapPayeeLastPaid.size());
+}
+
+bool CDynodePayments::GetLastPaid(const CScript& payee, int nMinBlockHeight, int nMaxBlockHeight, int& nBlockHeightRet, int64_t& nTimeRet) const
+{
+    LOCK(cs_mapDynodeBlocks);
+
+    auto itPayee = mapPayeeLastPaid.find(payee);
+    if (itPayee == mapPayeeLastPaid.end())
+        return false;
+
+    // Heights from nMaxBlockHeight down, only the voted ones count
+    const std::map<int, int64_t>& mapPaid = itPayee->second;
+    for (auto it = std::map<int, int64_t>::const_reverse_iterator(mapPaid.upper_bound(nMaxBlockHeight)); it != mapPaid.rend() && it->first > nMinBlockHeight; ++it) {
+        const auto itBlock = mapDynodeBlocks.find(it->first);
+        if (itBlock != mapDynodeBlocks.end() && itBlock->second.HasPayeeWithVotes(payee, 2)) {
+            nBlockHeightRet = it->first;
+            nTimeRet = it->second;
+            return true;
+        }
+    }
+    return false;
+}
+
 void CDynodePayments::DoMaintenance()
 {
     if (ShutdownRequested()) return;
@@ -189,6 +189,14 @@ private:
     // Keep track of current block height
     int nCachedBlockHeight;
 
+    // Dynode rewards paid by the coinbase of recent blocks, both ways round:
+    // height -> payees paid, and payee -> (height -> block time)
+    std::map<int, std::vector<CScript> > mapPaidPayees;
+    std::map<CScript, std::map<int, int64_t> > mapPayeeLastPaid;
+
+    void AddPaidBlock(const CTransaction& txCoinbase, const CBlockIndex* pindex);
+    void RemovePaidBlock(int nBlockHeight);
+
 public:
     std::map<uint256, CDynodePaymentVote> mapDynodePaymentVotes;
     std::map<int, CDynodeBlockPayees> mapDynodeBlocks;
@@ -237,6 +245,14 @@ public:
 
     void UpdatedBlockTip(const CBlockIndex* pindex, CConnman& connman);
 
+    /// Keep the last paid index in step with the coinbase of connected and disconnected blocks
+    void BlockConnected(const CTransaction& txCoinbase, const CBlockIndex* pindex);
+    void BlockDisconnected(int nBlockHeight);
+    /// Read the coinbase of the voted blocks up to pindex that aren't indexed yet, e.g. connected before startup
+    void LoadLastPaidIndex(const CBlockIndex* pindex);
+    /// Find the highest block in (nMinBlockHeight, nMaxBlockHeight] that paid payee with enough votes
+    bool GetLastPaid(const CScript& payee, int nMinBlockHeight, int nMaxBlockHeight, int& nBlockHeightRet, int64_t& nTimeRet) const;
+
     void DoMaintenance();
 };
 
@@ -35,6 +35,8 @@ void CDynodeSync::Reset()
     nTimeAssetSyncStarted = GetTime();
     nTimeLastBumped = GetTime();
     nTimeLastFailure = 0;
+    // Ranks are only valid for a synced Dynode list
+    dnodeman.InvalidateRankTables();
 }
 
 void CDynodeSync::BumpAssetLastTime(const std::string strFuncName)
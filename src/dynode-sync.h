@@ -54,7 +54,11 @@ private:
     void Fail();
 
 public:
-    CDynodeSync() { Reset(); }
+    CDynodeSync() : nRequestedDynodeAssets(DYNODE_SYNC_INITIAL),
+                    nRequestedDynodeAttempt(0),
+                    nTimeAssetSyncStarted(GetTime()),
+                    nTimeLastBumped(GetTime()),
+                    nTimeLastFailure(0) {}
 
     void SendGovernanceSyncRequest(CNode* pnode, CConnman& connman);
 
@@ -67,6 +67,9 @@ bool CDynode::UpdateFromNewBroadcast(CDynodeBroadcast& dnb, CConnman& connman)
     pubKeyDynode = dnb.pubKeyDynode;
     sigTime = dnb.sigTime;
     vchSig = dnb.vchSig;
+    // Ranks only count Dynodes of a minimum protocol version
+    if (nProtocolVersion != dnb.nProtocolVersion)
+        dnodeman.InvalidateRankTables();
     nProtocolVersion = dnb.nProtocolVersion;
     addr = dnb.addr;
     nPoSeBanScore = 0;
@@ -342,36 +345,17 @@ void CDynode::UpdateLastPaid(const CBlockIndex* pindex, int nMaxBlocksToScanBack
     if (!pindex)
         return;
 
-    const CBlockIndex* BlockReading = pindex;
-
     CScript dnpayee = GetScriptForDestination(pubKeyCollateralAddress.GetID());
     // LogPrint("dynode", "CDynode::UpdateLastPaidBlock -- searching for block with payment to %s\n", vin.prevout.ToStringShort());
 
-    LOCK(cs_mapDynodeBlocks);
-
-    for (int i = 0; BlockReading && BlockReading->nHeight > nBlockLastPaid && i < nMaxBlocksToScanBack; i++) {
-        if (dnpayments.mapDynodeBlocks.count(BlockReading->nHeight) &&
-            dnpayments.mapDynodeBlocks[BlockReading->nHeight].HasPayeeWithVotes(dnpayee, 2)) {
-            CBlock block;
-            if (!ReadBlockFromDisk(block, BlockReading, Params().GetConsensus())) // shouldn't really happen
-                continue;
-
-            CAmount nDynodePayment = GetFluidDynodeReward(BlockReading->nHeight);
-
-            for (const auto& txout : block.vtx[0]->vout)
-                if (dnpayee == txout.scriptPubKey && nDynodePayment == txout.nValue) {
-                    nBlockLastPaid = BlockReading->nHeight;
-                    nTimeLastPaid = BlockReading->nTime;
-                    LogPrint("dynode", "CDynode::UpdateLastPaidBlock -- searching for block with payment to %s -- found new %d\n", outpoint.ToStringShort(), nBlockLastPaid);
-                    return;
-                }
-        }
-
-        if (BlockReading->pprev == nullptr) {
-            assert(BlockReading);
-            break;
-        }
-        BlockReading = BlockReading->pprev;
+    int nMinBlockHeight = std::max(nBlockLastPaid, pindex->nHeight - nMaxBlocksToScanBack);
+    int nBlockPaid;
+    int64_t nTimePaid;
+    if (dnpayments.GetLastPaid(dnpayee, nMinBlockHeight, pindex->nHeight, nBlockPaid, nTimePaid)) {
+        nBlockLastPaid = nBlockPaid;
+        nTimeLastPaid = nTimePaid;
+        LogPrint("dynode", "CDynode::UpdateLastPaidBlock -- searching for block with payment to %s -- found new %d\n", outpoint.ToStringShort(), nBlockLastPaid);
+        return;
     }
 
     // Last payment for this Dynode wasn't found in latest dnpayments blocks
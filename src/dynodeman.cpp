@@ -86,6 +86,7 @@ bool CDynodeMan::Add(CDynode& dn)
     LogPrint("dynode", "CDynodeMan::Add -- Adding new Dynode: addr=%s, %i now\n", dn.addr.ToString(), size() + 1);
     mapDynodes[dn.outpoint] = dn;
     fDynodesAdded = true;
+    InvalidateRankTables();
     return true;
 }
 
@@ -209,6 +210,7 @@ void CDynodeMan::CheckAndRemove(CConnman& connman)
                 it->second.FlagGovernanceItemsAsDirty();
                 mapDynodes.erase(it++);
                 fDynodesRemoved = true;
+                InvalidateRankTables();
             } else {
                 bool fAsk = (nAskForDnbRecovery > 0) &&
                             dynodeSync.IsSynced() &&
@@ -364,6 +366,7 @@ void CDynodeMan::Clear()
 {
     LOCK(cs);
     mapDynodes.clear();
+    InvalidateRankTables();
     mAskedUsForDynodeList.clear();
     mWeAskedForDynodeList.clear();
     mWeAskedForDynodeListEntry.clear();
@@ -668,6 +671,57 @@ bool CDynodeMan::GetDynodeScores(const uint256& nBlockHash, CDynodeMan::score_pa
     return !vecDynodeScoresRet.empty();
 }
 
+const CDynodeMan::CDynodeRankTable* CDynodeMan::GetRankTable(const uint256& nBlockHash, int nMinProtocol)
+{
+    AssertLockHeld(cs);
+
+    // Tables built before the list was (re)synced may miss Dynodes
+    if (!dynodeSync.IsDynodeListSynced()) {
+        InvalidateRankTables();
+        return nullptr;
+    }
+
+    const std::pair<uint256, int> key = std::make_pair(nBlockHash, nMinProtocol);
+    const auto it = mapRankTables.find(key);
+    if (it != mapRankTables.end())
+        return &it->second;
+
+    score_pair_vec_t vecDynodeScores;
+    if (!GetDynodeScores(nBlockHash, vecDynodeScores, nMinProtocol))
+        return nullptr;
+
+    if (listRankTableKeys.size() >= MAX_RANK_TABLES) {
+        mapRankTables.erase(listRankTableKeys.front());
+        listRankTableKeys.pop_front();
+    }
+
+    CDynodeRankTable& table = mapRankTables[key];
+    listRankTableKeys.push_back(key);
+    table.vecOutpoints.reserve(vecDynodeScores.size());
+    table.mapRanks.reserve(vecDynodeScores.size());
+    int nRank = 0;
+    for (const auto& scorePair : vecDynodeScores) {
+        nRank++;
+        table.vecOutpoints.push_back(scorePair.second->outpoint);
+        table.mapRanks.emplace(scorePair.second->outpoint, nRank);
+    }
+
+    return &table;
+}
+
+void CDynodeMan::InvalidateRankTables()
+{
+    LOCK(cs);
+    mapRankTables.clear();
+    listRankTableKeys.clear();
+}
+
+size_t CDynodeMan::CountRankTables()
+{
+    LOCK(cs);
+    return mapRankTables.size();
+}
+
 bool CDynodeMan::GetDynodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight, int nMinProtocol)
 {
     nRankRet = -1;
@@ -684,20 +738,25 @@ bool CDynodeMan::GetDynodeRank(const COutPoint& outpoint, int& nRankRet, int nBl
 
     LOCK(cs);
 
-    score_pair_vec_t vecDynodeScores;
-    if (!GetDynodeScores(nBlockHash, vecDynodeScores, nMinProtocol))
+    const CDynodeRankTable* pRankTable = GetRankTable(nBlockHash, nMinProtocol);
+    if (!pRankTable)
         return false;
 
-    int nRank = 0;
-    for (const auto& scorePair : vecDynodeScores) {
-        nRank++;
-        if (scorePair.second->outpoint == outpoint) {
-            nRankRet = nRank;
-            return true;
-        }
+    if (pRankTable->mapRanks.count(outpoint) && !mapDynodes.count(outpoint)) {
+        // The table outlived this Dynode, so it is stale: rebuild it
+        LogPrint("dynode", "CDynodeMan::%s -- stale rank table, Dynode %s is gone\n", __func__, outpoint.ToStringShort());
+        InvalidateRankTables();
+        pRankTable = GetRankTable(nBlockHash, nMinProtocol);
+        if (!pRankTable)
+            return false;
     }
 
-    return false;
+    const auto it = pRankTable->mapRanks.find(outpoint);
+    if (it == pRankTable->mapRanks.end())
+        return false;
+
+    nRankRet = it->second;
+    return true;
 }
 
 bool CDynodeMan::GetDynodeRanks(CDynodeMan::rank_pair_vec_t& vecDynodeRanksRet, int nBlockHeight, int nMinProtocol)
@@ -716,14 +775,28 @@ bool CDynodeMan::GetDynodeRanks(CDynodeMan::rank_pair_vec_t& vecDynodeRanksRet,
 
     LOCK(cs);
 
-    score_pair_vec_t vecDynodeScores;
-    if (!GetDynodeScores(nBlockHash, vecDynodeScores, nMinProtocol))
+    const CDynodeRankTable* pRankTable = GetRankTable(nBlockHash, nMinProtocol);
+    if (!pRankTable)
         return false;
 
+    const bool fStale = std::any_of(pRankTable->vecOutpoints.begin(), pRankTable->vecOutpoints.end(),
+        [this](const COutPoint& outpoint) { return !mapDynodes.count(outpoint); });
+    if (fStale) {
+        // The table outlived one of its Dynodes, rebuild it
+        LogPrint("dynode", "CDynodeMan::%s -- stale rank table\n", __func__);
+        InvalidateRankTables();
+        pRankTable = GetRankTable(nBlockHash, nMinProtocol);
+        if (!pRankTable)
+            return false;
+    }
+
+    vecDynodeRanksRet.reserve(pRankTable->vecOutpoints.size());
     int nRank = 0;
-    for (const auto& scorePair : vecDynodeScores) {
-        nRank++;
-        vecDynodeRanksRet.push_back(std::make_pair(nRank, *scorePair.second));
+    for (const COutPoint& outpoint : pRankTable->vecOutpoints) {
+        const auto it = mapDynodes.find(outpoint);
+        if (it == mapDynodes.end())
+            continue;
+        vecDynodeRanksRet.push_back(std::make_pair(++nRank, it->second));
     }
 
     return true;
@@ -1655,6 +1728,9 @@ void CDynodeMan::UpdateLastPaid(const CBlockIndex* pindex)
     LogPrint("dynode", "CDynodeMan::UpdateLastPaid -- nCachedBlockHeight=%d, nLastRunBlockHeight=%d, nMaxBlocksToScanBack=%d\n",
         nCachedBlockHeight, nLastRunBlockHeight, nMaxBlocksToScanBack);
 
+    // Payments are indexed as blocks connect, voted blocks from before startup are read from disk
+    dnpayments.LoadLastPaidIndex(pindex);
+
     for (auto& dnpair : mapDynodes) {
         dnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
     }
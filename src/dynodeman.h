@@ -6,9 +6,13 @@
 #ifndef DYNAMIC_DYNODEMAN_H
 #define DYNAMIC_DYNODEMAN_H
 
+#include "coins.h"
 #include "dynode.h"
 #include "sync.h"
 
+#include <list>
+#include <unordered_map>
+
 class CDynodeMan;
 class CConnman;
 
@@ -41,6 +45,8 @@ private:
     static const int DNB_RECOVERY_RETRY_SECONDS = 3 * 60 * 60;
     // the minimun active Dynodes before using InstandSend
     static const int INSTANTSEND_MIN_ACTIVE_DYNODE_COUNT = 25;
+    // rank tables kept for the most recent (block hash, min protocol) pairs
+    static const size_t MAX_RANK_TABLES = 8;
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
 
@@ -77,11 +83,23 @@ private:
 
     int64_t nLastSentinelPingTime;
 
+    /// Dynodes sorted by score for one block hash and minimum protocol, and the rank of each
+    struct CDynodeRankTable {
+        std::vector<COutPoint> vecOutpoints;
+        std::unordered_map<COutPoint, int, SaltedOutpointHasher> mapRanks;
+    };
+
+    // (block hash, min protocol) -> rank table, cleared whenever the Dynode list changes
+    std::map<std::pair<uint256, int>, CDynodeRankTable> mapRankTables;
+    // keys of mapRankTables, oldest first
+    std::list<std::pair<uint256, int> > listRankTableKeys;
+
     friend class CDynodeSync;
     /// Find an entry
     CDynode* Find(const COutPoint& outpoint);
 
     bool GetDynodeScores(const uint256& nBlockHash, score_pair_vec_t& vecDynodeScoresRet, int nMinProtocol = 0);
+    const CDynodeRankTable* GetRankTable(const uint256& nBlockHash, int nMinProtocol);
 
     void SyncSingle(CNode* pnode, const COutPoint& outpoint, CConnman& connman);
     void SyncAll(CNode* pnode, CConnman& connman);
@@ -127,6 +145,9 @@ public:
         if (ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        if (ser_action.ForRead()) {
+            InvalidateRankTables();
+        }
     }
 
     CDynodeMan();
@@ -185,6 +206,10 @@ public:
 
     bool GetDynodeRanks(rank_pair_vec_t& vecDynodeRanksRet, int nBlockHeight = -1, int nMinProtocol = 0);
     bool GetDynodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight = -1, int nMinProtocol = 0);
+    /// Drop the cached ranks, to be called when Dynodes are added or removed or change protocol version
+    void InvalidateRankTables();
+    /// Number of cached rank tables
+    size_t CountRankTables();
 
     void ProcessDynodeConnections(CConnman& connman);
     std::pair<CService, std::set<uint256> > PopScheduledDnbRequestConnection();
@@ -7,9 +7,11 @@
 #include "bdap/utils.h"
 #include "chain.h"
 #include "core_io.h"
+#include "crypto/sha256.h"
 #include "keepass.h"
 #include "net.h"
 #include "netbase.h"
+#include "random.h"
 #include "timedata.h"
 #include "txmempool.h"
 #include "util.h"
@@ -20,12 +22,90 @@
 #include "wallet/wallet.h"
 #include "wallet/walletdb.h"
 
+#include <boost/thread.hpp>
+
 CFluid fluid;
 
 #ifdef ENABLE_WALLET
 extern CWallet* pwalletMain;
 #endif //ENABLE_WALLET
 
+namespace
+{
+/**
+ * Signers recovered from fluid consent token signatures, to avoid recovering
+ * the public key of every sovereign signature each time the token is checked
+ * (memory pool, block template, block connection).
+ *
+ * Like CSignatureCache, entries are SHA256(nonce || message hash || signature)
+ * so they can be compared without blinding. Each entry may sit in one of two
+ * slots of a fixed table; when both are taken the older occupant is replaced,
+ * so the cache never grows.
+ */
+class CFluidSignatureCache
+{
+private:
+    static const size_t SLOTS = 4096;
+
+    struct CSlot {
+        uint256 entry;
+        CKeyID signer;
+        uint64_t nSequence;
+    };
+
+    uint256 nonce;
+    std::vector<CSlot> vSlots;
+    uint64_t nNextSequence;
+    boost::shared_mutex cs_fluidsigcache;
+
+    static size_t Slot(const uint256& entry, const int n)
+    {
+        uint32_t u;
+        std::memcpy(&u, entry.begin() + 4 * n, 4);
+        return u % SLOTS;
+    }
+
+public:
+    CFluidSignatureCache() : vSlots(SLOTS), nNextSequence(1)
+    {
+        GetRandBytes(nonce.begin(), 32);
+        for (CSlot& slot : vSlots)
+            slot.nSequence = 0;
+    }
+
+    void ComputeEntry(uint256& entry, const uint256& hash, const std::vector<unsigned char>& vchSig)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(hash.begin(), 32).Write(vchSig.data(), vchSig.size()).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry, CKeyID& signer)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_fluidsigcache);
+        for (int n = 0; n < 2; n++) {
+            const CSlot& slot = vSlots[Slot(entry, n)];
+            if (slot.nSequence != 0 && slot.entry == entry) {
+                signer = slot.signer;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Set(const uint256& entry, const CKeyID& signer)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_fluidsigcache);
+        CSlot& first = vSlots[Slot(entry, 0)];
+        CSlot& second = vSlots[Slot(entry, 1)];
+        CSlot& slot = (first.entry == entry || first.nSequence <= second.nSequence) ? first : second;
+        slot.entry = entry;
+        slot.signer = signer;
+        slot.nSequence = nNextSequence++;
+    }
+};
+
+static CFluidSignatureCache fluidSignatureCache;
+} // namespace
+
 bool IsTransactionFluid(const CScript& txOut)
 {
     return (txOut.IsProtocolInstruction(MINT_TX) || txOut.IsProtocolInstruction(DYNODE_MODFIY_TX) || txOut.IsProtocolInstruction(MINING_MODIFY_TX) || txOut.IsProtocolInstruction(BDAP_REVOKE_TX));
@@ -190,21 +270,11 @@ bool CFluid::CheckFluidOperationScript(const CScript& fluidScriptPubKey, const i
 /** Checks whether fluid transaction is in the memory pool already */
 bool CFluid::CheckIfExistsInMemPool(const CTxMemPool& pool, const CScript& fluidScriptPubKey, std::string& errorMessage)
 {
-    for (const CTxMemPoolEntry& e : pool.mapTx) {
-        const CTransaction& tx = e.GetTx();
-        for (const CTxOut& txOut : tx.vout) {
-            if (IsTransactionFluid(txOut.scriptPubKey)) {
-                std::string strNewFluidScript = ScriptToAsmStr(fluidScriptPubKey);
-                std::string strMemPoolFluidScript = ScriptToAsmStr(txOut.scriptPubKey);
-                std::string strNewTxWithoutOpCode = GetRidOfScriptStatement(strNewFluidScript);
-                std::string strMemPoolTxWithoutOpCode = GetRidOfScriptStatement(strMemPoolFluidScript);
-                if (strNewTxWithoutOpCode == strMemPoolTxWithoutOpCode) {
-                    errorMessage = "CheckIfExistsInMemPool: fluid transaction is already in the memory pool!";
-                    LogPrintf("CheckIfExistsInMemPool: fluid transaction, %s is already in the memory pool! %s\n", tx.GetHash().ToString(), strNewTxWithoutOpCode);
-                    return true;
-                }
-            }
-        }
+    uint256 txHash;
+    if (pool.getFluidIndex(fluidScriptPubKey, txHash)) {
+        errorMessage = "CheckIfExistsInMemPool: fluid transaction is already in the memory pool!";
+        LogPrintf("CheckIfExistsInMemPool: fluid transaction, %s is already in the memory pool! %s\n", txHash.ToString(), ScriptToAsmStr(fluidScriptPubKey));
+        return true;
     }
 
     return false;
@@ -260,22 +330,28 @@ bool CFluid::CheckIfQuorumExists(const std::string& consentToken, std::string& m
     } else
         fluidSovereigns = InitialiseAddresses();
 
+    // The signers don't depend on the address they are compared with
+    CDynamicAddress vSigners[3];
+    bool fSigned[3];
+    for (int i = 0; i < 3; i++)
+        fSigned[i] = GenericVerifyInstruction(consentToken, vSigners[i], message, i + 1);
+
     for (const std::string& address : fluidSovereigns) {
-        CDynamicAddress attemptKey, xAddress(address);
+        CDynamicAddress xAddress(address);
 
         if (!xAddress.IsValid())
             return false;
 
-        if (GenericVerifyInstruction(consentToken, attemptKey, message, 1) && xAddress == attemptKey) {
-            keyOne = std::make_pair(attemptKey.ToString(), true);
+        if (fSigned[0] && xAddress == vSigners[0]) {
+            keyOne = std::make_pair(vSigners[0], true);
         }
 
-        if (GenericVerifyInstruction(consentToken, attemptKey, message, 2) && xAddress == attemptKey) {
-            keyTwo = std::make_pair(attemptKey.ToString(), true);
+        if (fSigned[1] && xAddress == vSigners[1]) {
+            keyTwo = std::make_pair(vSigners[1], true);
         }
 
-        if (GenericVerifyInstruction(consentToken, attemptKey, message, 3) && xAddress == attemptKey) {
-            keyThree = std::make_pair(attemptKey.ToString(), true);
+        if (fSigned[2] && xAddress == vSigners[2]) {
+            keyThree = std::make_pair(vSigners[2], true);
         }
     }
 
@@ -414,15 +490,22 @@ CDynamicAddress CFluid::GetAddressFromDigestSignature(const std::string& digestS
     CHashWriter ss(SER_GETHASH, 0);
     ss << strMessageMagic;
     ss << messageTokenKey;
-
-    CPubKey pubkey;
-
-    if (!pubkey.RecoverCompact(ss.GetHash(), vchSig)) {
-        LogPrintf("GetAddressFromDigestSignature(): Public Key Recovery Failed! Hash: %s\n", ss.GetHash().ToString());
-        return nullptr;
+    const uint256 hash = ss.GetHash();
+
+    uint256 entry;
+    CKeyID signer;
+    fluidSignatureCache.ComputeEntry(entry, hash, vchSig);
+    if (!fluidSignatureCache.Get(entry, signer)) {
+        CPubKey pubkey;
+        if (!pubkey.RecoverCompact(hash, vchSig)) {
+            LogPrintf("GetAddressFromDigestSignature(): Public Key Recovery Failed! Hash: %s\n", hash.ToString());
+            return nullptr;
+        }
+        signer = pubkey.GetID();
+        fluidSignatureCache.Set(entry, signer);
     }
     CDynamicAddress newAddress;
-    newAddress.Set(pubkey.GetID());
+    newAddress.Set(signer);
     return newAddress;
 }
 
@@ -654,6 +737,23 @@ std::vector<unsigned char> FluidScriptToCharVector(const CScript& fluidScript)
     return vchFromString(fluidOperationString);
 }
 
+/** Hashes the operand that follows the fluid operation code, the part two fluid scripts must not share */
+bool GetFluidPayloadHash(const CScript& fluidScript, uint256& hash)
+{
+    CScript::const_iterator pc = fluidScript.begin();
+    opcodetype opcode;
+    std::vector<unsigned char> vchPayload;
+    if (!fluidScript.GetOp(pc, opcode) || !fluidScript.GetOp(pc, opcode, vchPayload))
+        return false;
+
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << vchPayload;
+    if (opcode > OP_PUSHDATA4)
+        ss << (unsigned char)opcode;
+    hash = ss.GetHash();
+    return true;
+}
+
 bool CFluid::ExtractTimestampWithAddresses(const std::string& strOpCode, const CScript& fluidScript, int64_t& nTimeStamp, std::vector<std::vector<unsigned char>>& vSovereignAddresses)
 {
     std::string fluidOperationString = ScriptToAsmStr(fluidScript);
@@ -88,6 +88,7 @@ int GetFluidOpCode(const CScript& fluidScript);
 std::vector<unsigned char> CharVectorFromString(const std::string& str);
 std::string StringFromCharVector(const std::vector<unsigned char>& vch);
 std::vector<unsigned char> FluidScriptToCharVector(const CScript& fluidScript);
+bool GetFluidPayloadHash(const CScript& fluidScript, uint256& hash);
 bool GetFluidBlock(const CBlockIndex* pblockindex, CBlock& block);
 
 extern CFluid fluid;
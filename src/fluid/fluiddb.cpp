@@ -8,6 +8,7 @@
 #include "fluidmining.h"
 #include "fluidmint.h"
 #include "fluidsovereign.h"
+#include "primitives/block.h"
 
 CAmount GetFluidDynodeReward(const int nHeight)
 {
@@ -163,6 +164,27 @@ bool GetLastFluidSovereignAddressStrings(std::vector<std::string>& sovereignAddr
     return true;
 }
 
+/** Removes the reward, mint and sovereign records of a block that is disconnected from the chain */
+void RemoveFluidRecords(const CBlock& block, const int nHeight)
+{
+    for (const CTransactionRef& tx : block.vtx) {
+        CScript scriptFluid;
+        if (!IsTransactionFluid(*tx, scriptFluid))
+            continue;
+
+        int OpCode = GetFluidOpCode(scriptFluid);
+        if (OpCode == OP_REWARD_DYNODE && CheckFluidDynodeDB()) {
+            pFluidDynodeDB->EraseFluidDynodeEntry(FluidScriptToCharVector(scriptFluid), nHeight);
+        } else if (OpCode == OP_REWARD_MINING && CheckFluidMiningDB()) {
+            pFluidMiningDB->EraseFluidMiningEntry(FluidScriptToCharVector(scriptFluid), nHeight);
+        } else if (OpCode == OP_MINT && CheckFluidMintDB()) {
+            pFluidMintDB->EraseFluidMintEntry(FluidScriptToCharVector(scriptFluid), nHeight);
+        } else if (OpCode == OP_SWAP_SOVEREIGN_ADDRESS && CheckFluidSovereignDB()) {
+            pFluidSovereignDB->EraseFluidSovereignEntry(FluidScriptToCharVector(scriptFluid), nHeight);
+        }
+    }
+}
+
 /** Checks whether 3 of 5 sovereign addresses signed the token in the script to meet the quorum requirements */
 bool CheckSignatureQuorum(const std::vector<unsigned char>& vchFluidScript, std::string& errMessage, bool individual)
 {
@@ -179,23 +201,32 @@ bool CheckSignatureQuorum(const std::vector<unsigned char>& vchFluidScript, std:
     keyTwo.second = false;
     keyThree.second = false;
 
+    if (fluidSovereigns.empty())
+        return false;
+
+    // The signers don't depend on the sovereign address they are compared with
+    CFluid fluid;
+    CDynamicAddress vSigners[3];
+    bool fSigned[3];
+    for (int i = 0; i < 3; i++)
+        fSigned[i] = fluid.GenericVerifyInstruction(consentToken, vSigners[i], errMessage, i + 1);
+
     for (const std::string& sovereignAddress : fluidSovereigns) {
-        CDynamicAddress attemptKey;
         CDynamicAddress xKey(sovereignAddress);
 
         if (!xKey.IsValid())
             return false;
-        CFluid fluid;
-        if (fluid.GenericVerifyInstruction(consentToken, attemptKey, errMessage, 1) && xKey == attemptKey) {
-            keyOne = std::make_pair(attemptKey.ToString(), true);
+
+        if (fSigned[0] && xKey == vSigners[0]) {
+            keyOne = std::make_pair(vSigners[0], true);
         }
 
-        if (fluid.GenericVerifyInstruction(consentToken, attemptKey, errMessage, 2) && xKey == attemptKey) {
-            keyTwo = std::make_pair(attemptKey.ToString(), true);
+        if (fSigned[1] && xKey == vSigners[1]) {
+            keyTwo = std::make_pair(vSigners[1], true);
         }
 
-        if (fluid.GenericVerifyInstruction(consentToken, attemptKey, errMessage, 3) && xKey == attemptKey) {
-            keyThree = std::make_pair(attemptKey.ToString(), true);
+        if (fSigned[2] && xKey == vSigners[2]) {
+            keyThree = std::make_pair(vSigners[2], true);
         }
     }
 
@@ -5,6 +5,7 @@
 
 #include "amount.h"
 
+class CBlock;
 class CDynamicAddress;
 class CFluidDynode;
 class CFluidMining;
@@ -20,6 +21,7 @@ bool GetAllFluidMiningRecords(std::vector<CFluidMining>& miningEntries);
 bool GetAllFluidMintRecords(std::vector<CFluidMint>& mintEntries);
 bool GetAllFluidSovereignRecords(std::vector<CFluidSovereign>& sovereignEntries);
 bool GetLastFluidSovereignAddressStrings(std::vector<std::string>& sovereignAddresses);
+void RemoveFluidRecords(const CBlock& block, const int nHeight);
 bool CheckSignatureQuorum(const std::vector<unsigned char>& vchFluidScript, std::string& errMessage, bool individual = false);
 
 #endif // FLUID_DB_H
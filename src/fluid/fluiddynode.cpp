@@ -102,15 +102,31 @@ bool CFluidDynodeDB::AddFluidDynodeEntry(const CFluidDynode& entry, const int op
     {
         LOCK(cs_fluid_dynode);
         writeState = Write(make_pair(std::string("script"), entry.FluidScript), entry) && Write(make_pair(std::string("txid"), entry.txHash), entry.FluidScript);
+        if (writeState && index.IsLoaded())
+            index.Add(entry.FluidScript, entry);
     }
 
     return writeState;
 }
 
-bool CFluidDynodeDB::GetLastFluidDynodeRecord(CFluidDynode& returnEntry, const int nHeight)
+bool CFluidDynodeDB::EraseFluidDynodeEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight)
 {
     LOCK(cs_fluid_dynode);
-    returnEntry.SetNull();
+    CFluidDynode entry;
+    if (!CDBWrapper::Read(make_pair(std::string("script"), vchFluidScript), entry) || (int)entry.nHeight != nHeight)
+        return false;
+
+    if (index.IsLoaded())
+        index.Erase(vchFluidScript);
+    return Erase(make_pair(std::string("script"), vchFluidScript)) && Erase(make_pair(std::string("txid"), entry.txHash));
+}
+
+bool CFluidDynodeDB::LoadIndex()
+{
+    AssertLockHeld(cs_fluid_dynode);
+    if (index.IsLoaded())
+        return true;
+
     std::pair<std::string, std::vector<unsigned char> > key;
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
     pcursor->SeekToFirst();
@@ -119,19 +135,36 @@ bool CFluidDynodeDB::GetLastFluidDynodeRecord(CFluidDynode& returnEntry, const i
         CFluidDynode entry;
         try {
             if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-                if (entry.IsNull()) {
-                    return false;
-                }
-                if (entry.nHeight > returnEntry.nHeight && (int)(entry.nHeight + 1) < nHeight) {
-                    returnEntry = entry;
-                }
+                if (!pcursor->GetValue(entry))
+                    entry.SetNull();
+                index.Add(key.second, entry);
             }
             pcursor->Next();
         } catch (std::exception& e) {
+            index.Clear();
             return error("%s() : deserialize error", __PRETTY_FUNCTION__);
         }
     }
+    index.SetLoaded();
+    LogPrint("fluid", "%s -- loaded %u records\n", __func__, index.size());
+    return true;
+}
+
+bool CFluidDynodeDB::GetLastFluidDynodeRecord(CFluidDynode& returnEntry, const int nHeight)
+{
+    LOCK(cs_fluid_dynode);
+    returnEntry.SetNull();
+    if (!LoadIndex())
+        return false;
+
+    // A null record in the database disables the fluid reward
+    if (index.HasNullRecords())
+        return false;
+
+    // The latest record with (record height + 1) < nHeight
+    if (nHeight > 1)
+        index.GetLastBelow(nHeight - 1, returnEntry);
+
     return true;
 }
 
@@ -162,22 +195,10 @@ bool CFluidDynodeDB::GetAllFluidDynodeRecords(std::vector<CFluidDynode>& entries
 bool CFluidDynodeDB::IsEmpty()
 {
     LOCK(cs_fluid_dynode);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->SeekToFirst();
-    if (pcursor->Valid()) {
-        CFluidDynode entry;
-        try {
-            std::pair<std::string, std::vector<unsigned char> > key;
-            if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-            }
-            pcursor->Next();
-        } catch (std::exception& e) {
-            return true;
-        }
-        return false;
-    }
-    return true;
+    if (!LoadIndex())
+        return true;
+
+    return index.IsEmpty();
 }
 
 bool CFluidDynodeDB::RecordExists(const std::vector<unsigned char>& vchFluidScript)
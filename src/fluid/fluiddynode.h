@@ -5,6 +5,7 @@
 
 #include "amount.h"
 #include "dbwrapper.h"
+#include "fluid/fluidindex.h"
 #include "serialize.h"
 
 #include "sync.h"
@@ -114,10 +115,16 @@ class CFluidDynodeDB : public CDBWrapper
 public:
     CFluidDynodeDB(size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate);
     bool AddFluidDynodeEntry(const CFluidDynode& entry, const int op);
+    bool EraseFluidDynodeEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight);
     bool GetLastFluidDynodeRecord(CFluidDynode& returnEntry, const int nHeight);
     bool GetAllFluidDynodeRecords(std::vector<CFluidDynode>& entries);
     bool IsEmpty();
     bool RecordExists(const std::vector<unsigned char>& vchFluidScript);
+
+private:
+    CFluidRecordIndex<CFluidDynode> index;
+
+    bool LoadIndex();
 };
 
 bool GetFluidDynodeData(const CScript& scriptPubKey, CFluidDynode& entry);
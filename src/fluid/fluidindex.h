@@ -0,0 +1,114 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+
+#ifndef FLUID_INDEX_H
+#define FLUID_INDEX_H
+
+#include "clientversion.h"
+#include "streams.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Height ordered copy of the records in one fluid database.
+ *
+ * The databases are keyed by fluid script, so finding the latest record took
+ * a scan of the whole database. The index is loaded from the database once and
+ * then follows its writes and erases. Records at the same height are kept in
+ * database key order, the order the scan saw them in, so ties resolve the same.
+ */
+template <typename T>
+class CFluidRecordIndex
+{
+private:
+    // (height, database key) -> record
+    typedef std::map<std::pair<unsigned int, std::vector<unsigned char> >, T> RecordMap;
+
+    RecordMap mapRecords;
+    // fluid script -> height of its record
+    std::map<std::vector<unsigned char>, unsigned int> mapHeights;
+    size_t nNullRecords = 0;
+    bool fLoaded = false;
+
+    static std::vector<unsigned char> DatabaseKey(const std::vector<unsigned char>& vchFluidScript)
+    {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << std::make_pair(std::string("script"), vchFluidScript);
+        return std::vector<unsigned char>(ssKey.begin(), ssKey.end());
+    }
+
+public:
+    bool IsLoaded() const { return fLoaded; }
+    void SetLoaded() { fLoaded = true; }
+
+    void Clear()
+    {
+        mapRecords.clear();
+        mapHeights.clear();
+        nNullRecords = 0;
+        fLoaded = false;
+    }
+
+    /** Adds the record stored under vchFluidScript, replacing the previous one like a database write */
+    void Add(const std::vector<unsigned char>& vchFluidScript, const T& entry)
+    {
+        Erase(vchFluidScript);
+        mapRecords.insert(std::make_pair(std::make_pair(entry.nHeight, DatabaseKey(vchFluidScript)), entry));
+        mapHeights[vchFluidScript] = entry.nHeight;
+        if (entry.IsNull())
+            nNullRecords++;
+    }
+
+    void Erase(const std::vector<unsigned char>& vchFluidScript)
+    {
+        std::map<std::vector<unsigned char>, unsigned int>::iterator it = mapHeights.find(vchFluidScript);
+        if (it == mapHeights.end())
+            return;
+
+        typename RecordMap::iterator itRecord = mapRecords.find(std::make_pair(it->second, DatabaseKey(vchFluidScript)));
+        if (itRecord != mapRecords.end()) {
+            if (itRecord->second.IsNull())
+                nNullRecords--;
+            mapRecords.erase(itRecord);
+        }
+        mapHeights.erase(it);
+    }
+
+    bool IsEmpty() const { return mapRecords.empty(); }
+    bool HasNullRecords() const { return nNullRecords > 0; }
+    size_t size() const { return mapRecords.size(); }
+
+    /** Gets the record with the highest height above 0 */
+    bool GetLast(T& entry) const
+    {
+        if (mapRecords.empty())
+            return false;
+
+        return GetFirstAtHeight(mapRecords.rbegin()->first.first, entry);
+    }
+
+    /** Gets the record with the highest height above 0 and below nMaxHeight */
+    bool GetLastBelow(const unsigned int nMaxHeight, T& entry) const
+    {
+        typename RecordMap::const_iterator it = mapRecords.lower_bound(std::make_pair(nMaxHeight, std::vector<unsigned char>()));
+        if (it == mapRecords.begin())
+            return false;
+
+        --it;
+        return GetFirstAtHeight(it->first.first, entry);
+    }
+
+private:
+    bool GetFirstAtHeight(const unsigned int nHeight, T& entry) const
+    {
+        if (nHeight == 0)
+            return false;
+
+        entry = mapRecords.lower_bound(std::make_pair(nHeight, std::vector<unsigned char>()))->second;
+        return true;
+    }
+};
+
+#endif // FLUID_INDEX_H
@@ -102,15 +102,31 @@ bool CFluidMiningDB::AddFluidMiningEntry(const CFluidMining& entry, const int op
     {
         LOCK(cs_fluid_mining);
         writeState = Write(make_pair(std::string("script"), entry.FluidScript), entry) && Write(make_pair(std::string("txid"), entry.txHash), entry.FluidScript);
+        if (writeState && index.IsLoaded())
+            index.Add(entry.FluidScript, entry);
     }
 
     return writeState;
 }
 
-bool CFluidMiningDB::GetLastFluidMiningRecord(CFluidMining& returnEntry, const int nHeight)
+bool CFluidMiningDB::EraseFluidMiningEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight)
 {
     LOCK(cs_fluid_mining);
-    returnEntry.SetNull();
+    CFluidMining entry;
+    if (!CDBWrapper::Read(make_pair(std::string("script"), vchFluidScript), entry) || (int)entry.nHeight != nHeight)
+        return false;
+
+    if (index.IsLoaded())
+        index.Erase(vchFluidScript);
+    return Erase(make_pair(std::string("script"), vchFluidScript)) && Erase(make_pair(std::string("txid"), entry.txHash));
+}
+
+bool CFluidMiningDB::LoadIndex()
+{
+    AssertLockHeld(cs_fluid_mining);
+    if (index.IsLoaded())
+        return true;
+
     std::pair<std::string, std::vector<unsigned char> > key;
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
     pcursor->SeekToFirst();
@@ -119,19 +135,36 @@ bool CFluidMiningDB::GetLastFluidMiningRecord(CFluidMining& returnEntry, const i
         CFluidMining entry;
         try {
             if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-                if (entry.IsNull()) {
-                    return false;
-                }
-                if (entry.nHeight > returnEntry.nHeight && (int)(entry.nHeight + 1) < nHeight) {
-                    returnEntry = entry;
-                }
+                if (!pcursor->GetValue(entry))
+                    entry.SetNull();
+                index.Add(key.second, entry);
             }
             pcursor->Next();
         } catch (std::exception& e) {
+            index.Clear();
             return error("%s() : deserialize error", __PRETTY_FUNCTION__);
         }
     }
+    index.SetLoaded();
+    LogPrint("fluid", "%s -- loaded %u records\n", __func__, index.size());
+    return true;
+}
+
+bool CFluidMiningDB::GetLastFluidMiningRecord(CFluidMining& returnEntry, const int nHeight)
+{
+    LOCK(cs_fluid_mining);
+    returnEntry.SetNull();
+    if (!LoadIndex())
+        return false;
+
+    // A null record in the database disables the fluid reward
+    if (index.HasNullRecords())
+        return false;
+
+    // The latest record with (record height + 1) < nHeight
+    if (nHeight > 1)
+        index.GetLastBelow(nHeight - 1, returnEntry);
+
     return true;
 }
 
@@ -162,22 +195,10 @@ bool CFluidMiningDB::GetAllFluidMiningRecords(std::vector<CFluidMining>& entries
 bool CFluidMiningDB::IsEmpty()
 {
     LOCK(cs_fluid_mining);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->SeekToFirst();
-    if (pcursor->Valid()) {
-        CFluidMining entry;
-        try {
-            std::pair<std::string, std::vector<unsigned char> > key;
-            if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-            }
-            pcursor->Next();
-        } catch (std::exception& e) {
-            return true;
-        }
-        return false;
-    }
-    return true;
+    if (!LoadIndex())
+        return true;
+
+    return index.IsEmpty();
 }
 
 bool CFluidMiningDB::RecordExists(const std::vector<unsigned char>& vchFluidScript)
@@ -5,6 +5,7 @@
 
 #include "amount.h"
 #include "dbwrapper.h"
+#include "fluid/fluidindex.h"
 #include "serialize.h"
 
 #include "sync.h"
@@ -114,10 +115,16 @@ class CFluidMiningDB : public CDBWrapper
 public:
     CFluidMiningDB(size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate);
     bool AddFluidMiningEntry(const CFluidMining& entry, const int op);
+    bool EraseFluidMiningEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight);
     bool GetLastFluidMiningRecord(CFluidMining& returnEntry, const int nHeight);
     bool GetAllFluidMiningRecords(std::vector<CFluidMining>& entries);
     bool IsEmpty();
     bool RecordExists(const std::vector<unsigned char>& vchFluidScript);
+
+private:
+    CFluidRecordIndex<CFluidMining> index;
+
+    bool LoadIndex();
 };
 
 bool GetFluidMiningData(const CScript& scriptPubKey, CFluidMining& entry);
@@ -111,15 +111,31 @@ bool CFluidMintDB::AddFluidMintEntry(const CFluidMint& entry, const int op)
     {
         LOCK(cs_fluid_mint);
         writeState = Write(make_pair(std::string("script"), entry.FluidScript), entry) && Write(make_pair(std::string("txid"), entry.txHash), entry.FluidScript);
+        if (writeState && index.IsLoaded())
+            index.Add(entry.FluidScript, entry);
     }
 
     return writeState;
 }
 
-bool CFluidMintDB::GetLastFluidMintRecord(CFluidMint& returnEntry)
+bool CFluidMintDB::EraseFluidMintEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight)
 {
     LOCK(cs_fluid_mint);
-    returnEntry.SetNull();
+    CFluidMint entry;
+    if (!CDBWrapper::Read(make_pair(std::string("script"), vchFluidScript), entry) || (int)entry.nHeight != nHeight)
+        return false;
+
+    if (index.IsLoaded())
+        index.Erase(vchFluidScript);
+    return Erase(make_pair(std::string("script"), vchFluidScript)) && Erase(make_pair(std::string("txid"), entry.txHash));
+}
+
+bool CFluidMintDB::LoadIndex()
+{
+    AssertLockHeld(cs_fluid_mint);
+    if (index.IsLoaded())
+        return true;
+
     std::pair<std::string, std::vector<unsigned char> > key;
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
     pcursor->SeekToFirst();
@@ -128,16 +144,29 @@ bool CFluidMintDB::GetLastFluidMintRecord(CFluidMint& returnEntry)
         CFluidMint entry;
         try {
             if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-                if (entry.nHeight > returnEntry.nHeight) {
-                    returnEntry = entry;
-                }
+                if (!pcursor->GetValue(entry))
+                    entry.SetNull();
+                index.Add(key.second, entry);
             }
             pcursor->Next();
         } catch (std::exception& e) {
+            index.Clear();
             return error("%s() : deserialize error", __PRETTY_FUNCTION__);
         }
     }
+    index.SetLoaded();
+    LogPrint("fluid", "%s -- loaded %u records\n", __func__, index.size());
+    return true;
+}
+
+bool CFluidMintDB::GetLastFluidMintRecord(CFluidMint& returnEntry)
+{
+    LOCK(cs_fluid_mint);
+    returnEntry.SetNull();
+    if (!LoadIndex())
+        return false;
+
+    index.GetLast(returnEntry);
     return true;
 }
 
@@ -168,22 +197,10 @@ bool CFluidMintDB::GetAllFluidMintRecords(std::vector<CFluidMint>& entries)
 bool CFluidMintDB::IsEmpty()
 {
     LOCK(cs_fluid_mint);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->SeekToFirst();
-    if (pcursor->Valid()) {
-        CFluidMint entry;
-        try {
-            std::pair<std::string, std::vector<unsigned char> > key;
-            if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-            }
-            pcursor->Next();
-        } catch (std::exception& e) {
-            return true;
-        }
-        return false;
-    }
-    return true;
+    if (!LoadIndex())
+        return true;
+
+    return index.IsEmpty();
 }
 
 bool CFluidMintDB::RecordExists(const std::vector<unsigned char>& vchFluidScript)
@@ -5,6 +5,7 @@
 
 #include "amount.h"
 #include "dbwrapper.h"
+#include "fluid/fluidindex.h"
 #include "serialize.h"
 
 #include "sync.h"
@@ -120,10 +121,16 @@ class CFluidMintDB : public CDBWrapper
 public:
     CFluidMintDB(size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate);
     bool AddFluidMintEntry(const CFluidMint& entry, const int op);
+    bool EraseFluidMintEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight);
     bool GetLastFluidMintRecord(CFluidMint& returnEntry);
     bool GetAllFluidMintRecords(std::vector<CFluidMint>& entries);
     bool IsEmpty();
     bool RecordExists(const std::vector<unsigned char>& vchFluidScript);
+
+private:
+    CFluidRecordIndex<CFluidMint> index;
+
+    bool LoadIndex();
 };
 
 bool GetFluidMintData(const CScript& scriptPubKey, CFluidMint& entry);
@@ -123,14 +123,30 @@ bool CFluidSovereignDB::AddFluidSovereignEntry(const CFluidSovereign& entry)
     {
         LOCK(cs_fluid_sovereign);
         writeState = Write(make_pair(std::string("script"), entry.FluidScript), entry) && Write(make_pair(std::string("txid"), entry.txHash), entry.FluidScript);
+        if (writeState && index.IsLoaded())
+            index.Add(entry.FluidScript, entry);
     }
     return writeState;
 }
 
-bool CFluidSovereignDB::GetLastFluidSovereignRecord(CFluidSovereign& returnEntry)
+bool CFluidSovereignDB::EraseFluidSovereignEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight)
 {
     LOCK(cs_fluid_sovereign);
-    returnEntry.SetNull();
+    CFluidSovereign entry;
+    if (!CDBWrapper::Read(make_pair(std::string("script"), vchFluidScript), entry) || (int)entry.nHeight != nHeight)
+        return false;
+
+    if (index.IsLoaded())
+        index.Erase(vchFluidScript);
+    return Erase(make_pair(std::string("script"), vchFluidScript)) && Erase(make_pair(std::string("txid"), entry.txHash));
+}
+
+bool CFluidSovereignDB::LoadIndex()
+{
+    AssertLockHeld(cs_fluid_sovereign);
+    if (index.IsLoaded())
+        return true;
+
     std::pair<std::string, std::vector<unsigned char> > key;
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
     pcursor->SeekToFirst();
@@ -139,16 +155,29 @@ bool CFluidSovereignDB::GetLastFluidSovereignRecord(CFluidSovereign& returnEntry
         CFluidSovereign entry;
         try {
             if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-                if (entry.nHeight > returnEntry.nHeight) {
-                    returnEntry = entry;
-                }
+                if (!pcursor->GetValue(entry))
+                    entry.SetNull();
+                index.Add(key.second, entry);
             }
             pcursor->Next();
         } catch (std::exception& e) {
+            index.Clear();
             return error("%s() : deserialize error", __PRETTY_FUNCTION__);
         }
     }
+    index.SetLoaded();
+    LogPrint("fluid", "%s -- loaded %u records\n", __func__, index.size());
+    return true;
+}
+
+bool CFluidSovereignDB::GetLastFluidSovereignRecord(CFluidSovereign& returnEntry)
+{
+    LOCK(cs_fluid_sovereign);
+    returnEntry.SetNull();
+    if (!LoadIndex())
+        return false;
+
+    index.GetLast(returnEntry);
     return true;
 }
 
@@ -179,22 +208,10 @@ bool CFluidSovereignDB::GetAllFluidSovereignRecords(std::vector<CFluidSovereign>
 bool CFluidSovereignDB::IsEmpty()
 {
     LOCK(cs_fluid_sovereign);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->SeekToFirst();
-    if (pcursor->Valid()) {
-        CFluidSovereign entry;
-        try {
-            std::pair<std::string, std::vector<unsigned char> > key;
-            if (pcursor->GetKey(key) && key.first == "script") {
-                pcursor->GetValue(entry);
-            }
-            pcursor->Next();
-        } catch (std::exception& e) {
-            return true;
-        }
-        return false;
-    }
-    return true;
+    if (!LoadIndex())
+        return true;
+
+    return index.IsEmpty();
 }
 
 bool CheckFluidSovereignDB()
@@ -5,6 +5,7 @@
 
 #include "amount.h"
 #include "dbwrapper.h"
+#include "fluid/fluidindex.h"
 #include "serialize.h"
 
 #include "sync.h"
@@ -100,12 +101,16 @@ class CFluidSovereignDB : public CDBWrapper
 public:
     CFluidSovereignDB(size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate);
     bool AddFluidSovereignEntry(const CFluidSovereign& entry);
+    bool EraseFluidSovereignEntry(const std::vector<unsigned char>& vchFluidScript, const int nHeight);
     bool GetLastFluidSovereignRecord(CFluidSovereign& returnEntry);
     bool GetAllFluidSovereignRecords(std::vector<CFluidSovereign>& entries);
     bool IsEmpty();
 
 private:
+    CFluidRecordIndex<CFluidSovereign> index;
+
     void InitEmpty();
+    bool LoadIndex();
 };
 bool GetFluidSovereignData(const CScript& scriptPubKey, CFluidSovereign& entry);
 bool GetFluidSovereignData(const CTransaction& tx, CFluidSovereign& entry, int& nOut);
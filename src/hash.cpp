@@ -12,6 +12,23 @@
 
 #include "pubkey.h"
 
+#include <assert.h>
+
+#ifdef WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0501
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h> // for mmap
+#endif
+
 
 inline uint32_t ROTL32(uint32_t x, int8_t r)
 {
@@ -113,6 +130,7 @@ CSipHasher::CSipHasher(uint64_t k0, uint64_t k1)
     v[2] = 0x6c7967656e657261ULL ^ k0;
     v[3] = 0x7465646279746573ULL ^ k1;
     count = 0;
+    tmp = 0;
 }
 
 CSipHasher& CSipHasher::Write(uint64_t data)
@@ -261,3 +279,162 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace
+{
+/** Context whose arena backs the Argon2d hash currently running on this thread */
+thread_local CArgon2dContext* pActiveArgon2dContext = nullptr;
+} // namespace
+
+CArgon2dContext::CArgon2dContext(bool fHugePagesIn)
+    : nNextArena(0), fHugePages(fHugePagesIn)
+{
+    for (Arena& arena : arenas) {
+        arena.pMemory = nullptr;
+        arena.nSize = 0;
+        arena.fHugePages = false;
+    }
+}
+
+CArgon2dContext::~CArgon2dContext()
+{
+    for (Arena& arena : arenas) {
+        FreeArena(arena);
+    }
+}
+
+uint256 CArgon2dContext::Hash(const void* input, const size_t size, const unsigned int hashPhase)
+{
+    uint256 hashResult;
+    if (HashMulti(&input, size, 1, hashPhase, &hashResult))
+        return hashResult;
+
+    // No arena could be reserved, let Argon2 allocate the memory itself
+    const int nResult = hashPhase == 2 ? Argon2d_Phase2_Hash(input, size, &hashResult) : Argon2d_Phase1_Hash(input, size, &hashResult);
+    // The unfilled hash is zero and would pass any proof of work check
+    assert(nResult == ARGON2_OK);
+    return hashResult;
+}
+
+bool CArgon2dContext::HashMulti(const void* const* inputs, const size_t size, const unsigned int count, const unsigned int hashPhase, uint256* hashes)
+{
+    assert(count > 0 && count <= MAX_MULTI_HASHES);
+    argon2_context contexts[MAX_MULTI_HASHES];
+    argon2_context* pcontexts[MAX_MULTI_HASHES];
+    // Block headers are public, there is nothing to wipe between two hashes
+    const uint32_t flags = DEFAULT_ARGON2_FLAG | ARGON2_FLAG_NO_WIPE_MEMORY;
+    for (unsigned int i = 0; i < count; i++) {
+        if (hashPhase == 2) {
+            Argon2d_Phase2_Context(contexts[i], inputs[i], size, &hashes[i], AllocateArena, ReleaseArena, flags);
+        } else {
+            Argon2d_Phase1_Context(contexts[i], inputs[i], size, &hashes[i], AllocateArena, ReleaseArena, flags);
+        }
+        pcontexts[i] = &contexts[i];
+    }
+    pActiveArgon2dContext = this;
+    nNextArena = 0;
+    int nResult;
+    if (count == 1) {
+        nResult = argon2_ctx(pcontexts[0], Argon2_d);
+    } else {
+        nResult = argon2d_ctx_multi(pcontexts, count);
+    }
+    pActiveArgon2dContext = nullptr;
+    return nResult == ARGON2_OK;
+}
+
+size_t CArgon2dContext::ArenaSize() const
+{
+    size_t nSize = 0;
+    for (const Arena& arena : arenas) {
+        nSize += arena.nSize;
+    }
+    return nSize;
+}
+
+bool CArgon2dContext::UsesHugePages() const
+{
+    for (const Arena& arena : arenas) {
+        if (arena.fHugePages)
+            return true;
+    }
+    return false;
+}
+
+int CArgon2dContext::AllocateArena(uint8_t** memory, size_t bytes)
+{
+    CArgon2dContext* ctx = pActiveArgon2dContext;
+    if (ctx == nullptr || ctx->nNextArena >= MAX_MULTI_HASHES || !ctx->Reserve(ctx->arenas[ctx->nNextArena], bytes)) {
+        *memory = nullptr;
+        return ARGON2_MEMORY_ALLOCATION_ERROR;
+    }
+    *memory = ctx->arenas[ctx->nNextArena++].pMemory;
+    return ARGON2_OK;
+}
+
+void CArgon2dContext::ReleaseArena(uint8_t* memory, size_t bytes)
+{
+    // The arenas outlive the hash and are only released with their context
+}
+
+bool CArgon2dContext::Reserve(Arena& arena, size_t bytes)
+{
+    if (arena.pMemory != nullptr && bytes <= arena.nSize) {
+        return true;
+    }
+    FreeArena(arena);
+    void* p = nullptr;
+    size_t nMapSize = bytes;
+#ifdef WIN32
+    p = VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+#ifdef MAP_HUGETLB
+    if (fHugePages) {
+        // Explicit huge pages must be reserved by the administrator (vm.nr_hugepages),
+        // silently fall back to regular pages when none are available.
+        static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        nMapSize = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        p = mmap(nullptr, nMapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) {
+            p = nullptr;
+            nMapSize = bytes;
+        } else {
+            arena.fHugePages = true;
+        }
+    }
+#endif
+    if (p == nullptr) {
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            p = nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        else if (fHugePages) {
+            // Ask for transparent huge pages instead
+            madvise(p, bytes, MADV_HUGEPAGE);
+        }
+#endif
+    }
+#endif
+    if (p == nullptr) {
+        return false;
+    }
+    arena.pMemory = static_cast<uint8_t*>(p);
+    arena.nSize = nMapSize;
+    return true;
+}
+
+void CArgon2dContext::FreeArena(Arena& arena)
+{
+    if (arena.pMemory == nullptr) {
+        return;
+    }
+#ifdef WIN32
+    VirtualFree(arena.pMemory, 0, MEM_RELEASE);
+#else
+    munmap(arena.pMemory, arena.nSize);
+#endif
+    arena.pMemory = nullptr;
+    arena.nSize = 0;
+    arena.fHugePages = false;
+}
@@ -308,9 +308,8 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
 /// Lanes: 8 parallel thread
 /// Threads: 1 threads
 /// Time Constraint: 2 iteration
-inline int Argon2d_Phase1_Hash(const void* in, const size_t size, const void* out)
+inline void Argon2d_Phase1_Context(argon2_context& context, const void* in, const size_t size, const void* out, allocate_fptr allocate_cbk = NULL, deallocate_fptr free_cbk = NULL, uint32_t flags = DEFAULT_ARGON2_FLAG)
 {
-    argon2_context context;
     context.out = (uint8_t*)out;
     context.outlen = (uint32_t)OUTPUT_BYTES;
     context.pwd = (uint8_t*)in;
@@ -321,15 +320,20 @@ inline int Argon2d_Phase1_Hash(const void* in, const size_t size, const void* ou
     context.secretlen = 0;
     context.ad = NULL;
     context.adlen = 0;
-    context.allocate_cbk = NULL;
-    context.free_cbk = NULL;
-    context.flags = DEFAULT_ARGON2_FLAG; // = ARGON2_DEFAULT_FLAGS
+    context.allocate_cbk = allocate_cbk;
+    context.free_cbk = free_cbk;
+    context.flags = flags; // = ARGON2_DEFAULT_FLAGS unless hashing through a CArgon2dContext
     // main configurable Argon2 hash parameters
     context.m_cost = 500; // Memory in KiB (512KB)
     context.lanes = 8;    // Degree of Parallelism
     context.threads = 1;  // Threads
     context.t_cost = 2;   // Iterations
+}
 
+inline int Argon2d_Phase1_Hash(const void* in, const size_t size, const void* out, allocate_fptr allocate_cbk = NULL, deallocate_fptr free_cbk = NULL, uint32_t flags = DEFAULT_ARGON2_FLAG)
+{
+    argon2_context context;
+    Argon2d_Phase1_Context(context, in, size, out, allocate_cbk, free_cbk, flags);
     return argon2_ctx(&context, Argon2_d);
 }
 
@@ -348,9 +352,8 @@ inline int Argon2d_Phase1_Hash(const void* in, const size_t size, const void* ou
 /// Lanes: 64 parallel threads
 /// Threads: 1 threads
 /// Time Constraint: 2 iterations
-inline int Argon2d_Phase2_Hash(const void* in, const size_t size, const void* out)
+inline void Argon2d_Phase2_Context(argon2_context& context, const void* in, const size_t size, const void* out, allocate_fptr allocate_cbk = NULL, deallocate_fptr free_cbk = NULL, uint32_t flags = DEFAULT_ARGON2_FLAG)
 {
-    argon2_context context;
     context.out = (uint8_t*)out;
     context.outlen = (uint32_t)OUTPUT_BYTES;
     context.pwd = (uint8_t*)in;
@@ -361,15 +364,20 @@ inline int Argon2d_Phase2_Hash(const void* in, const size_t size, const void* ou
     context.secretlen = 0;
     context.ad = NULL;
     context.adlen = 0;
-    context.allocate_cbk = NULL;
-    context.free_cbk = NULL;
-    context.flags = DEFAULT_ARGON2_FLAG; // = ARGON2_DEFAULT_FLAGS
+    context.allocate_cbk = allocate_cbk;
+    context.free_cbk = free_cbk;
+    context.flags = flags; // = ARGON2_DEFAULT_FLAGS unless hashing through a CArgon2dContext
     // main configurable Argon2 hash parameters
     context.m_cost = 8000; // Memory in KiB (~8192KB)
     context.lanes = 64;    // Degree of Parallelism
     context.threads = 1;   // Threads
     context.t_cost = 2;    // Iterations
+}
 
+inline int Argon2d_Phase2_Hash(const void* in, const size_t size, const void* out, allocate_fptr allocate_cbk = NULL, deallocate_fptr free_cbk = NULL, uint32_t flags = DEFAULT_ARGON2_FLAG)
+{
+    argon2_context context;
+    Argon2d_Phase2_Context(context, in, size, out, allocate_cbk, free_cbk, flags);
     return argon2_ctx(&context, Argon2_d);
 }
 
@@ -395,4 +403,66 @@ inline uint256 hash_Argon2d(const T1 pbegin, const T1 pend, const unsigned int&
     }
     return hashResult;
 }
+
+/**
+ * Reusable Argon2d block memory for hashing public data such as block headers.
+ *
+ * A plain hash_Argon2d call mallocs the Argon2 block memory, fills it, wipes it
+ * and frees it again. A context instead owns page-aligned arenas (huge-page
+ * backed when requested and available) that are reused for every hash and are
+ * not wiped, because a block header holds nothing secret. Meant to be owned by
+ * one thread, e.g. a miner thread, and never shared between threads.
+ */
+class CArgon2dContext
+{
+public:
+    /** Maximum number of inputs hashed together by HashMulti */
+    static const unsigned int MAX_MULTI_HASHES = ARGON2_MAX_MULTI_INSTANCES;
+
+    explicit CArgon2dContext(bool fHugePagesIn = false);
+    ~CArgon2dContext();
+
+    CArgon2dContext(const CArgon2dContext&) = delete;
+    CArgon2dContext& operator=(const CArgon2dContext&) = delete;
+
+    /**
+     * Same result as hash_Argon2d, but without per-hash allocation and wiping.
+     * Falls back to Argon2's own allocation when no arena can be reserved and
+     * asserts rather than return an unfilled hash.
+     */
+    uint256 Hash(const void* input, const size_t size, const unsigned int hashPhase);
+
+    /**
+     * Hashes count (at most MAX_MULTI_HASHES) inputs of the same size in
+     * lockstep, hiding the memory latency of one hash behind the others.
+     * hashes[i] gets the same result as Hash(inputs[i], size, hashPhase).
+     * Returns false, leaving hashes undefined, when Argon2 fails, e.g. because
+     * an arena could not be allocated.
+     */
+    bool HashMulti(const void* const* inputs, const size_t size, const unsigned int count, const unsigned int hashPhase, uint256* hashes);
+
+    /** Current size of all arenas in bytes */
+    size_t ArenaSize() const;
+    /** Whether an arena is backed by huge pages */
+    bool UsesHugePages() const;
+
+private:
+    struct Arena {
+        uint8_t* pMemory;
+        size_t nSize;
+        bool fHugePages;
+    };
+
+    static int AllocateArena(uint8_t** memory, size_t bytes);
+    static void ReleaseArena(uint8_t* memory, size_t bytes);
+
+    bool Reserve(Arena& arena, size_t bytes);
+    static void FreeArena(Arena& arena);
+
+    Arena arenas[MAX_MULTI_HASHES];
+    // arena handed out to the next Argon2 instance of the running hash
+    unsigned int nNextArena;
+    bool fHugePages;
+};
+
 #endif // DYNAMIC_HASH_H
@@ -25,6 +25,7 @@
 #include "dht/ed25519.h"
 #include "dht/session.h"
 #include "dht/mutabledb.h"
+#include "dht/reannounce.h"
 #include "dynode-payments.h"
 #include "dynode-sync.h"
 #include "dynodeconfig.h"
@@ -43,6 +44,7 @@
 #include "messagesigner.h"
 #include "miner/internal/miners-controller.h"
 #include "miner/miner.h"
+#include "miner/stratum.h"
 #include "net.h"
 #include "net_processing.h"
 #include "netfulfilledman.h"
@@ -233,6 +235,7 @@ void Interrupt(boost::thread_group& threadGroup)
     InterruptRPC();
     InterruptREST();
     InterruptTorControl();
+    InterruptStratumServer();
     if (g_connman)
         g_connman->Interrupt();
     threadGroup.interrupt_all();
@@ -305,6 +308,7 @@ void PrepareShutdown()
     if (pwalletMain)
         pwalletMain->Flush(false);
 #endif
+    StopStratumServer();
     ShutdownMiners();
     MapPort(false);
     UnregisterValidationInterface(peerLogic.get());
@@ -504,6 +508,8 @@ std::string HelpMessage(HelpMessageMode mode)
     }
     strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
+    strUsage += HelpMessageOpt("-dhtannouncerate=<n>", strprintf(_("Re-announce up to <n> stored DHT items per second when running a Dynode (default: %u)"), DEFAULT_DHT_ANNOUNCE_RATE));
+    strUsage += HelpMessageOpt("-dhtcachemb=<n>", strprintf(_("Keep up to <n> megabytes of the stored DHT item index and values in memory, the index of every item is always kept (default: %u)"), DEFAULT_DHT_CACHE_MB));
     strUsage += HelpMessageOpt("-feefilter", strprintf(_("Tell other nodes to filter invs to us by our mempool min fee (default: %u)"), DEFAULT_FEEFILTER));
     strUsage += HelpMessageOpt("-loadblock=<file>", _("Imports blocks from external blk000??.dat file on startup"));
     strUsage += HelpMessageOpt("-maxorphantx=<n>", strprintf(_("Keep at most <n> unconnectable transactions in memory (default: %u)"), DEFAULT_MAX_ORPHAN_TRANSACTIONS));
@@ -684,6 +690,12 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
+    strUsage += HelpMessageOpt("-minerbatch=<n>", strprintf(_("Number of nonces each CPU miner thread hashes in lockstep, 1 to %u (default: %u)"), CArgon2dContext::MAX_MULTI_HASHES, DEFAULT_MINER_BATCH_SIZE));
+    strUsage += HelpMessageOpt("-minerhugepages", strprintf(_("Back the Argon2d memory of each CPU miner thread with huge pages when available (default: %u)"), DEFAULT_MINER_HUGE_PAGES));
+    strUsage += HelpMessageOpt("-stratumport=<port>", _("Serve the block template to stratum clients on <port>, paying to the wallet (default: disabled)"));
+    strUsage += HelpMessageOpt("-stratumbind=<addr>", strprintf(_("Bind the stratum server to given address (default: %s)"), DEFAULT_STRATUM_BIND));
+    strUsage += HelpMessageOpt("-stratumpassword=<pw>", _("Password stratum workers have to authorize with, required unless bound to a loopback address"));
+    strUsage += HelpMessageOpt("-stratumdifficulty=<n>", strprintf(_("Share difficulty sent to stratum clients, relative to the proof-of-work limit (default: %u)"), DEFAULT_STRATUM_DIFFICULTY));
 
     strUsage += HelpMessageGroup(_("RPC server options:"));
     strUsage += HelpMessageOpt("-server", _("Accept command line and JSON-RPC commands"));
@@ -1438,8 +1450,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
-        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+        for (int i = 0; i < nScriptCheckThreads - 1; i++) {
             threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(&ThreadHeaderCheck);
+        }
     }
 
     std::vector<std::string> vSporkAddresses;
@@ -1740,7 +1754,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                 pLinkDB = new CLinkDB(nTotalCache * 35, false, fReindex, obfuscate);
                 pLinkManager = new CLinkManager();
                 // Init DHT Services DB
-                pMutableDataDB = new CMutableDataDB(nTotalCache * 35, false, fReindex, obfuscate);
+                pMutableDataDB = new CMutableDataDB(nTotalCache * 35, std::max<int64_t>(0, GetArg("-dhtcachemb", DEFAULT_DHT_CACHE_MB)) << 20, false, fReindex, obfuscate);
 
                 if (fReindex) {
                     pblocktree->WriteReindexing(true);
@@ -1753,6 +1767,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                         strLoadError = _("Error upgrading chainstate database");
                         break;
                     }
+                    if (!pMutableDataDB->Upgrade()) {
+                        strLoadError = _("Error upgrading DHT database");
+                        break;
+                    }
                 }
                 if (fRequestShutdown)
                     break;
@@ -2109,6 +2127,13 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         StartMiners();
     }
 
+    // Serve the miners block template over stratum
+    if (GetArg("-stratumport", DEFAULT_STRATUM_PORT) > 0) {
+        InitMiners(chainparams, connman);
+        if (!StartStratumServer(chainparams))
+            return InitError(_("Unable to start stratum server. See debug log for details."));
+    }
+
     // Start the DHT Torrent networks in the background
     const bool fMultiSessions = GetArg("-multidhtsessions", true);
     StartTorrentDHTNetwork(fMultiSessions, chainparams, connman);
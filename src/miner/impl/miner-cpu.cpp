@@ -4,17 +4,31 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "miner/impl/miner-cpu.h"
+#include "miner/miner-util.h"
 #include "primitives/block.h"
+#include "util.h"
+
+#include <algorithm>
 
 
 CPUMiner::CPUMiner(MinerContextRef ctx, std::size_t device_index)
-    : MinerBase(ctx, device_index){};
+    : MinerBase(ctx, device_index),
+      _argon2d_ctx(GetBoolArg("-minerhugepages", DEFAULT_MINER_HUGE_PAGES)),
+      _batch_size(std::max<int64_t>(1, std::min<int64_t>(GetArg("-minerbatch", DEFAULT_MINER_BATCH_SIZE), CArgon2dContext::MAX_MULTI_HASHES))){};
 
 int64_t CPUMiner::TryMineBlock(CBlock& block)
+{
+    if (_batch_size > 1) {
+        return TryMineBlockBatch(block);
+    }
+    return TryMineBlockSingle(block);
+}
+
+int64_t CPUMiner::TryMineBlockSingle(CBlock& block)
 {
     int64_t hashes_done = 0;
     while (true) {
-        uint256 hash = block.GetHash();
+        uint256 hash = block.GetHash(_argon2d_ctx);
         if (UintToArith256(hash) <= _hash_target) {
             this->ProcessFoundSolution(block, hash);
             break;
@@ -26,3 +40,42 @@ int64_t CPUMiner::TryMineBlock(CBlock& block)
     }
     return hashes_done;
 }
+
+int64_t CPUMiner::TryMineBlockBatch(CBlock& block)
+{
+    unsigned char headers[CArgon2dContext::MAX_MULTI_HASHES][BLOCK_HEADER_HASHED_SIZE];
+    const void* inputs[CArgon2dContext::MAX_MULTI_HASHES];
+    uint256 hashes[CArgon2dContext::MAX_MULTI_HASHES];
+    const size_t nonce_offset = BEGIN(block.nNonce) - BEGIN(block.nVersion);
+    for (unsigned int i = 0; i < _batch_size; i++) {
+        inputs[i] = headers[i];
+    }
+
+    int64_t hashes_done = 0;
+    while (true) {
+        // never step over the 256 nonce boundary checked below
+        const unsigned int count = std::min<unsigned int>(_batch_size, 0x100 - (block.nNonce & 0xFF));
+        for (unsigned int i = 0; i < count; i++) {
+            const uint32_t nonce = block.nNonce + i;
+            memcpy(headers[i], BEGIN(block.nVersion), BLOCK_HEADER_HASHED_SIZE);
+            memcpy(headers[i] + nonce_offset, &nonce, sizeof(nonce));
+        }
+        if (!_argon2d_ctx.HashMulti(inputs, BLOCK_HEADER_HASHED_SIZE, count, 1, hashes)) {
+            // unfilled hashes would meet any target, finish this round one nonce at a time
+            LogPrintf("CPUMiner::%s -- Argon2d failed for a batch of %u nonces, hashing them one by one\n", __func__, count);
+            return hashes_done + TryMineBlockSingle(block);
+        }
+        for (unsigned int i = 0; i < count; i++) {
+            if (UintToArith256(hashes[i]) <= _hash_target) {
+                block.nNonce += i;
+                this->ProcessFoundSolution(block, hashes[i]);
+                return hashes_done + i + 1;
+            }
+        }
+        block.nNonce += count;
+        hashes_done += count;
+        if ((block.nNonce & 0xFF) == 0)
+            break;
+    }
+    return hashes_done;
+}
@@ -5,6 +5,7 @@
 #ifndef DYNAMIC_MINER_IMPL_CPU_H
 #define DYNAMIC_MINER_IMPL_CPU_H
 
+#include "hash.h"
 #include "miner/internal/miner-base.h"
 
 
@@ -31,6 +32,18 @@ public:
 
 protected:
     virtual int64_t TryMineBlock(CBlock& block) override;
+
+    // Tries consecutive nonces one at a time, up to the next 256 nonce boundary
+    int64_t TryMineBlockSingle(CBlock& block);
+    // Tries consecutive nonces in batches hashed in lockstep
+    int64_t TryMineBlockBatch(CBlock& block);
+
+private:
+    // Argon2d memory arena reused for every nonce of this thread
+    CArgon2dContext _argon2d_ctx;
+
+    // Number of nonces hashed together
+    unsigned int _batch_size;
 };
 
 #endif // DYNAMIC_MINER_IMPL_CPU_H
@@ -1,4 +1,3 @@
-
 // Copyright (c) 2019 Duality Blockchain Solutions Developers
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
@@ -6,33 +5,181 @@
 #include "miner/internal/hash-rate-counter.h"
 #include "utiltime.h"
 
+#include <algorithm>
+
+
+HashRateCounterRef HashRateCounter::MakeChild()
+{
+    HashRateCounterRef child = std::make_shared<HashRateCounter>(shared_from_this());
+    std::lock_guard<std::mutex> guard(_mutex);
+    // Drop counters of miners that have already shut down
+    _children.erase(std::remove_if(_children.begin(), _children.end(),
+                        [](const std::weak_ptr<HashRateCounter>& ref) { return ref.expired(); }),
+        _children.end());
+    _children.push_back(child);
+    return child;
+}
+
+HashRateCounter::~HashRateCounter()
+{
+    if (_parent) {
+        _parent->Merge(*this);
+    }
+}
 
 void HashRateCounter::Increment(int64_t amount)
 {
-    // Set start time if not set and return
-    if (_timer_start == 0) {
-        Reset();
-        return;
+    const int64_t now = GetTime();
+    // Set start time if not set
+    if (_timer_start.load(std::memory_order_relaxed) == 0) {
+        _timer_start.store(now, std::memory_order_relaxed);
     }
-    // Increment hashes done
-    _count += amount;
-    if (_parent) {
-        _parent->Increment(amount);
+    _total.store(_total.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    AddToSlot(now, amount);
+}
+
+void HashRateCounter::RecordLatency(int64_t micros)
+{
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && (int64_t(1) << bucket) <= micros) {
+        bucket++;
     }
-    // Ignore until at least 4 seconds passed
-    if (GetTimeMillis() - _timer_start < 4000) {
+    std::atomic<uint64_t>& count = _latency[bucket];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void HashRateCounter::AddToSlot(int64_t second, uint64_t amount)
+{
+    std::atomic<uint64_t>& slot = _slots[second % WINDOW_SLOTS];
+    const uint64_t tag = uint64_t(uint32_t(second)) << 32;
+    const uint64_t current = slot.load(std::memory_order_relaxed);
+    // Slot still holds a second that left the window, start it over
+    if ((current & 0xffffffff00000000ULL) != tag) {
+        slot.store(tag | uint32_t(amount), std::memory_order_relaxed);
+    } else {
+        slot.store(current + uint32_t(amount), std::memory_order_relaxed);
+    }
+}
+
+void HashRateCounter::Merge(const HashRateCounter& child)
+{
+    const int64_t child_start = child._timer_start.load(std::memory_order_relaxed);
+    if (child_start == 0) {
         return;
     }
-    // Set count per second
-    _count_per_sec = 1000.0 * _count / (GetTimeMillis() - _timer_start);
-    // Reset timer and count
-    _count = 0;
-    _timer_start = GetTimeMillis();
+    std::lock_guard<std::mutex> guard(_mutex);
+    const int64_t start = _timer_start.load(std::memory_order_relaxed);
+    if (start == 0 || child_start < start) {
+        _timer_start.store(child_start, std::memory_order_relaxed);
+    }
+    _total.fetch_add(child._total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (const std::atomic<uint64_t>& child_slot : child._slots) {
+        const uint64_t value = child_slot.load(std::memory_order_relaxed);
+        const uint32_t second = value >> 32;
+        // Keep our slot if it already holds a newer second
+        const uint64_t current = _slots[second % WINDOW_SLOTS].load(std::memory_order_relaxed);
+        if (value != 0 && uint32_t(current >> 32) <= second) {
+            AddToSlot(second, value & 0xffffffff);
+        }
+    }
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        _latency[i].fetch_add(child._latency[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+int64_t HashRateCounter::total() const
+{
+    int64_t result = _total.load(std::memory_order_relaxed);
+    for (const HashRateCounterRef& child : children()) {
+        result += child->total();
+    }
+    return result;
+}
+
+int64_t HashRateCounter::GetRate(int64_t seconds) const
+{
+    int64_t result = GetOwnRate(seconds);
+    for (const HashRateCounterRef& child : children()) {
+        result += child->GetRate(seconds);
+    }
+    return result;
+}
+
+int64_t HashRateCounter::GetOwnRate(int64_t seconds) const
+{
+    const int64_t start = _timer_start.load(std::memory_order_relaxed);
+    if (start == 0) {
+        return 0;
+    }
+    const int64_t now = GetTime();
+    seconds = std::max<int64_t>(1, std::min<int64_t>(seconds, WINDOW_SLOTS - 1));
+    // Average over the time actually mined when started less than a window ago
+    const int64_t span = std::min<int64_t>(seconds, now - start);
+    if (span <= 0) {
+        return 0;
+    }
+    // The current second is still filling up, only count completed ones
+    int64_t hashes = 0;
+    for (int64_t second = now - span; second < now; second++) {
+        const uint64_t slot = _slots[second % WINDOW_SLOTS].load(std::memory_order_relaxed);
+        if ((slot >> 32) == uint32_t(second)) {
+            hashes += slot & 0xffffffff;
+        }
+    }
+    return hashes / span;
+}
+
+std::vector<uint64_t> HashRateCounter::GetLatencyHistogram() const
+{
+    std::vector<uint64_t> histogram(LATENCY_BUCKETS);
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        histogram[i] = _latency[i].load(std::memory_order_relaxed);
+    }
+    for (const HashRateCounterRef& child : children()) {
+        std::vector<uint64_t> child_histogram = child->GetLatencyHistogram();
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            histogram[i] += child_histogram[i];
+        }
+    }
+    return histogram;
+}
+
+std::vector<HashRateCounterRef> HashRateCounter::children() const
+{
+    std::vector<HashRateCounterRef> result;
+    std::lock_guard<std::mutex> guard(_mutex);
+    for (const std::weak_ptr<HashRateCounter>& ref : _children) {
+        if (HashRateCounterRef child = ref.lock()) {
+            result.push_back(child);
+        }
+    }
+    return result;
+}
+
+std::string HashRateCounter::label() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _label;
+}
+
+void HashRateCounter::SetLabel(const std::string& label)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _label = label;
 }
 
 void HashRateCounter::Reset()
 {
-    _count = 0;
-    _count_per_sec = 0;
-    _timer_start = GetTimeMillis();
+    for (const HashRateCounterRef& child : children()) {
+        child->Reset();
+    }
+    std::lock_guard<std::mutex> guard(_mutex);
+    _total.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint64_t>& slot : _slots) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<uint64_t>& bucket : _latency) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    _timer_start.store(GetTime(), std::memory_order_relaxed);
 }
@@ -5,8 +5,12 @@
 #ifndef DYNAMIC_INTERNAL_HASH_RATE_COUNTER_H
 #define DYNAMIC_INTERNAL_HASH_RATE_COUNTER_H
 
+#include <array>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 
 struct HashRateCounter;
@@ -14,33 +18,87 @@ using HashRateCounterRef = std::shared_ptr<HashRateCounter>;
 
 /**
  * Hash rate counter struct.
+ *
+ * Counters form a tree (controller, device group, miner thread). Every miner
+ * thread only writes hashes and TryMineBlock latencies into its own counter,
+ * so the hot path neither locks nor shares a cache line with other threads.
+ * Parents sum their children when read and take over the counts of children
+ * that shut down. Rates are kept in per-second slots covering the last 15
+ * minutes.
  */
 struct HashRateCounter : public std::enable_shared_from_this<HashRateCounter> {
-private:
-    std::atomic<int64_t> _count{0};
-    std::atomic<int64_t> _timer_start{0};
-    std::atomic<int64_t> _count_per_sec{0};
-
-    HashRateCounterRef _parent;
-
 public:
+    // Per-second slots of the rolling windows (15 minutes)
+    static const int64_t WINDOW_SLOTS = 900;
+    // Latency histogram buckets, bucket i counts latencies below 2^i microseconds
+    static const int LATENCY_BUCKETS = 32;
+
     explicit HashRateCounter() : _parent(nullptr){};
     explicit HashRateCounter(HashRateCounterRef parent) : _parent(parent){};
+    ~HashRateCounter();
 
-    // Returns hash rate per second
-    operator int64_t() { return _count_per_sec; };
+    // Returns hash rate per second over the last 10 seconds
+    operator int64_t() const { return GetRate(10); };
 
     // Creates new child counter
-    HashRateCounterRef MakeChild() { return std::make_shared<HashRateCounter>(shared_from_this()); }
+    HashRateCounterRef MakeChild();
 
-    // Increments counter
+    // Increments counter, only called by the thread owning the counter
     void Increment(int64_t amount);
 
-    // Resets counter and timer
+    // Records the duration of one TryMineBlock call, same as Increment
+    void RecordLatency(int64_t micros);
+
+    // Resets counter and timer, including children
     void Reset();
 
-    // Returns start time
-    int64_t start() const { return _timer_start; };
+    // Returns start time in seconds
+    int64_t start() const { return _timer_start.load(std::memory_order_relaxed); };
+
+    // Returns hashes done since start, including children
+    int64_t total() const;
+
+    // Returns average hashes per second over the last seconds (at most WINDOW_SLOTS),
+    // including children
+    int64_t GetRate(int64_t seconds) const;
+
+    // Returns latency histogram counts including children, see LATENCY_BUCKETS
+    std::vector<uint64_t> GetLatencyHistogram() const;
+
+    // Returns live child counters
+    std::vector<HashRateCounterRef> children() const;
+
+    // Label of the counter, e.g. device name
+    std::string label() const;
+    void SetLabel(const std::string& label);
+
+private:
+    // Adds hashes to the slot of the given second, single writer only
+    void AddToSlot(int64_t second, uint64_t amount);
+    // Returns rate of this counter without children
+    int64_t GetOwnRate(int64_t seconds) const;
+    // Takes over the counts of a child that is shutting down
+    void Merge(const HashRateCounter& child);
+
+    // Keeps the counts written by the mining thread off the cache lines
+    // of neighbouring allocations and of the fields below
+    char _padding_front[64];
+
+    std::atomic<int64_t> _total{0};
+    std::atomic<int64_t> _timer_start{0};
+
+    // Slot value is (second << 32 | hashes in that second)
+    std::array<std::atomic<uint64_t>, WINDOW_SLOTS> _slots{};
+    std::array<std::atomic<uint64_t>, LATENCY_BUCKETS> _latency{};
+
+    char _padding_back[64];
+
+    HashRateCounterRef _parent;
+
+    // protects children, label and merges, never taken while mining
+    mutable std::mutex _mutex;
+    std::vector<std::weak_ptr<HashRateCounter> > _children;
+    std::string _label;
 };
 
 #endif // DYNAMIC_INTERNAL_HASH_RATE_COUNTER_H
@@ -35,24 +35,25 @@ void MinerBase::Loop()
     LogPrintf("DynamicMiner -- started on %s#%d\n", DeviceName(), _device_index);
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
     RenameThread(tfm::format("dynamic-%s-miner-%d", DeviceName(), _device_index).data());
+    _ctx->counter->SetLabel(tfm::format("%s#%d", DeviceName(), _device_index));
 
     CBlock block;
     CBlockIndex* chain_tip = nullptr;
-    int64_t block_time = 0;
+    int64_t block_version = 0;
     std::shared_ptr<CBlockTemplate> block_template = {nullptr};
 
     try {
         while (true) {
             // Update block and tip if changed
-            if (block_time != _ctx->shared->block_time()) {
+            if (block_version != _ctx->shared->block_version()) {
                 // set new block template
                 block_template = _ctx->shared->block_template();
                 block = block_template->block;
                 // set block reserve script
-                SetBlockPubkeyScript(block, _coinbase_script->reserveScript);
+                SetBlockPubkeyScript(block, _coinbase_script->reserveScript, &block_template->vCoinbaseBranch);
                 // set block flag only after template
                 // so we've waited for RecreateBlock
-                block_time = _ctx->shared->block_time();
+                block_version = _ctx->shared->block_version();
                 // block template chain tip
                 chain_tip = _ctx->shared->tip();
             }
@@ -60,7 +61,7 @@ void MinerBase::Loop()
             assert(chain_tip != nullptr);
             assert(block_template != nullptr);
             // Increment nonce
-            IncrementExtraNonce(block, chain_tip, _extra_nonce);
+            IncrementExtraNonce(block, chain_tip, _extra_nonce, &block_template->vCoinbaseBranch);
             LogPrintf("DynamicMiner -- Running miner on device %s#%d with %u transactions in block (%u bytes)\n", DeviceName(), _device_index, block.vtx.size(),
                 GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION));
             // set loop start for counter
@@ -68,13 +69,15 @@ void MinerBase::Loop()
             // start mining the block
             while (true) {
                 // try mining the block
+                int64_t start_time = GetTimeMicros();
                 int64_t hashes = TryMineBlock(block);
                 // increment hash statistics
+                _ctx->counter->RecordLatency(GetTimeMicros() - start_time);
                 _ctx->counter->Increment(hashes);
                 // Check for stop or if block needs to be rebuilt
                 boost::this_thread::interruption_point();
                 // Check if block was recreated
-                if (block_time != _ctx->shared->block_time()) {
+                if (block_version != _ctx->shared->block_version()) {
                     break;
                 }
                 // Recreate block if nonce too big
@@ -45,6 +45,9 @@ protected:
     MinerContextRef _ctx;
 
 private:
+    // Runs single TryMineBlock rounds in bench/mining.cpp
+    friend class MinerBench;
+
     // Miner device index
     std::size_t _device_index;
 
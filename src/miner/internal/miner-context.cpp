@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "miner/internal/miner-context.h"
+#include "chainparams.h"
 #include "miner/miner-util.h"
 #include "txmempool.h"
 #include "validation.h"
@@ -23,8 +24,22 @@ void MinerSharedContext::RecreateBlock()
     // pass if nothing changed
     if (_chain_tip == chainActive.Tip() && _last_txn == txn_time)
         return;
+    // Only the mempool changed, extend a copy of the template (miners
+    // may still be reading the current one) without taking cs_main.
+    // The copy shares the selection state, which miners don't read.
+    if (_block_template && _chain_tip == chainActive.Tip() && GetTime() - _rebuild_time < MINER_TEMPLATE_REBUILD_INTERVAL) {
+        std::shared_ptr<CBlockTemplate> block_template = std::make_shared<CBlockTemplate>(*_block_template);
+        if (UpdateBlockTemplate(*block_template)) {
+            UpdateTime(block_template->block, chainparams.GetConsensus(), _chain_tip);
+            _block_template = block_template;
+            _block_version++;
+        }
+        _last_txn = txn_time;
+        return;
+    }
     _chain_tip = chainActive.Tip();
-    _block_time = GetTime();
+    _rebuild_time = GetTime();
     _block_template = CreateNewBlock(chainparams);
+    _block_version++;
     _last_txn = txn_time;
 }
@@ -37,8 +37,8 @@ public:
     // Returns chain tip of current block template
     CBlockIndex* tip() const { return _chain_tip; }
 
-    // Returns miner block template creation time
-    int64_t block_time() const { return _block_time; }
+    // Returns version of the miner block template, changes whenever it is recreated or updated
+    int64_t block_version() const { return _block_version; }
 
     // Returns time of last transaction in the block
     uint32_t last_txn() const { return _last_txn; }
@@ -55,14 +55,16 @@ protected:
     friend class MinerSignals;
     friend class MinersController;
 
-    // recreates miners block template
+    // recreates miners block template, or updates it if only the mempool changed
     void RecreateBlock();
 
 private:
     // current block chain tip
     std::atomic<CBlockIndex*> _chain_tip{nullptr};
-    // atomic flag incremented on recreated block
-    std::atomic<int64_t> _block_time{0};
+    // atomic flag incremented on recreated or updated block
+    std::atomic<int64_t> _block_version{0};
+    // time the block template was last rebuilt from scratch
+    int64_t _rebuild_time{0};
     // last transaction update time
     std::atomic<uint32_t> _last_txn{0};
     // shared block template for miners
@@ -20,7 +20,13 @@ MinersController::MinersController(MinerContextRef ctx)
 #ifdef ENABLE_GPU
       _group_gpu(_ctx->MakeChild()),
 #endif // ENABLE_GPU
-      _connected(!_ctx->chainparams().MiningRequiresPeers()){};
+      _connected(!_ctx->chainparams().MiningRequiresPeers())
+{
+    _group_cpu.counter()->SetLabel("CPU");
+#ifdef ENABLE_GPU
+    _group_gpu.counter()->SetLabel("GPU");
+#endif // ENABLE_GPU
+};
 
 void MinersController::Start()
 {
@@ -50,6 +56,15 @@ void MinersController::Shutdown()
 #endif // ENABLE_GPU
 };
 
+std::shared_ptr<CBlockTemplate> MinersController::RefreshBlockTemplate(int64_t& block_version)
+{
+    _ctx->shared->RecreateBlock();
+    // read template first, like miners do
+    std::shared_ptr<CBlockTemplate> block_template = _ctx->shared->block_template();
+    block_version = _ctx->shared->block_version();
+    return block_template;
+};
+
 int64_t MinersController::GetHashRate() const
 {
 #ifdef ENABLE_GPU
@@ -44,6 +44,10 @@ public:
     // Gets combined hash rate of GPU and CPU
     int64_t GetHashRate() const;
 
+    // Recreates or updates the shared block template if the tip or mempool
+    // changed and returns it, block_version is set to its version
+    std::shared_ptr<CBlockTemplate> RefreshBlockTemplate(int64_t& block_version);
+
     // Returns CPU miners thread group
     MinersThreadGroup<CPUMiner>& group_cpu() { return _group_cpu; }
 
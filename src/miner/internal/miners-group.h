@@ -20,22 +20,16 @@ public:
         : ThreadGroup<T, MinerContextRef>(ctx){};
 
     // Shuts down all miner threads
-    void Shutdown()
-    {
-        // Shutdown all threads
-        SetSize(0);
-        // It's not updated and instead of reading
-        // system time and comparing with last update
-        // it is just reset when all threads are shut
-        this->_ctx->counter->Reset();
-    };
+    void Shutdown() { SetSize(0); };
 
     // Sets amount of threads
     void SetSize(uint8_t size)
     {
-        // Set thread group size
+        // Set thread group size, stopped miners have merged their counts once this returns
         ThreadGroup<T, MinerContextRef>::SetSize(size);
-        // Reset hash rate counter
+        // It's not updated and instead of reading
+        // system time and comparing with last update
+        // it is just reset when all threads are shut
         if (size == 0) {
             this->_ctx->counter->Reset();
         }
@@ -43,6 +37,9 @@ public:
 
     // Gets hash rate of all threads in the group
     int64_t GetHashRate() const { return *this->_ctx->counter; };
+
+    // Gets hash rate counter of the group, its children are the miner threads
+    HashRateCounterRef counter() const { return this->_ctx->counter; };
 };
 
 
@@ -9,6 +9,9 @@
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <memory>
+#include <vector>
+
 /**
  * Miner threads controller.
  * Separate object for CPU and GPU.
@@ -29,17 +32,21 @@ public:
     // Shuts down all threads
     void Shutdown() { SetSize(0); };
 
-    // Sets amount of threads
+    // Sets amount of threads, returns after the stopped threads have exited
     void SetSize(uint8_t size)
     {
-        boost::unique_lock<boost::shared_mutex> guard(_mutex);
-        // sync only if lowering
-        // requires sync if higher
-        if (_threads.size() > size) {
-            SyncGroupTarget();
-            _target_threads = size;
-        } else {
+        std::vector<std::shared_ptr<boost::thread> > stopped;
+        {
+            boost::unique_lock<boost::shared_mutex> guard(_mutex);
             _target_threads = size;
+            // sync only if lowering
+            // higher targets are started by Start
+            if (_threads.size() > size) {
+                stopped = SyncGroupTarget();
+            }
+        }
+        for (const std::shared_ptr<boost::thread>& thread : stopped) {
+            thread->join();
         }
     };
 
@@ -51,8 +58,8 @@ protected:
 
 private:
     // Starts or shutdowns threads to meet the target
-    // Requires a mutex lock before call
-    void SyncGroupTarget();
+    // Requires a mutex lock before call, returns the interrupted threads
+    std::vector<std::shared_ptr<boost::thread> > SyncGroupTarget();
 
     size_t _devices;
     uint8_t _target_threads = 0;
@@ -66,21 +73,28 @@ ThreadGroup<T, Context>::ThreadGroup(Context ctx)
     : _ctx(ctx), _devices(T::TotalDevices()){};
 
 template <class T, class Context>
-void ThreadGroup<T, Context>::SyncGroupTarget()
+std::vector<std::shared_ptr<boost::thread> > ThreadGroup<T, Context>::SyncGroupTarget()
 {
+    std::vector<std::shared_ptr<boost::thread> > stopped;
     size_t current;
     while ((current = _threads.size()) != _target_threads) {
         if (current < _target_threads) {
             auto miner = std::shared_ptr<T>(new T(_ctx->MakeChild(), current % _devices));
-            _threads.push_back(std::make_shared<boost::thread>([miner] {
-                (*miner)();
+            _threads.push_back(std::make_shared<boost::thread>([miner]() mutable {
+                // The miner is destroyed on this thread, also when interrupted,
+                // so joining the thread waits for its counter to be merged
+                std::shared_ptr<T> owned;
+                owned.swap(miner);
+                (*owned)();
             }));
         } else {
             std::shared_ptr<boost::thread> thread = _threads.back();
             _threads.pop_back();
             thread->interrupt();
+            stopped.push_back(thread);
         }
     }
+    return stopped;
 };
 
 #endif // DYNAMIC_INTERNAL_THREAD_GROUP_H
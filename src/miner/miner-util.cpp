@@ -85,6 +85,19 @@ public:
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockSize = 0;
 
+static unsigned int GetBlockMaxSize()
+{
+    unsigned int nBlockMaxSize = GetArg("-blockmaxsize", DEFAULT_BLOCK_MAX_SIZE);
+    // Limit to between 1K and MAX_BLOCK_SIZE-1K for sanity:
+    return std::max((unsigned int)1000, std::min((unsigned int)(MAX_BLOCK_SIZE - 1000), nBlockMaxSize));
+}
+
+static unsigned int GetBlockMinSize(unsigned int nBlockMaxSize)
+{
+    unsigned int nBlockMinSize = GetArg("-blockminsize", DEFAULT_BLOCK_MIN_SIZE);
+    return std::min(nBlockMaxSize, nBlockMinSize);
+}
+
 std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript* scriptPubKeyIn)
 {
     // Create new block
@@ -99,9 +112,7 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
     txNew.vout.resize(1);
 
     // Largest block you're willing to create:
-    unsigned int nBlockMaxSize = GetArg("-blockmaxsize", DEFAULT_BLOCK_MAX_SIZE);
-    // Limit to between 1K and MAX_BLOCK_SIZE-1K for sanity:
-    nBlockMaxSize = std::max((unsigned int)1000, std::min((unsigned int)(MAX_BLOCK_SIZE - 1000), nBlockMaxSize));
+    unsigned int nBlockMaxSize = GetBlockMaxSize();
 
     // How much of the block should be dedicated to high-priority transactions,
     // included regardless of the fees they pay
@@ -110,8 +121,7 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
 
     // Minimum block size you want to create; block will be filled with free transactions
     // until there are no more or the block reaches this size:
-    unsigned int nBlockMinSize = GetArg("-blockminsize", DEFAULT_BLOCK_MIN_SIZE);
-    nBlockMinSize = std::min(nBlockMaxSize, nBlockMinSize);
+    unsigned int nBlockMinSize = GetBlockMinSize(nBlockMaxSize);
 
     // Collect memory pool transactions into the block
     CTxMemPool::setEntries inBlock;
@@ -253,6 +263,7 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
             }
 
             inBlock.insert(iter);
+            pblocktemplate->selection->setTxHashes.insert(tx.GetHash());
 
             // Add transactions that depend on this one to the priority queue
             BOOST_FOREACH (CTxMemPool::txiter child, mempool.GetMemPoolChildren(iter)) {
@@ -338,6 +349,20 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
             LogPrintf("CreateNewBlock(): Generated Transaction:\n%s\n", txNew.ToString());
             throw std::runtime_error(tfm::format("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
         }
+
+        // Remember the selection so the template can be extended incrementally
+        pblocktemplate->nHeight = nHeight;
+        pblocktemplate->nLockTimeCutoff = nLockTimeCutoff;
+        pblocktemplate->nBlockSize = nBlockSize;
+        pblocktemplate->nBlockSigOps = nBlockSigOps;
+        if (!mempool.mapTx.empty())
+            pblocktemplate->nLastEntryTime = mempool.mapTx.get<entry_time>().rbegin()->GetTime();
+        std::vector<uint256> leaves(block.vtx.size());
+        for (size_t i = 0; i < block.vtx.size(); i++)
+            leaves[i] = block.vtx[i]->GetHash();
+        pblocktemplate->selection->merkleTree = CMerkleTree(leaves);
+        pblocktemplate->vCoinbaseBranch = pblocktemplate->selection->merkleTree.Branch(0);
+        block.hashMerkleRoot = pblocktemplate->selection->merkleTree.Root();
     }
 
     return pblocktemplate;
@@ -348,7 +373,125 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
     return CreateNewBlock(chainparams, &scriptPubKeyIn);
 }
 
-void IncrementExtraNonce(CBlock& block, const CBlockIndex* indexPrev, unsigned int& nExtraNonce)
+bool UpdateBlockTemplate(CBlockTemplate& blocktemplate)
+{
+    CBlock& block = blocktemplate.block;
+    CBlockTemplateSelection& selection = *blocktemplate.selection;
+    const unsigned int nBlockMaxSize = GetBlockMaxSize();
+    const unsigned int nBlockMinSize = GetBlockMinSize(nBlockMaxSize);
+    bool fChanged = false;
+
+    LOCK(mempool.cs);
+
+    // Drop transactions that are no longer in the mempool, together with
+    // everything in the block spending them. Parents always come first.
+    std::set<uint256> setEvicted;
+    for (size_t i = 1; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        bool fEvict = !mempool.exists(tx.GetHash());
+        for (size_t j = 0; !fEvict && j < tx.vin.size(); j++) {
+            fEvict = setEvicted.count(tx.vin[j].prevout.hash) > 0;
+        }
+        if (fEvict)
+            setEvicted.insert(tx.GetHash());
+    }
+    if (!setEvicted.empty()) {
+        std::vector<CTransactionRef> vtx;
+        std::vector<CAmount> vTxFees;
+        std::vector<int64_t> vTxSigOps;
+        std::vector<uint256> leaves;
+        for (size_t i = 0; i < block.vtx.size(); i++) {
+            const CTransactionRef& tx = block.vtx[i];
+            if (i > 0 && setEvicted.count(tx->GetHash())) {
+                blocktemplate.vTxFees[0] += blocktemplate.vTxFees[i];
+                blocktemplate.nBlockSize -= ::GetSerializeSize(*tx, SER_NETWORK, PROTOCOL_VERSION);
+                blocktemplate.nBlockSigOps -= blocktemplate.vTxSigOps[i];
+                selection.setTxHashes.erase(tx->GetHash());
+                continue;
+            }
+            vtx.push_back(tx);
+            vTxFees.push_back(blocktemplate.vTxFees[i]);
+            vTxSigOps.push_back(blocktemplate.vTxSigOps[i]);
+            leaves.push_back(tx->GetHash());
+        }
+        vTxFees[0] = blocktemplate.vTxFees[0];
+        block.vtx.swap(vtx);
+        blocktemplate.vTxFees.swap(vTxFees);
+        blocktemplate.vTxSigOps.swap(vTxSigOps);
+        selection.merkleTree = CMerkleTree(leaves);
+        fChanged = true;
+    }
+
+    // Collect entries that arrived since the last update, newest first
+    std::vector<CTxMemPool::txiter> vNew;
+    typedef CTxMemPool::indexed_transaction_set::index<entry_time>::type::reverse_iterator entry_iter;
+    for (entry_iter mi = mempool.mapTx.get<entry_time>().rbegin(); mi != mempool.mapTx.get<entry_time>().rend(); ++mi) {
+        if (mi->GetTime() < blocktemplate.nLastEntryTime)
+            break;
+        vNew.push_back(mempool.mapTx.project<0>(std::next(mi).base()));
+    }
+    if (!vNew.empty())
+        blocktemplate.nLastEntryTime = vNew.front()->GetTime();
+
+    // Append them in arrival order, so parents are considered before children
+    for (std::vector<CTxMemPool::txiter>::reverse_iterator it = vNew.rbegin(); it != vNew.rend(); ++it) {
+        CTxMemPool::txiter iter = *it;
+        const CTransaction& tx = iter->GetTx();
+        if (selection.setTxHashes.count(tx.GetHash()))
+            continue;
+
+        bool fOrphan = false;
+        BOOST_FOREACH (CTxMemPool::txiter parent, mempool.GetMemPoolParents(iter)) {
+            if (!selection.setTxHashes.count(parent->GetTx().GetHash())) {
+                fOrphan = true;
+                break;
+            }
+        }
+        if (fOrphan)
+            continue;
+
+        unsigned int nTxSize = iter->GetTxSize();
+        if (iter->GetModifiedFee() < ::minRelayTxFee.GetFee(nTxSize) && blocktemplate.nBlockSize >= nBlockMinSize)
+            continue;
+        if (blocktemplate.nBlockSize + nTxSize >= nBlockMaxSize)
+            continue;
+        if (!IsFinalTx(tx, blocktemplate.nHeight, blocktemplate.nLockTimeCutoff))
+            continue;
+        unsigned int nTxSigOps = iter->GetSigOpCount();
+        if (blocktemplate.nBlockSigOps + nTxSigOps >= MAX_BLOCK_SIGOPS)
+            continue;
+
+        block.vtx.emplace_back(iter->GetSharedTx());
+        blocktemplate.vTxFees.push_back(iter->GetFee());
+        blocktemplate.vTxSigOps.push_back(nTxSigOps);
+        blocktemplate.vTxFees[0] -= iter->GetFee();
+        blocktemplate.nBlockSize += nTxSize;
+        blocktemplate.nBlockSigOps += nTxSigOps;
+        selection.setTxHashes.insert(tx.GetHash());
+        selection.merkleTree.Append(tx.GetHash());
+        fChanged = true;
+    }
+
+    if (fChanged) {
+        blocktemplate.vCoinbaseBranch = selection.merkleTree.Branch(0);
+        block.hashMerkleRoot = selection.merkleTree.Root();
+        LogPrint("miner", "UpdateBlockTemplate(): %u evicted, total size %u txs: %u sigops %d\n",
+            setEvicted.size(), blocktemplate.nBlockSize, block.vtx.size() - 1, blocktemplate.nBlockSigOps);
+    }
+    return fChanged;
+}
+
+static void UpdateMerkleRoot(CBlock& block, const std::vector<uint256>* pCoinbaseBranch)
+{
+    if (pCoinbaseBranch) {
+        // Only the coinbase changed, O(log n) hashes
+        block.hashMerkleRoot = ComputeMerkleRootFromBranch(block.vtx[0]->GetHash(), *pCoinbaseBranch, 0);
+    } else {
+        block.hashMerkleRoot = BlockMerkleRoot(block);
+    }
+}
+
+void IncrementExtraNonce(CBlock& block, const CBlockIndex* indexPrev, unsigned int& nExtraNonce, const std::vector<uint256>* pCoinbaseBranch)
 {
     // Update nExtraNonce
     static uint256 hashPrevBlock;
@@ -370,10 +513,10 @@ void IncrementExtraNonce(CBlock& block, const CBlockIndex* indexPrev, unsigned i
     // Set new transaction in block
     block.vtx[0] = MakeTransactionRef(std::move(txCoinbase));
     // Generate merkle root hash
-    block.hashMerkleRoot = BlockMerkleRoot(block);
+    UpdateMerkleRoot(block, pCoinbaseBranch);
 }
 
-void SetBlockPubkeyScript(CBlock& block, const CScript& scriptPubKeyIn)
+void SetBlockPubkeyScript(CBlock& block, const CScript& scriptPubKeyIn, const std::vector<uint256>* pCoinbaseBranch)
 {
     // Create copied transaction
     CMutableTransaction txCoinbase(*block.vtx[0]);
@@ -382,5 +525,5 @@ void SetBlockPubkeyScript(CBlock& block, const CScript& scriptPubKeyIn)
     //It should be added to the block
     block.vtx[0] = MakeTransactionRef(std::move(txCoinbase));
     // Generate merkle root hash
-    block.hashMerkleRoot = BlockMerkleRoot(block);
+    UpdateMerkleRoot(block, pCoinbaseBranch);
 }
@@ -10,8 +10,10 @@
 
 #include <atomic>
 #include <memory>
+#include <set>
 
 // #include "chain/chain.h"
+#include "consensus/merkle.h"
 #include "primitives/block.h"
 
 class CBlockIndex;
@@ -29,8 +31,19 @@ struct Params;
 static const bool DEFAULT_GENERATE = false;
 static const uint8_t DEFAULT_GENERATE_THREADS_CPU = 0;
 static const uint8_t DEFAULT_GENERATE_THREADS_GPU = 0;
+static const bool DEFAULT_MINER_HUGE_PAGES = false;
+static const unsigned int DEFAULT_MINER_BATCH_SIZE = 1;
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+// Templates older than this are rebuilt instead of updated, so mempool entries
+// UpdateBlockTemplate skipped (orphans, low fee, not yet final) get another look
+static const int64_t MINER_TEMPLATE_REBUILD_INTERVAL = 60;
+
+/** Transactions in a template and its merkle tree, only used to update the template */
+struct CBlockTemplateSelection {
+    std::set<uint256> setTxHashes; // mempool transactions in the block
+    CMerkleTree merkleTree;        // tree over block.vtx
+};
 
 struct CBlockTemplate {
     CBlock block;
@@ -38,18 +51,43 @@ struct CBlockTemplate {
     std::vector<int64_t> vTxSigOps;
     CTxOut txoutDynode;                 // dynode payment
     std::vector<CTxOut> voutSuperblock; // dynode payment
+
+    // Selection state used by UpdateBlockTemplate to extend the block
+    int nHeight = 0;
+    int64_t nLockTimeCutoff = 0;
+    uint64_t nBlockSize = 0;
+    unsigned int nBlockSigOps = 0;
+    int64_t nLastEntryTime = 0;     // newest mempool entry time considered
+    // Shared by copies of the template, so updating a copy doesn't duplicate
+    // it. The copy that was updated last is the only one it matches.
+    std::shared_ptr<CBlockTemplateSelection> selection = std::make_shared<CBlockTemplateSelection>();
+    // Hashes needed to recompute the merkle root from a modified coinbase
+    std::vector<uint256> vCoinbaseBranch;
 };
 
-/** Set pubkey script in generated block */
-void SetBlockPubkeyScript(CBlock& block, const CScript& scriptPubKeyIn);
+/**
+ * Set pubkey script in generated block. When the coinbase merkle branch of
+ * the template is given, the root is updated from it instead of rehashing
+ * the whole block.
+ */
+void SetBlockPubkeyScript(CBlock& block, const CScript& scriptPubKeyIn, const std::vector<uint256>* pCoinbaseBranch = nullptr);
 /** Generate a new block, without valid proof-of-work */
 std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript* scriptPubKeyIn = nullptr);
 std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn);
+/**
+ * Bring a template up to date with the mempool without rebuilding it: drops
+ * transactions that left the mempool (with their descendants in the block) and
+ * appends entries that arrived since the template was built or last updated.
+ * Only locks mempool.cs, the coinbase is left untouched. The template must
+ * still be on top of the current chain tip and be the copy of its selection
+ * that was updated last. Returns true if the block changed.
+ */
+bool UpdateBlockTemplate(CBlockTemplate& blocktemplate);
 /** Called by a miner when new block was found. */
 bool ProcessBlockFound(const CBlock& block, const CChainParams& chainparams);
 
-/** Modify the extranonce in a block */
-void IncrementExtraNonce(CBlock& pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
+/** Modify the extranonce in a block, see SetBlockPubkeyScript for pCoinbaseBranch */
+void IncrementExtraNonce(CBlock& pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce, const std::vector<uint256>* pCoinbaseBranch = nullptr);
 int64_t UpdateTime(CBlockHeader& pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
 #endif // DYNAMIC_MINER_UTIL_H
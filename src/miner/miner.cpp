@@ -71,6 +71,25 @@ int64_t GetGPUHashRate()
     return 0;
 };
 
+std::vector<HashRateCounterRef> GetHashRateCounters()
+{
+    std::vector<HashRateCounterRef> counters;
+    if (gMiners) {
+        counters.push_back(gMiners->group_cpu().counter());
+#ifdef ENABLE_GPU
+        counters.push_back(gMiners->group_gpu().counter());
+#endif // ENABLE_GPU
+    }
+    return counters;
+};
+
+std::shared_ptr<CBlockTemplate> RefreshMinersBlockTemplate(int64_t& block_version)
+{
+    if (gMiners)
+        return gMiners->RefreshBlockTemplate(block_version);
+    return nullptr;
+};
+
 void SetCPUMinerThreads(uint8_t target)
 {
     assert(gMiners);
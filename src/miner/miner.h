@@ -6,6 +6,7 @@
 #define DYNAMIC_MINER_H
 
 #include "miner-util.h" // IWYU pragma: keep
+#include "miner/internal/hash-rate-counter.h"
 
 class CConnman;
 class CChainParams;
@@ -32,6 +33,11 @@ int64_t GetHashRate();
 int64_t GetCPUHashRate();
 /** Gets hash rate of GPU */
 int64_t GetGPUHashRate();
+/** Gets hash rate counters of the CPU and GPU groups with their miner threads */
+std::vector<HashRateCounterRef> GetHashRateCounters();
+
+/** Refreshes and returns the miners block template, nullptr without miners */
+std::shared_ptr<CBlockTemplate> RefreshMinersBlockTemplate(int64_t& block_version);
 
 /** Sets amount of CPU miner threads */
 void SetCPUMinerThreads(uint8_t target);
@@ -0,0 +1,586 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "miner/stratum.h"
+#include "chainparams.h"
+#include "consensus/merkle.h"
+#include "miner/miner.h"
+#include "netbase.h"
+#include "streams.h"
+#include "timedata.h"
+#include "util.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+#include "validationinterface.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+
+#include <boost/thread.hpp>
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <event2/listener.h>
+#include <event2/thread.h>
+
+/** Maximum size of a request line, longer lines disconnect the client */
+static const size_t MAX_STRATUM_LINE_LENGTH = 16 * 1024;
+/** Minimum time between jobs that only add mempool transactions (seconds) */
+static const int64_t STRATUM_TX_JOB_INTERVAL = 10;
+/** Jobs that still accept shares */
+static const size_t MAX_STRATUM_JOBS = 16;
+/** Rejected shares and authorizations since the last accepted share before disconnecting */
+static const int MAX_STRATUM_REJECTED = 100;
+
+/** Stratum error codes */
+enum StratumErrorCode {
+    STRATUM_ERROR_OTHER = 20,
+    STRATUM_ERROR_JOB_NOT_FOUND = 21,
+    STRATUM_ERROR_DUPLICATE_SHARE = 22,
+    STRATUM_ERROR_LOW_DIFFICULTY = 23,
+    STRATUM_ERROR_UNAUTHORIZED = 24,
+    STRATUM_ERROR_NOT_SUBSCRIBED = 25,
+};
+
+CStratumJob::CStratumJob(const std::string& id, const std::shared_ptr<CBlockTemplate>& blocktemplate, const CScript& scriptPubKey,
+    size_t nMaxSharesIn)
+    : strId(id), pblocktemplate(blocktemplate), nMaxShares(nMaxSharesIn)
+{
+    CMutableTransaction txCoinbase(*pblocktemplate->block.vtx[0]);
+    txCoinbase.vout[0].scriptPubKey = scriptPubKey;
+
+    // Serialize the coinbase with two different extranonce placeholders,
+    // the extranonce starts at the first byte where they differ
+    std::vector<unsigned char> vchExtraNonce(STRATUM_EXTRANONCE1_SIZE + STRATUM_EXTRANONCE2_SIZE, 0x00);
+    txCoinbase.vin[0].scriptSig = (CScript() << pblocktemplate->nHeight << vchExtraNonce) + COINBASE_FLAGS;
+    CDataStream ssLow(SER_NETWORK, PROTOCOL_VERSION);
+    ssLow << txCoinbase;
+
+    std::fill(vchExtraNonce.begin(), vchExtraNonce.end(), 0xff);
+    txCoinbase.vin[0].scriptSig = (CScript() << pblocktemplate->nHeight << vchExtraNonce) + COINBASE_FLAGS;
+    CDataStream ssHigh(SER_NETWORK, PROTOCOL_VERSION);
+    ssHigh << txCoinbase;
+    assert(txCoinbase.vin[0].scriptSig.size() <= 100);
+
+    size_t nOffset = std::mismatch(ssLow.begin(), ssLow.end(), ssHigh.begin()).first - ssLow.begin();
+    vchCoinbase1.assign(ssLow.begin(), ssLow.begin() + nOffset);
+    vchCoinbase2.assign(ssLow.begin() + nOffset + vchExtraNonce.size(), ssLow.end());
+}
+
+const uint256& CStratumJob::GetPrevBlockHash() const
+{
+    return pblocktemplate->block.hashPrevBlock;
+}
+
+UniValue CStratumJob::GetNotifyParams(bool fCleanJobs) const
+{
+    const CBlock& block = pblocktemplate->block;
+    UniValue branch(UniValue::VARR);
+    for (const uint256& hash : pblocktemplate->vCoinbaseBranch) {
+        branch.push_back(HexStr(hash.begin(), hash.end()));
+    }
+
+    UniValue params(UniValue::VARR);
+    params.push_back(strId);
+    params.push_back(HexStr(block.hashPrevBlock.begin(), block.hashPrevBlock.end()));
+    params.push_back(HexStr(vchCoinbase1));
+    params.push_back(HexStr(vchCoinbase2));
+    params.push_back(branch);
+    params.push_back(strprintf("%08x", block.nVersion));
+    params.push_back(strprintf("%08x", block.nBits));
+    params.push_back(strprintf("%08x", block.nTime));
+    params.push_back(UniValue(fCleanJobs));
+    return params;
+}
+
+bool CStratumJob::BuildBlock(const std::vector<unsigned char>& vchExtraNonce1, const std::vector<unsigned char>& vchExtraNonce2,
+    uint32_t nTime, uint32_t nNonce, CBlock& block) const
+{
+    if (vchExtraNonce1.size() != STRATUM_EXTRANONCE1_SIZE || vchExtraNonce2.size() != STRATUM_EXTRANONCE2_SIZE)
+        return false;
+
+    std::vector<unsigned char> vchCoinbase(vchCoinbase1);
+    vchCoinbase.insert(vchCoinbase.end(), vchExtraNonce1.begin(), vchExtraNonce1.end());
+    vchCoinbase.insert(vchCoinbase.end(), vchExtraNonce2.begin(), vchExtraNonce2.end());
+    vchCoinbase.insert(vchCoinbase.end(), vchCoinbase2.begin(), vchCoinbase2.end());
+    CMutableTransaction txCoinbase;
+    try {
+        CDataStream ss(vchCoinbase, SER_NETWORK, PROTOCOL_VERSION);
+        ss >> txCoinbase;
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    block = pblocktemplate->block;
+    block.vtx[0] = MakeTransactionRef(std::move(txCoinbase));
+    block.hashMerkleRoot = ComputeMerkleRootFromBranch(block.vtx[0]->GetHash(), pblocktemplate->vCoinbaseBranch, 0);
+    block.nTime = nTime;
+    block.nNonce = nNonce;
+    return true;
+}
+
+StratumShareResult CStratumJob::CheckShare(const std::vector<unsigned char>& vchExtraNonce1, const std::vector<unsigned char>& vchExtraNonce2,
+    uint32_t nTime, uint32_t nNonce, const arith_uint256& shareTarget, CBlock& block, uint256& hash)
+{
+    // Same bounds the miners use, UpdateTime only moves forward
+    if (nTime < pblocktemplate->block.nTime || nTime > GetAdjustedTime() + 2 * 60 * 60)
+        return STRATUM_SHARE_INVALID;
+    if (!BuildBlock(vchExtraNonce1, vchExtraNonce2, nTime, nNonce, block))
+        return STRATUM_SHARE_INVALID;
+
+    hash = block.GetHash();
+    const arith_uint256 bnHash = UintToArith256(hash);
+    if (bnHash > shareTarget)
+        return STRATUM_SHARE_LOW_DIFFICULTY;
+    if (setShares.count(hash))
+        return STRATUM_SHARE_DUPLICATE;
+    if (setShares.size() >= nMaxShares)
+        return STRATUM_SHARE_JOB_FULL;
+    setShares.insert(hash);
+
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(block.nBits);
+    return bnHash <= bnTarget ? STRATUM_SHARE_BLOCK : STRATUM_SHARE_ACCEPTED;
+}
+
+arith_uint256 GetStratumShareTarget(const CChainParams& chainparams, int64_t nDifficulty)
+{
+    arith_uint256 target = UintToArith256(chainparams.GetConsensus().powLimit);
+    target /= arith_uint256(std::max<int64_t>(1, nDifficulty));
+    return target;
+}
+
+namespace
+{
+/** Connected stratum client, only touched from the event loop thread */
+struct StratumClient {
+    struct bufferevent* bev;
+    std::string strAddress;
+    std::vector<unsigned char> vchExtraNonce1;
+    std::string strWorker;
+    bool fSubscribed = false;
+    bool fAuthorized = false;
+    // rejected shares and authorizations since the last accepted share
+    int nRejected = 0;
+    bool fDisconnect = false;
+};
+} // namespace
+
+static struct event_base* stratumBase = nullptr;
+static struct evconnlistener* stratumListener = nullptr;
+static struct event* stratumJobEvent = nullptr;
+static boost::thread stratumThread;
+static boost::signals2::connection stratumBlockTipConnection;
+static boost::signals2::connection stratumTransactionConnection;
+
+static const CChainParams* pStratumParams = nullptr;
+static std::shared_ptr<CReserveScript> stratumCoinbaseScript;
+static int64_t nStratumDifficulty = DEFAULT_STRATUM_DIFFICULTY;
+static arith_uint256 stratumShareTarget;
+static std::string strStratumPassword;
+
+static std::map<struct bufferevent*, StratumClient> mapStratumClients;
+static std::deque<std::shared_ptr<CStratumJob> > dequeStratumJobs;
+static int64_t nStratumBlockVersion = 0;
+static std::atomic<int64_t> nStratumJobTime{0};
+static uint64_t nStratumNextJobId = 0;
+static uint32_t nStratumNextExtraNonce1 = 0;
+
+static void StratumSend(StratumClient& client, const UniValue& message)
+{
+    std::string str = message.write() + "\n";
+    bufferevent_write(client.bev, str.data(), str.size());
+}
+
+static UniValue StratumReply(const UniValue& id, const UniValue& result, const UniValue& error)
+{
+    UniValue reply(UniValue::VOBJ);
+    reply.push_back(Pair("id", id));
+    reply.push_back(Pair("result", result));
+    reply.push_back(Pair("error", error));
+    return reply;
+}
+
+static UniValue StratumError(int code, const std::string& message)
+{
+    UniValue error(UniValue::VARR);
+    error.push_back(code);
+    error.push_back(message);
+    error.push_back(NullUniValue);
+    return error;
+}
+
+static UniValue StratumNotification(const std::string& method, const UniValue& params)
+{
+    UniValue notification(UniValue::VOBJ);
+    notification.push_back(Pair("id", NullUniValue));
+    notification.push_back(Pair("method", method));
+    notification.push_back(Pair("params", params));
+    return notification;
+}
+
+static void StratumSendDifficulty(StratumClient& client)
+{
+    UniValue params(UniValue::VARR);
+    params.push_back(nStratumDifficulty);
+    StratumSend(client, StratumNotification("mining.set_difficulty", params));
+}
+
+static bool ParseStratumHex(const UniValue& value, size_t size, std::vector<unsigned char>& vch)
+{
+    if (!value.isStr() || value.get_str().size() != 2 * size || !IsHex(value.get_str()))
+        return false;
+    vch = ParseHex(value.get_str());
+    return true;
+}
+
+static bool ParseStratumUInt32(const UniValue& value, uint32_t& n)
+{
+    std::vector<unsigned char> vch;
+    if (!ParseStratumHex(value, 4, vch))
+        return false;
+    n = (uint32_t(vch[0]) << 24) | (uint32_t(vch[1]) << 16) | (uint32_t(vch[2]) << 8) | uint32_t(vch[3]);
+    return true;
+}
+
+static void StratumReject(StratumClient& client)
+{
+    // Every share is hashed with Argon2d, don't let a client keep us busy with bad ones
+    if (++client.nRejected > MAX_STRATUM_REJECTED) {
+        LogPrintf("stratum: Disconnecting %s because of too many rejected requests\n", client.strAddress);
+        client.fDisconnect = true;
+    }
+}
+
+static UniValue StratumSubmit(StratumClient& client, const UniValue& params)
+{
+    if (!client.fAuthorized)
+        return StratumError(STRATUM_ERROR_UNAUTHORIZED, "Unauthorized worker");
+    if (params.size() < 5 || !params[1].isStr())
+        return StratumError(STRATUM_ERROR_OTHER, "Invalid params");
+
+    std::shared_ptr<CStratumJob> job;
+    for (const std::shared_ptr<CStratumJob>& it : dequeStratumJobs) {
+        if (it->GetId() == params[1].get_str())
+            job = it;
+    }
+    if (!job)
+        return StratumError(STRATUM_ERROR_JOB_NOT_FOUND, "Job not found");
+
+    std::vector<unsigned char> vchExtraNonce2;
+    uint32_t nTime, nNonce;
+    if (!ParseStratumHex(params[2], STRATUM_EXTRANONCE2_SIZE, vchExtraNonce2) ||
+        !ParseStratumUInt32(params[3], nTime) || !ParseStratumUInt32(params[4], nNonce))
+        return StratumError(STRATUM_ERROR_OTHER, "Invalid params");
+
+    CBlock block;
+    uint256 hash;
+    switch (job->CheckShare(client.vchExtraNonce1, vchExtraNonce2, nTime, nNonce, stratumShareTarget, block, hash)) {
+    case STRATUM_SHARE_INVALID:
+        StratumReject(client);
+        return StratumError(STRATUM_ERROR_OTHER, "Invalid share");
+    case STRATUM_SHARE_DUPLICATE:
+        StratumReject(client);
+        return StratumError(STRATUM_ERROR_DUPLICATE_SHARE, "Duplicate share");
+    case STRATUM_SHARE_LOW_DIFFICULTY:
+        StratumReject(client);
+        return StratumError(STRATUM_ERROR_LOW_DIFFICULTY, "Low difficulty share");
+    case STRATUM_SHARE_JOB_FULL:
+        return StratumError(STRATUM_ERROR_OTHER, "Job has too many shares");
+    case STRATUM_SHARE_BLOCK:
+        LogPrintf("stratum: block found by %s (%s)\n  hash: %s\n", client.strWorker, client.strAddress, hash.GetHex());
+        if (ProcessBlockFound(block, *pStratumParams))
+            stratumCoinbaseScript->KeepScript();
+        break;
+    case STRATUM_SHARE_ACCEPTED:
+        break;
+    }
+    client.nRejected = 0;
+    LogPrint("stratum", "stratum: share from %s accepted for job %s\n", client.strWorker, job->GetId());
+    return NullUniValue;
+}
+
+static void StratumProcessRequest(StratumClient& client, const std::string& line)
+{
+    UniValue request;
+    if (!request.read(line) || !request.isObject()) {
+        StratumSend(client, StratumReply(NullUniValue, NullUniValue, StratumError(STRATUM_ERROR_OTHER, "Parse error")));
+        return;
+    }
+    const UniValue& id = find_value(request, "id");
+    const UniValue& method = find_value(request, "method");
+    const UniValue& params = find_value(request, "params");
+    if (!method.isStr() || !params.isArray()) {
+        StratumSend(client, StratumReply(id, NullUniValue, StratumError(STRATUM_ERROR_OTHER, "Invalid request")));
+        return;
+    }
+
+    if (method.get_str() == "mining.subscribe") {
+        UniValue subscriptions(UniValue::VARR);
+        for (const char* notification : {"mining.set_difficulty", "mining.notify"}) {
+            UniValue subscription(UniValue::VARR);
+            subscription.push_back(notification);
+            subscription.push_back(HexStr(client.vchExtraNonce1));
+            subscriptions.push_back(subscription);
+        }
+        UniValue result(UniValue::VARR);
+        result.push_back(subscriptions);
+        result.push_back(HexStr(client.vchExtraNonce1));
+        result.push_back((int)STRATUM_EXTRANONCE2_SIZE);
+        client.fSubscribed = true;
+        StratumSend(client, StratumReply(id, result, NullUniValue));
+        StratumSendDifficulty(client);
+        if (!dequeStratumJobs.empty())
+            StratumSend(client, StratumNotification("mining.notify", dequeStratumJobs.back()->GetNotifyParams(true)));
+    } else if (method.get_str() == "mining.authorize") {
+        if (params.size() < 1 || !params[0].isStr()) {
+            StratumSend(client, StratumReply(id, NullUniValue, StratumError(STRATUM_ERROR_OTHER, "Invalid params")));
+            return;
+        }
+        // Shares are paid to the node wallet, workers are only named for logging
+        // and the password keeps others from mining on it
+        if (!strStratumPassword.empty() && (params.size() < 2 || !params[1].isStr() ||
+                                               !TimingResistantEqual(params[1].get_str(), strStratumPassword))) {
+            LogPrintf("stratum: %s failed to authorize worker %s\n", client.strAddress, params[0].get_str());
+            StratumReject(client);
+            StratumSend(client, StratumReply(id, false, StratumError(STRATUM_ERROR_UNAUTHORIZED, "Unauthorized worker")));
+            return;
+        }
+        client.strWorker = params[0].get_str();
+        client.fAuthorized = true;
+        StratumSend(client, StratumReply(id, true, NullUniValue));
+    } else if (method.get_str() == "mining.submit") {
+        UniValue error = client.fSubscribed ? StratumSubmit(client, params) : StratumError(STRATUM_ERROR_NOT_SUBSCRIBED, "Not subscribed");
+        StratumSend(client, StratumReply(id, error.isNull(), error));
+    } else {
+        StratumSend(client, StratumReply(id, NullUniValue, StratumError(STRATUM_ERROR_OTHER, "Method not found")));
+    }
+}
+
+static void StratumDisconnect(struct bufferevent* bev)
+{
+    std::map<struct bufferevent*, StratumClient>::iterator it = mapStratumClients.find(bev);
+    if (it != mapStratumClients.end()) {
+        LogPrint("stratum", "stratum: %s disconnected\n", it->second.strAddress);
+        mapStratumClients.erase(it);
+    }
+    bufferevent_free(bev);
+}
+
+static void StratumReadCallback(struct bufferevent* bev, void* ctx)
+{
+    std::map<struct bufferevent*, StratumClient>::iterator it = mapStratumClients.find(bev);
+    assert(it != mapStratumClients.end());
+    struct evbuffer* input = bufferevent_get_input(bev);
+    size_t n_read_out = 0;
+    char* line;
+    while ((line = evbuffer_readln(input, &n_read_out, EVBUFFER_EOL_CRLF)) != NULL) {
+        std::string s(line, n_read_out);
+        free(line);
+        if (!s.empty())
+            StratumProcessRequest(it->second, s);
+        if (it->second.fDisconnect) {
+            StratumDisconnect(bev);
+            return;
+        }
+    }
+    // Everything left is an incomplete line
+    if (evbuffer_get_length(input) > MAX_STRATUM_LINE_LENGTH) {
+        LogPrintf("stratum: Disconnecting %s because MAX_STRATUM_LINE_LENGTH exceeded\n", it->second.strAddress);
+        StratumDisconnect(bev);
+    }
+}
+
+static void StratumEventCallback(struct bufferevent* bev, short what, void* ctx)
+{
+    if (what & (BEV_EVENT_EOF | BEV_EVENT_ERROR))
+        StratumDisconnect(bev);
+}
+
+static void StratumAcceptCallback(struct evconnlistener* listener, evutil_socket_t fd, struct sockaddr* address, int socklen, void* ctx)
+{
+    struct bufferevent* bev = bufferevent_socket_new(stratumBase, fd, BEV_OPT_CLOSE_ON_FREE);
+    if (!bev) {
+        evutil_closesocket(fd);
+        return;
+    }
+    CService addr;
+    addr.SetSockAddr(address);
+
+    // Each connection gets its own extranonce1, so clients never
+    // search the same coinbase space
+    StratumClient& client = mapStratumClients[bev];
+    client.bev = bev;
+    client.strAddress = addr.ToString();
+    const uint32_t nExtraNonce1 = nStratumNextExtraNonce1++;
+    for (unsigned int i = 0; i < STRATUM_EXTRANONCE1_SIZE; i++) {
+        client.vchExtraNonce1.push_back((nExtraNonce1 >> (8 * (STRATUM_EXTRANONCE1_SIZE - 1 - i))) & 0xff);
+    }
+    LogPrint("stratum", "stratum: %s connected\n", client.strAddress);
+
+    bufferevent_setcb(bev, StratumReadCallback, NULL, StratumEventCallback, NULL);
+    bufferevent_enable(bev, EV_READ | EV_WRITE);
+}
+
+static void StratumJobCallback(evutil_socket_t fd, short what, void* ctx)
+{
+    if (IsInitialBlockDownload())
+        return;
+
+    int64_t block_version = 0;
+    std::shared_ptr<CBlockTemplate> pblocktemplate;
+    try {
+        pblocktemplate = RefreshMinersBlockTemplate(block_version);
+    } catch (const std::exception& e) {
+        LogPrintf("stratum: unable to refresh block template: %s\n", e.what());
+        return;
+    }
+    if (!pblocktemplate || block_version == nStratumBlockVersion)
+        return;
+
+    // New blocks are pushed right away, mempool updates at most every STRATUM_TX_JOB_INTERVAL
+    const bool fClean = dequeStratumJobs.empty() || dequeStratumJobs.back()->GetPrevBlockHash() != pblocktemplate->block.hashPrevBlock;
+    const int64_t nWait = nStratumJobTime + STRATUM_TX_JOB_INTERVAL - GetTime();
+    if (!fClean && nWait > 0) {
+        struct timeval tv = {(long)nWait, 0};
+        event_add(stratumJobEvent, &tv);
+        return;
+    }
+    nStratumBlockVersion = block_version;
+    nStratumJobTime = GetTime();
+
+    std::shared_ptr<CStratumJob> job = std::make_shared<CStratumJob>(strprintf("%x", nStratumNextJobId++), pblocktemplate, stratumCoinbaseScript->reserveScript);
+    if (fClean)
+        dequeStratumJobs.clear();
+    if (dequeStratumJobs.size() >= MAX_STRATUM_JOBS)
+        dequeStratumJobs.pop_front();
+    dequeStratumJobs.push_back(job);
+
+    const UniValue notification = StratumNotification("mining.notify", job->GetNotifyParams(fClean));
+    for (std::pair<struct bufferevent* const, StratumClient>& it : mapStratumClients) {
+        if (it.second.fSubscribed)
+            StratumSend(it.second, notification);
+    }
+    LogPrint("stratum", "stratum: job %s with %u transactions sent to %u clients\n", job->GetId(),
+        pblocktemplate->block.vtx.size(), mapStratumClients.size());
+}
+
+static void StratumUpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    // New blocks are sent to the clients right away
+    if (!fInitialDownload)
+        event_active(stratumJobEvent, EV_TIMEOUT, 0);
+}
+
+static void StratumSyncTransaction(const CTransaction& tx, const CBlockIndex* pindex, int posInBlock)
+{
+    // Mempool changes are collected into one job every STRATUM_TX_JOB_INTERVAL
+    if (pindex || event_pending(stratumJobEvent, EV_TIMEOUT, NULL))
+        return;
+    struct timeval tv = {(long)std::max<int64_t>(0, nStratumJobTime + STRATUM_TX_JOB_INTERVAL - GetTime()), 0};
+    event_add(stratumJobEvent, &tv);
+}
+
+static void ThreadStratum()
+{
+    event_base_dispatch(stratumBase);
+}
+
+bool StartStratumServer(const CChainParams& chainparams)
+{
+    assert(!stratumBase);
+    pStratumParams = &chainparams;
+
+    GetMainSignals().ScriptForMining(stratumCoinbaseScript);
+    if (!stratumCoinbaseScript || stratumCoinbaseScript->reserveScript.empty()) {
+        LogPrintf("stratum: No coinbase script available (stratum requires a wallet)\n");
+        return false;
+    }
+    nStratumDifficulty = GetArg("-stratumdifficulty", DEFAULT_STRATUM_DIFFICULTY);
+    if (nStratumDifficulty < 1) {
+        LogPrintf("stratum: Invalid -stratumdifficulty %d\n", nStratumDifficulty);
+        return false;
+    }
+    stratumShareTarget = GetStratumShareTarget(chainparams, nStratumDifficulty);
+    strStratumPassword = GetArg("-stratumpassword", "");
+
+    const int port = GetArg("-stratumport", DEFAULT_STRATUM_PORT);
+    CService addrBind;
+    if (!Lookup(GetArg("-stratumbind", DEFAULT_STRATUM_BIND).c_str(), addrBind, port, false)) {
+        LogPrintf("stratum: Invalid -stratumbind address\n");
+        return false;
+    }
+    // Anyone who can connect may mine on the wallet, only loopback is open without a password
+    const bool fLoopback = addrBind.IsLocal() && !(addrBind.IsIPv4() && addrBind.GetByte(3) == 0);
+    if (strStratumPassword.empty() && !fLoopback) {
+        LogPrintf("stratum: -stratumpassword is required to bind to %s\n", addrBind.ToString());
+        return false;
+    }
+    struct sockaddr_storage sockaddr;
+    socklen_t len = sizeof(sockaddr);
+    if (!addrBind.GetSockAddr((struct sockaddr*)&sockaddr, &len)) {
+        LogPrintf("stratum: Unable to bind to %s\n", addrBind.ToString());
+        return false;
+    }
+
+#ifdef WIN32
+    evthread_use_windows_threads();
+#else
+    evthread_use_pthreads();
+#endif
+    stratumBase = event_base_new();
+    if (!stratumBase) {
+        LogPrintf("stratum: Unable to create event_base\n");
+        return false;
+    }
+    stratumListener = evconnlistener_new_bind(stratumBase, StratumAcceptCallback, NULL,
+        LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE, -1, (struct sockaddr*)&sockaddr, len);
+    if (!stratumListener) {
+        LogPrintf("stratum: Unable to listen on %s\n", addrBind.ToString());
+        event_base_free(stratumBase);
+        stratumBase = nullptr;
+        return false;
+    }
+    // Jobs are created when the tip or the mempool changes, starting with one right away
+    stratumJobEvent = event_new(stratumBase, -1, 0, StratumJobCallback, NULL);
+    event_active(stratumJobEvent, EV_TIMEOUT, 0);
+    stratumBlockTipConnection = GetMainSignals().UpdatedBlockTip.connect(&StratumUpdatedBlockTip);
+    stratumTransactionConnection = GetMainSignals().SyncTransaction.connect(&StratumSyncTransaction);
+
+    LogPrintf("stratum: listening on %s, share difficulty %d\n", addrBind.ToString(), nStratumDifficulty);
+    stratumThread = boost::thread(boost::bind(&TraceThread<void (*)()>, "stratum", &ThreadStratum));
+    return true;
+}
+
+void InterruptStratumServer()
+{
+    if (stratumBase) {
+        LogPrintf("stratum: Thread interrupt\n");
+        event_base_loopbreak(stratumBase);
+    }
+}
+
+void StopStratumServer()
+{
+    if (stratumBase) {
+        stratumBlockTipConnection.disconnect();
+        stratumTransactionConnection.disconnect();
+        event_base_loopbreak(stratumBase);
+        stratumThread.join();
+        for (std::pair<struct bufferevent* const, StratumClient>& it : mapStratumClients) {
+            bufferevent_free(it.first);
+        }
+        mapStratumClients.clear();
+        dequeStratumJobs.clear();
+        event_free(stratumJobEvent);
+        stratumJobEvent = nullptr;
+        evconnlistener_free(stratumListener);
+        stratumListener = nullptr;
+        event_base_free(stratumBase);
+        stratumBase = nullptr;
+        stratumCoinbaseScript.reset();
+    }
+}
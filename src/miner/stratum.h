@@ -0,0 +1,96 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_MINER_STRATUM_H
+#define DYNAMIC_MINER_STRATUM_H
+
+#include "arith_uint256.h"
+#include "script/script.h"
+#include "uint256.h"
+
+#include <univalue.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CChainParams;
+struct CBlockTemplate;
+
+static const int DEFAULT_STRATUM_PORT = 0;
+static const char* const DEFAULT_STRATUM_BIND = "127.0.0.1";
+/** Share difficulty, shares must meet powLimit / difficulty */
+static const int64_t DEFAULT_STRATUM_DIFFICULTY = 1;
+/** Extranonce bytes assigned by the server to each connection */
+static const unsigned int STRATUM_EXTRANONCE1_SIZE = 4;
+/** Extranonce bytes rolled by the client */
+static const unsigned int STRATUM_EXTRANONCE2_SIZE = 4;
+/** Shares remembered per job to detect duplicates, further shares are rejected */
+static const size_t MAX_STRATUM_JOB_SHARES = 65536;
+
+/** Outcome of checking a submitted share */
+enum StratumShareResult {
+    STRATUM_SHARE_INVALID,        //!< malformed fields or time out of range
+    STRATUM_SHARE_DUPLICATE,      //!< already submitted for this job
+    STRATUM_SHARE_LOW_DIFFICULTY, //!< hash above the share target
+    STRATUM_SHARE_JOB_FULL,       //!< job already recorded its maximum of shares
+    STRATUM_SHARE_ACCEPTED,       //!< valid share
+    STRATUM_SHARE_BLOCK,          //!< valid share that also meets the block target
+};
+
+/**
+ * Stratum job built from a miners block template.
+ *
+ * The coinbase is paid to scriptPubKey and its scriptSig is
+ * <height> <extranonce1 || extranonce2>, so it is sent split around the
+ * extranonce as coinb1 and coinb2. Together with the template coinbase merkle
+ * branch clients rebuild the merkle root for every extranonce2 they roll.
+ *
+ * Hashes (prevhash, branch) are sent as the hex of their bytes in block header
+ * order; version, nbits, ntime and nonce as 8 digit hex numbers.
+ */
+class CStratumJob
+{
+public:
+    CStratumJob(const std::string& id, const std::shared_ptr<CBlockTemplate>& blocktemplate, const CScript& scriptPubKey,
+        size_t nMaxSharesIn = MAX_STRATUM_JOB_SHARES);
+
+    const std::string& GetId() const { return strId; }
+    const uint256& GetPrevBlockHash() const;
+
+    /** Params of the mining.notify message for this job */
+    UniValue GetNotifyParams(bool fCleanJobs) const;
+
+    /** Assemble the block a share was mined on, false if the fields are malformed */
+    bool BuildBlock(const std::vector<unsigned char>& vchExtraNonce1, const std::vector<unsigned char>& vchExtraNonce2,
+        uint32_t nTime, uint32_t nNonce, CBlock& block) const;
+
+    /** Check a share against shareTarget and the block target, block is set on success.
+     *  Only shares meeting shareTarget are recorded for duplicate detection. */
+    StratumShareResult CheckShare(const std::vector<unsigned char>& vchExtraNonce1, const std::vector<unsigned char>& vchExtraNonce2,
+        uint32_t nTime, uint32_t nNonce, const arith_uint256& shareTarget, CBlock& block, uint256& hash);
+
+private:
+    std::string strId;
+    std::shared_ptr<CBlockTemplate> pblocktemplate;
+    std::vector<unsigned char> vchCoinbase1;
+    std::vector<unsigned char> vchCoinbase2;
+    // hashes of the accepted shares, at most nMaxShares
+    std::set<uint256> setShares;
+    size_t nMaxShares;
+};
+
+/** Share target for a stratum difficulty */
+arith_uint256 GetStratumShareTarget(const CChainParams& chainparams, int64_t nDifficulty);
+
+/** Start the stratum server on -stratumport, serving the miners block template */
+bool StartStratumServer(const CChainParams& chainparams);
+/** Interrupt the stratum server event loop */
+void InterruptStratumServer();
+/** Stop the stratum server and close all connections */
+void StopStratumServer();
+
+#endif // DYNAMIC_MINER_STRATUM_H
@@ -11,9 +11,56 @@
 #include "tinyformat.h"
 #include "utilstrencodings.h"
 
+CBlockHeaderHashCache::CBlockHeaderHashCache(const CBlockHeaderHashCache& other) : fValid(false)
+{
+    *this = other;
+}
+
+CBlockHeaderHashCache& CBlockHeaderHashCache::operator=(const CBlockHeaderHashCache& other)
+{
+    if (this == &other)
+        return *this;
+    std::lock(mutex, other.mutex);
+    std::lock_guard<std::mutex> lock(mutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lockOther(other.mutex, std::adopt_lock);
+    fValid = other.fValid;
+    memcpy(vchHeader, other.vchHeader, sizeof(vchHeader));
+    hash = other.hash;
+    return *this;
+}
+
+bool CBlockHeaderHashCache::Get(const unsigned char* pheader, uint256& hashOut) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fValid || memcmp(vchHeader, pheader, sizeof(vchHeader)) != 0)
+        return false;
+    hashOut = hash;
+    return true;
+}
+
+void CBlockHeaderHashCache::Set(const unsigned char* pheader, const uint256& hashIn) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memcpy(vchHeader, pheader, sizeof(vchHeader));
+    hash = hashIn;
+    fValid = true;
+}
+
 uint256 CBlockHeader::GetHash() const
 {
-    return hash_Argon2d(BEGIN(nVersion), END(nNonce), 1);
+    static_assert(offsetof(CBlockHeader, nNonce) + sizeof(nNonce) - offsetof(CBlockHeader, nVersion) == BLOCK_HEADER_HASHED_SIZE, "hashed header fields must be contiguous");
+    const unsigned char* pheader = (const unsigned char*)BEGIN(nVersion);
+    uint256 hash;
+    if (hashCache.Get(pheader, hash))
+        return hash;
+    hash = hash_Argon2d(BEGIN(nVersion), END(nNonce), 1);
+    hashCache.Set(pheader, hash);
+    return hash;
+}
+
+uint256 CBlockHeader::GetHash(CArgon2dContext& ctx) const
+{
+    return ctx.Hash(BEGIN(nVersion), END(nNonce) - BEGIN(nVersion), 1);
 }
 
 std::string CBlock::ToString() const
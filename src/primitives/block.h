@@ -12,6 +12,36 @@
 #include "uint256.h"
 #include "utilstrencodings.h"
 
+#include <mutex>
+
+/** Size of the header fields hashed for proof of work (nVersion .. nNonce) */
+static const size_t BLOCK_HEADER_HASHED_SIZE = 80;
+
+/**
+ * Memoized proof-of-work hash of a block header.
+ *
+ * Argon2d is far too expensive to recompute every time a block is looked up,
+ * logged or relayed. The cache remembers the header bytes it was computed
+ * from, so any later change of a header field simply invalidates it.
+ */
+class CBlockHeaderHashCache
+{
+public:
+    CBlockHeaderHashCache() : fValid(false) {}
+    CBlockHeaderHashCache(const CBlockHeaderHashCache& other);
+    CBlockHeaderHashCache& operator=(const CBlockHeaderHashCache& other);
+
+    /** Returns true and sets hashOut if the hash of these header bytes is cached */
+    bool Get(const unsigned char* pheader, uint256& hashOut) const;
+    void Set(const unsigned char* pheader, const uint256& hashIn) const;
+
+private:
+    mutable std::mutex mutex;
+    mutable bool fValid;
+    mutable unsigned char vchHeader[BLOCK_HEADER_HASHED_SIZE];
+    mutable uint256 hash;
+};
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -30,6 +60,9 @@ public:
     uint32_t nBits;
     uint32_t nNonce;
 
+    // memory only
+    CBlockHeaderHashCache hashCache;
+
     CBlockHeader()
     {
         SetNull();
@@ -63,8 +96,12 @@ public:
         return (nBits == 0);
     }
 
+    /** Proof-of-work hash, memoized until a header field changes */
     uint256 GetHash() const;
 
+    /** Computes the hash reusing the Argon2d memory arena of ctx (mining, never memoized) */
+    uint256 GetHash(CArgon2dContext& ctx) const;
+
     int64_t GetBlockTime() const
     {
         return (int64_t)nTime;
@@ -121,6 +158,7 @@ public:
         block.nTime = nTime;
         block.nBits = nBits;
         block.nNonce = nNonce;
+        block.hashCache = hashCache;
         return block;
     }
 
@@ -61,6 +61,14 @@ void CPSNotificationInterface::UpdatedBlockTip(const CBlockIndex* pindexNew, con
 
 void CPSNotificationInterface::SyncTransaction(const CTransaction& tx, const CBlockIndex* pindex, int posInBlock)
 {
+    // Disconnected blocks come with the block before them
+    if (!fLiteMode && tx.IsCoinBase() && pindex) {
+        if (posInBlock == CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK)
+            dnpayments.BlockDisconnected(pindex->nHeight + 1);
+        else
+            dnpayments.BlockConnected(tx, pindex);
+    }
+
     instantsend.SyncTransaction(tx, pindex, posInBlock);
     CPrivateSend::SyncTransaction(tx, pindex, posInBlock);
 }
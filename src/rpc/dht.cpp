@@ -67,7 +67,7 @@ static UniValue GetMutable(const JSONRPCRequest& request)
     std::array<char, 32> pubKey;
     libtorrent::aux::from_hex(strPubKey, pubKey.data());
     bool fAuthoritative;
-    fRet = DHT::SubmitGet(0, pubKey, strSalt, 2000, strValue, iSequence, fAuthoritative);
+    fRet = DHT::SubmitGet(pubKey, strSalt, 2000, strValue, iSequence, fAuthoritative);
     if (fRet) {
         result.push_back(Pair("Public Key", strPubKey));
         result.push_back(Pair("Salt", strSalt));
@@ -141,7 +141,7 @@ static UniValue PutMutable(const JSONRPCRequest& request)
     if (!fNewEntry) {
         std::string strGetLastValue;
         // we need the last sequence number to update an existing DHT entry.
-        DHT::SubmitGet(0, pubKey, strOperationType, 2000, strGetLastValue, iSequence, fAuthoritative);
+        DHT::SubmitGet(pubKey, strOperationType, 2000, strGetLastValue, iSequence, fAuthoritative);
         iSequence++;
     }
     uint16_t nTotalSlots = 32;
@@ -350,9 +350,9 @@ static UniValue PutRecord(const JSONRPCRequest& request)
     int64_t iSequence = 0;
     bool fAuthoritative = false;
     std::string strHeaderHex;
-    std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
+    std::string strHeaderSalt = GetChunkSalt(strOperationType, 0);
     // we need the last sequence number to update an existing DHT entry. 
-    DHT::SubmitGet(0, getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
+    DHT::SubmitGet(getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
     CRecordHeader header(strHeaderHex);
     if (header.nUnlockTime  > GetTime())
         throw JSONRPCError(RPC_DHT_RECORD_LOCKED, strprintf("DHT data entry is locked for another %lli seconds", (header.nUnlockTime  - GetTime())));
@@ -453,9 +453,9 @@ static UniValue ClearRecord(const JSONRPCRequest& request)
     int64_t iSequence = 0;
     bool fAuthoritative = false;
     std::string strHeaderHex;
-    std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
+    std::string strHeaderSalt = GetChunkSalt(strOperationType, 0);
     // we need the last sequence number to update an existing DHT entry. 
-    DHT::SubmitGet(0, getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
+    DHT::SubmitGet(getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
     CRecordHeader header(strHeaderHex);
 
     if (header.nUnlockTime  > GetTime())
@@ -543,7 +543,7 @@ static UniValue GetRecord(const JSONRPCRequest& request)
     std::array<char, 32> arrPubKey;
     libtorrent::aux::from_hex(strPubKey, arrPubKey.data());
     CDataRecord record;
-    if (!DHT::SubmitGetRecord(0, arrPubKey, getKey.GetDHTPrivSeed(), strOperationType, iSequence, record))
+    if (!DHT::SubmitGetRecord(arrPubKey, getKey.GetDHTPrivSeed(), strOperationType, iSequence, record))
         throw JSONRPCError(RPC_DHT_GET_FAILED, strprintf("Failed to get record"));
 
     result.push_back(Pair("get_seq", iSequence));
@@ -642,7 +642,7 @@ UniValue dhtgetmessages(const JSONRPCRequest& request)
     UniValue result(UniValue::VOBJ);
 
     std::vector<CMutableGetEvent> vchMutableData;
-    bool fRet = DHT::GetAllDHTGetEvents(0, vchMutableData);
+    bool fRet = DHT::GetAllDHTGetEvents(vchMutableData);
     int nCounter = 0;
     if (fRet) {
         for(const CMutableGetEvent& data : vchMutableData) {
@@ -770,7 +770,7 @@ static UniValue GetLinkRecord(const JSONRPCRequest& request)
     std::array<char, 32> arrPubKey;
     libtorrent::aux::from_hex(strPubKey, arrPubKey.data());
     CDataRecord record;
-    if (!DHT::SubmitGetRecord(0, arrPubKey, getKey.GetDHTPrivSeed(), strOperationType, iSequence, record))
+    if (!DHT::SubmitGetRecord(arrPubKey, getKey.GetDHTPrivSeed(), strOperationType, iSequence, record))
         throw JSONRPCError(RPC_DHT_GET_FAILED, strprintf("Failed to get record"));
 
     result.push_back(Pair("get_seq", iSequence));
@@ -848,7 +848,7 @@ static UniValue GetAllLinkRecords(const JSONRPCRequest& request)
     }
 
     std::vector<CDataRecord> vchRecords;
-    if (!DHT::SubmitGetAllRecordsSync(0, vchLinkInfo, strOperationType, vchRecords))
+    if (!DHT::SubmitGetAllRecordsSync(vchLinkInfo, strOperationType, vchRecords))
         throw JSONRPCError(RPC_DHT_GET_FAILED, strprintf("Failed to get records"));
 
     int nRecordItem = 1;
@@ -962,8 +962,8 @@ static UniValue PutLinkRecord(const JSONRPCRequest& request)
     std::string strHeaderHex;
 
     // we need the last sequence number to update an existing DHT entry.
-    std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
-    DHT::SubmitGet(0, getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
+    std::string strHeaderSalt = GetChunkSalt(strOperationType, 0);
+    DHT::SubmitGet(getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
     CRecordHeader header(strHeaderHex);
     if (header.nUnlockTime  > GetTime())
         throw JSONRPCError(RPC_DHT_RECORD_LOCKED, strprintf("DHT data entry is locked for another %lli seconds", (header.nUnlockTime  - GetTime())));
@@ -1090,8 +1090,8 @@ static UniValue ClearLinkRecord(const JSONRPCRequest& request)
     std::string strHeaderHex;
 
     // we need the last sequence number to update an existing DHT entry.
-    std::string strHeaderSalt = strOperationType + ":" + std::to_string(0);
-    DHT::SubmitGet(0, getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
+    std::string strHeaderSalt = GetChunkSalt(strOperationType, 0);
+    DHT::SubmitGet(getKey.GetDHTPubKey(), strHeaderSalt, 2000, strHeaderHex, iSequence, fAuthoritative);
     CRecordHeader header(strHeaderHex);
 
     if (header.nUnlockTime  > GetTime())
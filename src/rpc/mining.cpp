@@ -197,7 +197,7 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Couldn't create new block");
         {
             LOCK(cs_main);
-            IncrementExtraNonce(pblocktemplate->block, chainActive.Tip(), nExtraNonce);
+            IncrementExtraNonce(pblocktemplate->block, chainActive.Tip(), nExtraNonce, &pblocktemplate->vCoinbaseBranch);
         }
         CBlock* pblock = &pblocktemplate->block;
         while (!CheckProofOfWork(pblock->GetHash(), pblock->nBits, Params().GetConsensus())) {
@@ -400,6 +400,76 @@ UniValue getgpuhashespersec(const JSONRPCRequest& request)
     return GetGPUHashRate();
 }
 
+static UniValue HashRateCounterToJSON(const HashRateCounterRef& counter)
+{
+    UniValue rates(UniValue::VOBJ);
+    rates.push_back(Pair("10s", counter->GetRate(10)));
+    rates.push_back(Pair("60s", counter->GetRate(60)));
+    rates.push_back(Pair("15m", counter->GetRate(15 * 60)));
+
+    UniValue latency(UniValue::VARR);
+    std::vector<uint64_t> histogram = counter->GetLatencyHistogram();
+    for (size_t i = 0; i < histogram.size(); i++) {
+        if (histogram[i] == 0)
+            continue;
+        UniValue bucket(UniValue::VOBJ);
+        bucket.push_back(Pair("below_us", (int64_t(1) << i)));
+        bucket.push_back(Pair("count", (uint64_t)histogram[i]));
+        latency.push_back(bucket);
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("device", counter->label()));
+    obj.push_back(Pair("hashespersec", rates));
+    obj.push_back(Pair("hashes", counter->total()));
+    obj.push_back(Pair("latency", latency));
+    return obj;
+}
+
+UniValue getminingstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getminingstats\n"
+            "\nReturns hash rates and TryMineBlock latency histograms of every miner device group and thread.\n"
+            "See the getgenerate and setgenerate calls to turn generation on and off.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"device\": \"xxxx\",         (string) The device group (CPU, GPU)\n"
+            "    \"hashespersec\": {          (json object) Average hashes per second over the last\n"
+            "      \"10s\": n,                (numeric) 10 seconds\n"
+            "      \"60s\": n,                (numeric) minute\n"
+            "      \"15m\": n                 (numeric) 15 minutes\n"
+            "    },\n"
+            "    \"hashes\": n,               (numeric) The hashes done since the group was started\n"
+            "    \"latency\": [               (json array) Histogram of TryMineBlock durations\n"
+            "      {\n"
+            "        \"below_us\": n,         (numeric) Upper bound of the bucket in microseconds\n"
+            "        \"count\": n             (numeric) Number of calls in the bucket\n"
+            "      }, ...\n"
+            "    ],\n"
+            "    \"threads\": [               (json array) The same fields for every miner thread (\"device\" is e.g. CPU#0)\n"
+            "      ...\n"
+            "    ]\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getminingstats", "") + HelpExampleRpc("getminingstats", ""));
+
+    UniValue result(UniValue::VARR);
+    for (const HashRateCounterRef& group : GetHashRateCounters()) {
+        UniValue obj = HashRateCounterToJSON(group);
+        UniValue threads(UniValue::VARR);
+        for (const HashRateCounterRef& thread : group->children()) {
+            threads.push_back(HashRateCounterToJSON(thread));
+        }
+        obj.push_back(Pair("threads", threads));
+        result.push_back(obj);
+    }
+    return result;
+}
+
 UniValue getmininginfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -555,6 +625,10 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
             "  },\n"
             "  \"coinbasevalue\" : n,               (numeric) maximum allowable input to coinbase transaction, including the generation award and transaction fees (in satoshis)\n"
             "  \"coinbasetxn\" : { ... },           (json object) information for coinbase transaction\n"
+            "  \"coinbasebranch\" : [                (array of strings) merkle branch of the coinbase transaction, the merkle root of a block with\n"
+            "      \"xxxx\"                          a modified coinbase is obtained by hashing its txid with each of these in order\n"
+            "      ,...\n"
+            "  ],\n"
             "  \"target\" : \"xxxx\",               (string) The hash target\n"
             "  \"mintime\" : xxx,                   (numeric) The minimum timestamp appropriate for next block time in seconds since epoch (Jan 1 1970 GMT)\n"
             "  \"mutable\" : [                      (array of string) list of ways the block template may be changed \n"
@@ -853,6 +927,11 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     result.push_back(Pair("transactions", transactions));
     result.push_back(Pair("coinbaseaux", aux));
     result.push_back(Pair("coinbasevalue", (int64_t)nCoinbaseValue));
+    UniValue coinbaseBranch(UniValue::VARR);
+    for (const uint256& hash : pblocktemplate->vCoinbaseBranch) {
+        coinbaseBranch.push_back(hash.GetHex());
+    }
+    result.push_back(Pair("coinbasebranch", coinbaseBranch));
     result.push_back(Pair("longpollid", chainActive.Tip()->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast)));
     result.push_back(Pair("target", hashTarget.GetHex()));
     result.push_back(Pair("mintime", (int64_t)pindexPrev->GetMedianTimePast() + 1));
@@ -1147,6 +1226,7 @@ static const CRPCCommand commands[] =
         {"generating", "gethashespersec", &gethashespersec, true, {}},
         {"generating", "getcpuhashespersec", &getcpuhashespersec, true, {}},
         {"generating", "getgpuhashespersec", &getgpuhashespersec, true, {}},
+        {"generating", "getminingstats", &getminingstats, true, {}},
 
         {"util", "estimatefee", &estimatefee, true, {"nblocks"}},
         {"util", "estimatepriority", &estimatepriority, true, {"nblocks"}},
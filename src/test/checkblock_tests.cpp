@@ -41,4 +41,25 @@ bool read_block(const std::string& filename, CBlock& block)
     return true;
 }
 
+BOOST_AUTO_TEST_CASE(header_hash_cache)
+{
+    CBlockHeader header;
+    header.nBits = 0x207fffff;
+    header.nTime = 1500000000;
+    uint256 hash = header.GetHash();
+    BOOST_CHECK(hash == hash_Argon2d(BEGIN(header.nVersion), END(header.nNonce), 1));
+
+    // Copies share the memoized hash
+    CBlock block(header);
+    BOOST_CHECK(block.GetHash() == hash);
+    BOOST_CHECK(block.GetBlockHeader().GetHash() == hash);
+
+    // Any change of a hashed field invalidates it
+    block.nNonce++;
+    BOOST_CHECK(block.GetHash() != hash);
+    BOOST_CHECK(block.GetHash() == hash_Argon2d(BEGIN(block.nVersion), END(block.nNonce), 1));
+    block.nNonce--;
+    BOOST_CHECK(block.GetHash() == hash);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
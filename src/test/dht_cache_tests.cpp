@@ -0,0 +1,181 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bdap/utils.h"
+#include "clientversion.h"
+#include "dht/mutable.h"
+#include "dht/mutablecache.h"
+#include "random.h"
+#include "streams.h"
+#include "test/test_dynamic.h"
+#include "utilstrencodings.h"
+
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dht_cache_tests, BasicTestingSetup)
+
+static uint160 RandomTarget()
+{
+    std::vector<unsigned char> vch(20);
+    GetRandBytes(vch.data(), vch.size());
+    return uint160(vch);
+}
+
+static CMutableData MakeData(const uint160& target, size_t nValueSize)
+{
+    return CMutableData(CharString(target.begin(), target.end()), CharString(32, 'a'), CharString(64, 'b'), 1,
+        CharString(6, 's'), CharString(nValueSize, 'v'));
+}
+
+BOOST_AUTO_TEST_CASE(dht_cache_put_get_erase)
+{
+    CMutableDataCache cache(1 << 20);
+    std::vector<uint160> vTargets;
+    for (int i = 0; i < 100; i++) {
+        vTargets.push_back(RandomTarget());
+        cache.Put(vTargets.back(), MakeData(vTargets.back(), 100));
+    }
+    BOOST_CHECK_EQUAL(cache.size(), 100U);
+    BOOST_CHECK_EQUAL(cache.CachedValues(), 100U);
+
+    CMutableData data;
+    BOOST_CHECK(cache.Get(vTargets[42], data));
+    BOOST_CHECK(data == MakeData(vTargets[42], 100));
+    BOOST_CHECK(!cache.Get(RandomTarget(), data));
+
+    // Erasing from the middle keeps every other target reachable
+    for (int i = 0; i < 100; i += 2) {
+        cache.Erase(vTargets[i]);
+    }
+    BOOST_CHECK_EQUAL(cache.size(), 50U);
+    for (int i = 0; i < 100; i++) {
+        BOOST_CHECK_EQUAL(cache.Contains(vTargets[i]), i % 2 == 1);
+    }
+    std::set<uint160> setSelected;
+    for (int i = 0; i < 2000; i++) {
+        uint160 target;
+        BOOST_CHECK(cache.SelectRandom(target));
+        BOOST_CHECK(cache.Contains(target));
+        setSelected.insert(target);
+    }
+    BOOST_CHECK_EQUAL(setSelected.size(), 50U);
+
+    cache.Clear();
+    uint160 target;
+    BOOST_CHECK(!cache.SelectRandom(target));
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+    BOOST_CHECK_EQUAL(cache.CachedValues(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(dht_cache_bounded)
+{
+    const size_t nMaxUsage = 256 * 1024;
+    CMutableDataCache cache(nMaxUsage);
+    std::vector<uint160> vTargets;
+    for (int i = 0; i < 1000; i++) {
+        vTargets.push_back(RandomTarget());
+        cache.Put(vTargets.back(), MakeData(vTargets.back(), 1000));
+    }
+    // Every target stays indexed, only recent values are kept
+    BOOST_CHECK_EQUAL(cache.size(), 1000U);
+    BOOST_CHECK(cache.IsFull());
+    BOOST_CHECK(cache.CachedValues() < 1000U);
+    BOOST_CHECK(cache.CachedValues() > 0U);
+    BOOST_CHECK(cache.DynamicMemoryUsage() <= nMaxUsage);
+
+    CMutableData data;
+    BOOST_CHECK(!cache.Get(vTargets[0], data));
+    BOOST_CHECK(cache.Contains(vTargets[0]));
+    BOOST_CHECK(cache.Get(vTargets[999], data));
+
+    // A read makes the value the most recently used one
+    const uint160 oldest = vTargets[1000 - cache.CachedValues()];
+    BOOST_CHECK(cache.Get(oldest, data));
+    cache.Put(vTargets[0], MakeData(vTargets[0], 1000));
+    BOOST_CHECK(cache.Get(oldest, data));
+    BOOST_CHECK(!cache.Get(vTargets[1001 - cache.CachedValues()], data));
+
+    // Index only entries have no value
+    const uint160 target = RandomTarget();
+    cache.AddTarget(target);
+    BOOST_CHECK(cache.Contains(target));
+    BOOST_CHECK(!cache.Get(target, data));
+}
+
+BOOST_AUTO_TEST_CASE(dht_cache_bounded_index)
+{
+    const size_t nMaxUsage = 128 * 1024;
+    CMutableDataCache cache(nMaxUsage);
+    std::vector<uint160> vTargets;
+    for (int i = 0; i < 100; i++) {
+        vTargets.push_back(RandomTarget());
+        cache.Put(vTargets.back(), MakeData(vTargets.back(), 100));
+    }
+    BOOST_CHECK_EQUAL(cache.CachedValues(), 100U);
+    BOOST_CHECK(!cache.IsFull());
+
+    // A growing index pushes values out
+    while (cache.CachedValues() > 0) {
+        cache.AddTarget(RandomTarget());
+        BOOST_CHECK(cache.DynamicMemoryUsage() <= nMaxUsage || cache.CachedValues() == 0);
+    }
+    BOOST_CHECK(cache.IsFull());
+    for (const uint160& target : vTargets) {
+        BOOST_CHECK(cache.Contains(target));
+    }
+
+    // The index is kept past the limit, with only the newest value cached
+    for (int i = 0; i < 1000; i++) {
+        cache.AddTarget(RandomTarget());
+    }
+    BOOST_CHECK(cache.DynamicMemoryUsage() > nMaxUsage);
+    CMutableData data;
+    cache.Put(vTargets[0], MakeData(vTargets[0], 100));
+    cache.Put(vTargets[1], MakeData(vTargets[1], 100));
+    BOOST_CHECK_EQUAL(cache.CachedValues(), 1U);
+    BOOST_CHECK(cache.Get(vTargets[1], data));
+    BOOST_CHECK(!cache.Get(vTargets[0], data));
+}
+
+BOOST_AUTO_TEST_CASE(dht_mutable_binary_format)
+{
+    const uint160 target = RandomTarget();
+    const CMutableData data = MakeData(target, 100);
+    BOOST_CHECK_EQUAL(data.InfoHash(), HexStr(target.begin(), target.end()));
+
+    // Version 1 records carry hex strings and the info hash
+    CMutableData oldData(vchFromString(data.InfoHash()), vchFromString(data.PublicKey()), vchFromString(data.Signature()),
+        data.SequenceNumber, data.vchSalt, data.vchValue);
+    oldData.nVersion = 1;
+    CDataStream ssOld(SER_DISK, CLIENT_VERSION);
+    ssOld << oldData;
+    const size_t nOldSize = ssOld.size();
+
+    CMutableData upgraded;
+    ssOld >> upgraded;
+    BOOST_CHECK_EQUAL(upgraded.nVersion, 1);
+    BOOST_CHECK(upgraded.UpgradeFromHex());
+    BOOST_CHECK(upgraded.nVersion == CMutableData::CURRENT_VERSION);
+    BOOST_CHECK(upgraded.vchInfoHash == data.vchInfoHash);
+    BOOST_CHECK(upgraded.vchPublicKey == data.vchPublicKey);
+    BOOST_CHECK(upgraded.vchSignature == data.vchSignature);
+
+    // The target lives in the database key only
+    CDataStream ssNew(SER_DISK, CLIENT_VERSION);
+    ssNew << upgraded;
+    BOOST_CHECK(ssNew.size() + 20 + 96 < nOldSize);
+    CMutableData read;
+    ssNew >> read;
+    BOOST_CHECK(read.vchInfoHash.empty());
+    BOOST_CHECK(read.vchSignature == data.vchSignature);
+    BOOST_CHECK(read.vchValue == data.vchValue);
+
+    CMutableData malformed(vchFromString("abcd"), vchFromString(data.PublicKey()), vchFromString(data.Signature()), 1, data.vchSalt, data.vchValue);
+    malformed.nVersion = 1;
+    BOOST_CHECK(!malformed.UpgradeFromHex());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
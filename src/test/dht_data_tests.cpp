@@ -68,4 +68,74 @@ BOOST_AUTO_TEST_CASE(dht_data_test1)
 
 }
 
+BOOST_AUTO_TEST_CASE(dht_data_chunk_salt)
+{
+    BOOST_CHECK_EQUAL(GetChunkSalt("oauth", 0), "oauth:0");
+    BOOST_CHECK_EQUAL(GetChunkSalt("oauth", 7), "oauth:7");
+    BOOST_CHECK_EQUAL(GetChunkSalt("avatar", 65535), "avatar:65535");
+}
+
+BOOST_AUTO_TEST_CASE(dht_data_chunk_spans)
+{
+    std::vector<unsigned char> vchValue(2 * DHT_DATA_MAX_CHUNK_SIZE + 200);
+    for (size_t i = 0; i < vchValue.size(); i++)
+        vchValue[i] = i % 251;
+    std::vector<std::vector<unsigned char>> vvchPubKeys;
+    CDataRecord record("test", 32, vvchPubKeys, vchValue, 0, GetTime() + 86400, DHT::DataFormat::BinaryBlob);
+    BOOST_CHECK(!record.HasError());
+
+    const std::vector<CDataChunkSpan>& vSpans = record.GetChunkSpans();
+    BOOST_CHECK_EQUAL(vSpans.size(), 3U);
+    BOOST_CHECK_EQUAL(record.GetHeader().nChunks, 3U);
+    BOOST_CHECK_EQUAL(record.GetHeader().nDataSize, vchValue.size());
+    BOOST_CHECK_EQUAL(vSpans[2].Salt, "test:3");
+    BOOST_CHECK_EQUAL(vSpans[2].nSize, 200U);
+
+    // The spans cover the payload and GetChunks() returns the same bytes
+    std::vector<CDataChunk> vChunks = record.GetChunks();
+    std::vector<unsigned char> vchJoined;
+    for (size_t i = 0; i < vSpans.size(); i++) {
+        std::string strValue;
+        record.WriteChunk(vSpans[i], strValue);
+        BOOST_CHECK(std::vector<unsigned char>(strValue.begin(), strValue.end()) == vChunks[i].vchValue);
+        vchJoined.insert(vchJoined.end(), strValue.begin(), strValue.end());
+    }
+    BOOST_CHECK(vchJoined == vchValue);
+
+    // An exact multiple of the chunk size has no empty trailing chunk
+    vchValue.resize(2 * DHT_DATA_MAX_CHUNK_SIZE);
+    CDataRecord record2("test", 32, vvchPubKeys, vchValue, 0, GetTime() + 86400, DHT::DataFormat::BinaryBlob);
+    BOOST_CHECK_EQUAL(record2.GetChunkSpans().size(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(dht_data_chunk_decode)
+{
+    std::vector<unsigned char> vchPayload;
+    const std::string strHex = "00ff7f80";
+    AppendChunkValue(strHex.data(), strHex.data() + strHex.size(), true, vchPayload);
+    BOOST_CHECK(vchPayload == ParseHex(strHex));
+
+    // Not hex, appended as it is
+    const std::string strText = "0fg0";
+    AppendChunkValue(strText.data(), strText.data() + strText.size(), true, vchPayload);
+    BOOST_CHECK_EQUAL(vchPayload.size(), 8U);
+    BOOST_CHECK_EQUAL(std::string(vchPayload.begin() + 4, vchPayload.end()), strText);
+
+    AppendChunkValue(strHex.data(), strHex.data() + strHex.size(), false, vchPayload);
+    BOOST_CHECK_EQUAL(vchPayload.size(), 16U);
+
+    // Clear text records are reassembled from the chunk values as they are
+    std::vector<unsigned char> vchValue = vchFromString(std::string(DHT_DATA_MAX_CHUNK_SIZE + 100, 'a'));
+    std::vector<std::vector<unsigned char>> vvchPubKeys;
+    CDataRecord record("test", 32, vvchPubKeys, vchValue, 0, GetTime() + 86400, DHT::DataFormat::BinaryBlob);
+    std::vector<std::string> vValues;
+    for (const CDataChunkSpan& span : record.GetChunkSpans()) {
+        vValues.push_back(std::string());
+        record.WriteChunk(span, vValues.back());
+    }
+    CDataRecord getRecord("test", 32, record.GetHeader(), vValues, std::vector<unsigned char>());
+    BOOST_CHECK(getRecord.Valid());
+    BOOST_CHECK(getRecord.RawData() == vchValue);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
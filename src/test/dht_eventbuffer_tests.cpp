@@ -0,0 +1,80 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/eventbuffer.h"
+#include "test/test_dynamic.h"
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dht_eventbuffer_tests, BasicTestingSetup)
+
+static CEvent MakeEvent(int type, int64_t nTime)
+{
+    return CEvent("message", type, 0, "alert", nTime);
+}
+
+BOOST_AUTO_TEST_CASE(dht_eventbuffer_range)
+{
+    CEventBuffer buffer(100);
+    for (int64_t nTime = 1000; nTime < 1050; nTime++)
+        buffer.Push(MakeEvent(nTime % 2 ? 62 : 70, nTime));
+    BOOST_CHECK_EQUAL(buffer.size(), 50U);
+
+    std::vector<CEvent> events;
+    buffer.GetEvents(1040, events);
+    BOOST_CHECK_EQUAL(events.size(), 10U);
+    BOOST_CHECK_EQUAL(events.front().Timestamp(), 1040);
+    BOOST_CHECK_EQUAL(events.back().Timestamp(), 1049);
+
+    events.clear();
+    buffer.GetEvents(62, 1040, events);
+    BOOST_CHECK_EQUAL(events.size(), 5U);
+    for (const CEvent& event : events)
+        BOOST_CHECK_EQUAL(event.Type(), 62);
+
+    events.clear();
+    buffer.GetEvents(2000, events);
+    BOOST_CHECK(events.empty());
+
+    // Expiring drops events from the oldest end only
+    BOOST_CHECK_EQUAL(buffer.Expire(1030), 30U);
+    BOOST_CHECK_EQUAL(buffer.Expire(1030), 0U);
+    events.clear();
+    buffer.GetEvents(0, events);
+    BOOST_CHECK_EQUAL(events.size(), 20U);
+    BOOST_CHECK_EQUAL(events.front().Timestamp(), 1030);
+
+    buffer.Clear();
+    BOOST_CHECK_EQUAL(buffer.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(dht_eventbuffer_wrap)
+{
+    CEventBuffer buffer(10);
+    for (int64_t nTime = 0; nTime < 25; nTime++)
+        buffer.Push(MakeEvent(62, nTime));
+    BOOST_CHECK_EQUAL(buffer.size(), 10U);
+
+    std::vector<CEvent> events;
+    buffer.GetEvents(0, events);
+    BOOST_CHECK_EQUAL(events.size(), 10U);
+    for (size_t i = 0; i < events.size(); i++)
+        BOOST_CHECK_EQUAL(events[i].Timestamp(), int64_t(15 + i));
+
+    events.clear();
+    buffer.GetEvents(22, events);
+    BOOST_CHECK_EQUAL(events.size(), 3U);
+
+    // A clock going backwards keeps the buffer ordered
+    buffer.Push(MakeEvent(70, 5));
+    events.clear();
+    buffer.GetEvents(24, events);
+    BOOST_CHECK_EQUAL(events.size(), 2U);
+    BOOST_CHECK_EQUAL(buffer.Expire(24), 8U);
+    BOOST_CHECK_EQUAL(buffer.size(), 2U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/reannounce.h"
+#include "random.h"
+#include "test/test_dynamic.h"
+
+#include <algorithm>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dht_reannounce_tests, BasicTestingSetup)
+
+static uint160 RandomTarget()
+{
+    std::vector<unsigned char> vch(20);
+    GetRandBytes(vch.data(), vch.size());
+    return uint160(vch);
+}
+
+BOOST_AUTO_TEST_CASE(dht_reannounce_schedule)
+{
+    const int64_t nInterval = 3600;
+    const int64_t nNow = 1000000;
+    CReannounceScheduler scheduler(nInterval);
+
+    std::vector<uint160> vTargets;
+    for (int i = 0; i < 100; i++)
+        vTargets.push_back(RandomTarget());
+    scheduler.Sync(vTargets);
+    BOOST_CHECK_EQUAL(scheduler.size(), 100U);
+    BOOST_CHECK_EQUAL(scheduler.DueCount(nNow), 100U);
+
+    // The budget limits each round, every item is announced once per interval
+    std::set<uint160> setAnnounced;
+    for (int64_t nTime = nNow; nTime < nNow + 10; nTime++) {
+        std::vector<uint160> vDue = scheduler.PopDue(nTime, 10);
+        BOOST_CHECK_EQUAL(vDue.size(), 10U);
+        setAnnounced.insert(vDue.begin(), vDue.end());
+    }
+    BOOST_CHECK_EQUAL(setAnnounced.size(), 100U);
+    BOOST_CHECK(scheduler.PopDue(nNow + 10, 10).empty());
+    BOOST_CHECK(scheduler.PopDue(nNow + nInterval - 1, 10).empty());
+    BOOST_CHECK_EQUAL(scheduler.PopDue(nNow + nInterval, 100).size(), 10U);
+
+    // A new sequence number goes before items already due
+    scheduler.Update(vTargets[50], 7);
+    std::vector<uint160> vDue = scheduler.PopDue(nNow + 2 * nInterval, 1);
+    BOOST_CHECK(vDue.size() == 1 && vDue[0] == vTargets[50]);
+    scheduler.Update(vTargets[50], 7);
+    BOOST_CHECK(scheduler.PopDue(nNow + 2 * nInterval, 1)[0] != vTargets[50]);
+
+    // Items stored on too few nodes are retried early
+    scheduler.PutResult(vTargets[50], DHT_REANNOUNCE_MIN_NODES - 1, nNow + 2 * nInterval);
+    vDue = scheduler.PopDue(nNow + 2 * nInterval + DHT_REANNOUNCE_RETRY, 200);
+    BOOST_CHECK(std::find(vDue.begin(), vDue.end(), vTargets[50]) != vDue.end());
+
+    // Items gone from the database are dropped
+    vTargets.resize(40);
+    scheduler.Sync(vTargets);
+    BOOST_CHECK_EQUAL(scheduler.size(), 40U);
+    scheduler.Remove(vTargets[0]);
+    BOOST_CHECK_EQUAL(scheduler.size(), 39U);
+    BOOST_CHECK_EQUAL(scheduler.PopDue(nNow + 10 * nInterval, 100).size(), 39U);
+}
+
+BOOST_AUTO_TEST_CASE(dht_reannounce_skip)
+{
+    const int64_t nNow = 1000000;
+    CReannounceScheduler scheduler;
+
+    std::vector<uint160> vTargets;
+    for (int i = 0; i < 20; i++)
+        vTargets.push_back(RandomTarget());
+    std::set<uint160> setUnsalted(vTargets.begin(), vTargets.begin() + 10);
+
+    // Rejected items never take a share of the budget
+    int nChecked = 0;
+    auto fnAnnounce = [&](const uint160& target) {
+        nChecked++;
+        return !setUnsalted.count(target);
+    };
+    scheduler.Sync(vTargets, fnAnnounce);
+    BOOST_CHECK_EQUAL(nChecked, 20);
+    BOOST_CHECK_EQUAL(scheduler.size(), 10U);
+    std::vector<uint160> vDue = scheduler.PopDue(nNow, 10);
+    BOOST_CHECK_EQUAL(vDue.size(), 10U);
+    for (const uint160& target : vDue)
+        BOOST_CHECK(!setUnsalted.count(target));
+
+    // Known targets aren't checked again
+    scheduler.Sync(vTargets, fnAnnounce);
+    BOOST_CHECK_EQUAL(nChecked, 20);
+    BOOST_CHECK_EQUAL(scheduler.size(), 10U);
+
+    // Until they leave the database and come back
+    const uint160 unsalted = vTargets[0];
+    vTargets.erase(vTargets.begin());
+    scheduler.Sync(vTargets, fnAnnounce);
+    BOOST_CHECK_EQUAL(nChecked, 20);
+    vTargets.push_back(unsalted);
+    scheduler.Sync(vTargets, fnAnnounce);
+    BOOST_CHECK_EQUAL(nChecked, 21);
+    BOOST_CHECK_EQUAL(scheduler.size(), 10U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
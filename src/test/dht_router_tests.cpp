@@ -0,0 +1,79 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/router.h"
+#include "random.h"
+#include "test/test_dynamic.h"
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dht_router_tests, BasicTestingSetup)
+
+static uint160 RandomKey()
+{
+    std::vector<unsigned char> vch(20);
+    GetRandBytes(vch.data(), vch.size());
+    return uint160(vch);
+}
+
+static bool AllAvailable(size_t) { return true; }
+static int NoneInFlight(size_t) { return 0; }
+
+BOOST_AUTO_TEST_CASE(dht_router_consistent)
+{
+    CSessionRouter router;
+    BOOST_CHECK_EQUAL(router.Route(RandomKey(), AllAvailable, NoneInFlight), -1);
+
+    router.Reset(8);
+    std::vector<uint160> vKeys;
+    std::vector<int> vRoutes;
+    std::vector<int> vCount(8);
+    for (int i = 0; i < 8000; i++) {
+        vKeys.push_back(RandomKey());
+        vRoutes.push_back(router.Route(vKeys.back(), AllAvailable, NoneInFlight));
+        BOOST_CHECK(vRoutes.back() >= 0 && vRoutes.back() < 8);
+        vCount[vRoutes.back()]++;
+        // The same key always lands on the same session
+        BOOST_CHECK_EQUAL(router.Route(vKeys.back(), AllAvailable, NoneInFlight), vRoutes.back());
+    }
+    for (int nCount : vCount) {
+        BOOST_CHECK(nCount > 500 && nCount < 1500);
+    }
+
+    // Only the keys of an unavailable session move
+    auto fnNotThree = [](size_t i) { return i != 3; };
+    for (size_t i = 0; i < vKeys.size(); i++) {
+        const int nRoute = router.Route(vKeys[i], fnNotThree, NoneInFlight);
+        BOOST_CHECK(nRoute != 3);
+        if (vRoutes[i] != 3)
+            BOOST_CHECK_EQUAL(nRoute, vRoutes[i]);
+    }
+
+    // With no session available the owner still serves the key
+    auto fnNone = [](size_t) { return false; };
+    BOOST_CHECK_EQUAL(router.Route(vKeys[0], fnNone, NoneInFlight), vRoutes[0]);
+}
+
+BOOST_AUTO_TEST_CASE(dht_router_in_flight)
+{
+    CSessionRouter router;
+    router.Reset(4);
+    const uint160 key = RandomKey();
+    const int nOwner = router.Route(key, AllAvailable, NoneInFlight);
+
+    // A busy owner hands the key to the next session on the ring
+    auto fnOwnerBusy = [nOwner](size_t i) { return int(i) == nOwner ? 10 : 0; };
+    const int nNext = router.Route(key, AllAvailable, fnOwnerBusy);
+    BOOST_CHECK(nNext >= 0 && nNext != nOwner);
+    auto fnNextBusy = [nNext](size_t i) { return int(i) == nNext ? 10 : 0; };
+    BOOST_CHECK_EQUAL(router.Route(key, AllAvailable, fnNextBusy), nOwner);
+
+    // A single session takes everything
+    router.Reset(1);
+    BOOST_CHECK_EQUAL(router.Route(key, AllAvailable, fnOwnerBusy), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
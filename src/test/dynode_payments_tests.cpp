@@ -0,0 +1,168 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "dynode-payments.h"
+#include "fluid/fluiddb.h"
+#include "key.h"
+#include "script/standard.h"
+#include "validation.h"
+
+#include "test/test_dynamic.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dynode_payments_tests, TestChain100Setup)
+
+static CScript MakePayee()
+{
+    CKey key;
+    key.MakeNewKey(true);
+    return GetScriptForDestination(key.GetPubKey().GetID());
+}
+
+// Two votes, enough for HasPayeeWithVotes(payee, 2)
+static void AddVotes(int nBlockHeight, const CScript& payee)
+{
+    LOCK(cs_mapDynodeBlocks);
+    CDynodeBlockPayees blockPayees(nBlockHeight);
+    for (int i = 0; i < 2; i++)
+        blockPayees.AddPayee(CDynodePaymentVote(COutPoint(GetRandHash(), 0), nBlockHeight, payee));
+    dnpayments.mapDynodeBlocks[nBlockHeight] = blockPayees;
+}
+
+// The linear scan CDynode::UpdateLastPaid did before the index
+static int ScanLastPaid(const CScript& payee, int nMinBlockHeight)
+{
+    LOCK(cs_mapDynodeBlocks);
+    for (const CBlockIndex* pindex = chainActive.Tip(); pindex && pindex->nHeight > nMinBlockHeight; pindex = pindex->pprev) {
+        if (!dnpayments.mapDynodeBlocks.count(pindex->nHeight) ||
+            !dnpayments.mapDynodeBlocks[pindex->nHeight].HasPayeeWithVotes(payee, 2))
+            continue;
+
+        CBlock block;
+        BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+        for (const auto& txout : block.vtx[0]->vout)
+            if (txout.scriptPubKey == payee && txout.nValue == GetFluidDynodeReward(pindex->nHeight))
+                return pindex->nHeight;
+    }
+    return -1;
+}
+
+static int IndexLastPaid(const CScript& payee, int nMinBlockHeight)
+{
+    int nBlockHeight;
+    int64_t nTime;
+    if (!dnpayments.GetLastPaid(payee, nMinBlockHeight, chainActive.Height(), nBlockHeight, nTime))
+        return -1;
+    BOOST_CHECK_EQUAL(nTime, chainActive[nBlockHeight]->nTime);
+    return nBlockHeight;
+}
+
+BOOST_AUTO_TEST_CASE(dynode_payments_last_paid_index)
+{
+    dnpayments.Clear();
+
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CScript payeeA = MakePayee();
+    CScript payeeB = MakePayee();
+    int nStartHeight = chainActive.Height();
+
+    auto connectBlock = [&](const CScript& payee, bool fVotes) {
+        int nBlockHeight = chainActive.Height() + 1;
+        AddVotes(nBlockHeight, payee);
+        CBlock block = CreateAndProcessBlock({}, scriptPubKey);
+        BOOST_REQUIRE_EQUAL(chainActive.Height(), nBlockHeight);
+        BOOST_REQUIRE(chainActive.Tip()->GetBlockHash() == block.GetHash());
+        if (!fVotes) {
+            LOCK(cs_mapDynodeBlocks);
+            dnpayments.mapDynodeBlocks.erase(nBlockHeight);
+        }
+        dnpayments.BlockConnected(*block.vtx[0], chainActive.Tip());
+    };
+
+    auto checkLastPaid = [&](int nExpectedA, int nExpectedB) {
+        for (int nMin : {nStartHeight, chainActive.Height() - 2}) {
+            BOOST_CHECK_EQUAL(IndexLastPaid(payeeA, nMin), ScanLastPaid(payeeA, nMin));
+            BOOST_CHECK_EQUAL(IndexLastPaid(payeeB, nMin), ScanLastPaid(payeeB, nMin));
+        }
+        BOOST_CHECK_EQUAL(IndexLastPaid(payeeA, nStartHeight), nExpectedA);
+        BOOST_CHECK_EQUAL(IndexLastPaid(payeeB, nStartHeight), nExpectedB);
+    };
+
+    // Connect
+    checkLastPaid(-1, -1);
+    for (int i = 0; i < 6; i++)
+        connectBlock(i % 2 ? payeeB : payeeA, true);
+    checkLastPaid(nStartHeight + 5, nStartHeight + 6);
+
+    // Disconnect the tip, B was last paid the block before
+    int nTipHeight = chainActive.Height();
+    {
+        CValidationState state;
+        {
+            LOCK(cs_main);
+            BOOST_CHECK(InvalidateBlock(state, Params(), chainActive.Tip()));
+        }
+        BOOST_CHECK(ActivateBestChain(state, Params()));
+        BOOST_REQUIRE_EQUAL(chainActive.Height(), nTipHeight - 1);
+    }
+    dnpayments.BlockDisconnected(nTipHeight);
+    checkLastPaid(nStartHeight + 5, nStartHeight + 4);
+
+    // Reorg, the replacing block pays A instead
+    connectBlock(payeeA, true);
+    BOOST_REQUIRE_EQUAL(chainActive.Height(), nTipHeight);
+    checkLastPaid(nStartHeight + 6, nStartHeight + 4);
+
+    // Votes arriving after the block connected
+    connectBlock(payeeB, false);
+    checkLastPaid(nStartHeight + 6, nStartHeight + 4);
+    AddVotes(chainActive.Height(), payeeB);
+    checkLastPaid(nStartHeight + 6, nStartHeight + 7);
+
+    dnpayments.Clear();
+}
+
+BOOST_AUTO_TEST_CASE(dynode_payments_load_last_paid_index)
+{
+    dnpayments.Clear();
+
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CScript payee = MakePayee();
+    int nStartHeight = chainActive.Height();
+
+    // Blocks connected before the index existed, e.g. before startup
+    AddVotes(nStartHeight + 1, payee);
+    CreateAndProcessBlock({}, scriptPubKey);
+    AddVotes(nStartHeight + 2, payee);
+    CreateAndProcessBlock({}, scriptPubKey);
+    BOOST_REQUIRE_EQUAL(chainActive.Height(), nStartHeight + 2);
+
+    // Only the first block's votes are known yet
+    CDynodeBlockPayees blockPayees;
+    {
+        LOCK(cs_mapDynodeBlocks);
+        blockPayees = dnpayments.mapDynodeBlocks[nStartHeight + 2];
+        dnpayments.mapDynodeBlocks.erase(nStartHeight + 2);
+    }
+    BOOST_CHECK_EQUAL(IndexLastPaid(payee, nStartHeight), -1);
+    dnpayments.LoadLastPaidIndex(chainActive.Tip());
+    BOOST_CHECK_EQUAL(IndexLastPaid(payee, nStartHeight), nStartHeight + 1);
+    BOOST_CHECK_EQUAL(IndexLastPaid(payee, nStartHeight), ScanLastPaid(payee, nStartHeight));
+
+    // The later votes get the second block indexed on the next load
+    {
+        LOCK(cs_mapDynodeBlocks);
+        dnpayments.mapDynodeBlocks[nStartHeight + 2] = blockPayees;
+    }
+    dnpayments.LoadLastPaidIndex(chainActive.Tip());
+    BOOST_CHECK_EQUAL(IndexLastPaid(payee, nStartHeight), nStartHeight + 2);
+    BOOST_CHECK_EQUAL(IndexLastPaid(payee, nStartHeight), ScanLastPaid(payee, nStartHeight));
+
+    dnpayments.Clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dynode-sync.h"
+#include "dynodeman.h"
+#include "key.h"
+
+#include "test/test_dynamic.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dynodeman_tests, TestingSetup)
+
+// Dynodes without collateral, fUnitTest skips the UTXO lookup so only fSpent ones get removed
+static CDynode MakeDynode(uint32_t n, bool fSpent = false)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CDynode dn(CService(), COutPoint(GetRandHash(), n), key.GetPubKey(), key.GetPubKey(), PROTOCOL_VERSION);
+    dn.fUnitTest = !fSpent;
+    return dn;
+}
+
+static void SyncDynodeList(CConnman& connman)
+{
+    dynodeSync.Reset();
+    // initial -> waiting -> list -> winners
+    for (int i = 0; i < 3; i++)
+        dynodeSync.SwitchToNextAsset(connman);
+    BOOST_CHECK(dynodeSync.IsDynodeListSynced());
+}
+
+BOOST_AUTO_TEST_CASE(dynodeman_rank_tables)
+{
+    SyncDynodeList(*connman);
+    dnodeman.Clear();
+
+    CDynode dn1 = MakeDynode(1);
+    CDynode dn2 = MakeDynode(2);
+    BOOST_CHECK(dnodeman.Add(dn1));
+    BOOST_CHECK(dnodeman.Add(dn2));
+
+    // The second lookup for the same block is served from the cached table
+    int nRank1, nRank2;
+    BOOST_CHECK(dnodeman.GetDynodeRank(dn1.outpoint, nRank1));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+    BOOST_CHECK(dnodeman.GetDynodeRank(dn2.outpoint, nRank2));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+    BOOST_CHECK_EQUAL(nRank1 + nRank2, 3);
+
+    CDynodeMan::rank_pair_vec_t vecRanks;
+    BOOST_CHECK(dnodeman.GetDynodeRanks(vecRanks));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+    BOOST_CHECK_EQUAL(vecRanks.size(), 2);
+    BOOST_CHECK(vecRanks[nRank1 - 1].second.outpoint == dn1.outpoint);
+    BOOST_CHECK(vecRanks[nRank2 - 1].second.outpoint == dn2.outpoint);
+
+    // Nobody runs a newer protocol, no table is cached for it
+    BOOST_CHECK(!dnodeman.GetDynodeRank(dn1.outpoint, nRank1, -1, PROTOCOL_VERSION + 1));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+
+    // Adding a Dynode drops the tables
+    CDynode dn3 = MakeDynode(3, true);
+    BOOST_CHECK(dnodeman.Add(dn3));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 0);
+    BOOST_CHECK(dnodeman.GetDynodeRanks(vecRanks));
+    BOOST_CHECK_EQUAL(vecRanks.size(), 3);
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+
+    // So does removing one, dn3 has no collateral
+    dnodeman.CheckAndRemove(*connman);
+    BOOST_CHECK(!dnodeman.Has(dn3.outpoint));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 0);
+    int nRank3;
+    BOOST_CHECK(!dnodeman.GetDynodeRank(dn3.outpoint, nRank3));
+    BOOST_CHECK(dnodeman.GetDynodeRanks(vecRanks));
+    BOOST_CHECK_EQUAL(vecRanks.size(), 2);
+
+    // And a broadcast changing the protocol version
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+    CDynodeBroadcast dnb(dn1);
+    dnb.sigTime = dn1.sigTime + 1;
+    dnb.nProtocolVersion = dn1.nProtocolVersion + 1;
+    BOOST_CHECK(dn1.UpdateFromNewBroadcast(dnb, *connman));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 0);
+
+    dnodeman.Clear();
+    dynodeSync.Reset();
+}
+
+BOOST_AUTO_TEST_CASE(dynodeman_rank_tables_unsynced)
+{
+    SyncDynodeList(*connman);
+    dnodeman.Clear();
+
+    CDynode dn1 = MakeDynode(1);
+    BOOST_CHECK(dnodeman.Add(dn1));
+    int nRank;
+    BOOST_CHECK(dnodeman.GetDynodeRank(dn1.outpoint, nRank));
+    BOOST_CHECK_EQUAL(nRank, 1);
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+
+    // Restarting the sync drops the tables and no ranks are given until the list is synced again
+    dynodeSync.Reset();
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 0);
+    BOOST_CHECK(!dnodeman.GetDynodeRank(dn1.outpoint, nRank));
+    CDynodeMan::rank_pair_vec_t vecRanks;
+    BOOST_CHECK(!dnodeman.GetDynodeRanks(vecRanks));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 0);
+
+    SyncDynodeList(*connman);
+    BOOST_CHECK(dnodeman.GetDynodeRank(dn1.outpoint, nRank));
+    BOOST_CHECK_EQUAL(dnodeman.CountRankTables(), 1);
+
+    dnodeman.Clear();
+    dynodeSync.Reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
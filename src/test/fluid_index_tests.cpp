@@ -0,0 +1,87 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "fluid/fluidindex.h"
+#include "fluid/fluidmining.h"
+#include "test/test_dynamic.h"
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(fluid_index_tests, BasicTestingSetup)
+
+static CFluidMining MakeRecord(const std::string& strScript, unsigned int nHeight, CAmount nReward)
+{
+    CFluidMining entry;
+    entry.FluidScript = std::vector<unsigned char>(strScript.begin(), strScript.end());
+    entry.MiningReward = nReward;
+    entry.nTimeStamp = 1000 + nHeight;
+    entry.nHeight = nHeight;
+    return entry;
+}
+
+static void AddRecord(CFluidRecordIndex<CFluidMining>& index, const CFluidMining& entry)
+{
+    index.Add(entry.FluidScript, entry);
+}
+
+BOOST_AUTO_TEST_CASE(fluid_index_height_order)
+{
+    CFluidRecordIndex<CFluidMining> index;
+    BOOST_CHECK(index.IsEmpty());
+    AddRecord(index, MakeRecord("c", 30, 3));
+    AddRecord(index, MakeRecord("a", 10, 1));
+    AddRecord(index, MakeRecord("b", 20, 2));
+
+    CFluidMining entry;
+    BOOST_CHECK(index.GetLast(entry));
+    BOOST_CHECK_EQUAL(entry.MiningReward, 3);
+    BOOST_CHECK(index.GetLastBelow(21, entry));
+    BOOST_CHECK_EQUAL(entry.MiningReward, 2);
+    BOOST_CHECK(index.GetLastBelow(20, entry));
+    BOOST_CHECK_EQUAL(entry.MiningReward, 1);
+    BOOST_CHECK(!index.GetLastBelow(10, entry));
+
+    // Height 0 records are never returned
+    CFluidRecordIndex<CFluidMining> index2;
+    AddRecord(index2, MakeRecord("z", 0, 5));
+    BOOST_CHECK(!index2.GetLast(entry));
+}
+
+BOOST_AUTO_TEST_CASE(fluid_index_update)
+{
+    CFluidRecordIndex<CFluidMining> index;
+    AddRecord(index, MakeRecord("a", 10, 1));
+    AddRecord(index, MakeRecord("b", 20, 2));
+
+    // Writing a script again moves its record, like the database overwrite
+    AddRecord(index, MakeRecord("a", 25, 1));
+    BOOST_CHECK_EQUAL(index.size(), 2U);
+    CFluidMining entry;
+    BOOST_CHECK(index.GetLast(entry));
+    BOOST_CHECK_EQUAL(entry.nHeight, 25U);
+
+    index.Erase(MakeRecord("a", 25, 1).FluidScript);
+    BOOST_CHECK(index.GetLast(entry));
+    BOOST_CHECK_EQUAL(entry.nHeight, 20U);
+    index.Erase(MakeRecord("missing", 0, 0).FluidScript);
+    BOOST_CHECK_EQUAL(index.size(), 1U);
+
+    // Ties go to the record first in database key order
+    AddRecord(index, MakeRecord("y", 30, 7));
+    AddRecord(index, MakeRecord("x", 30, 8));
+    BOOST_CHECK(index.GetLast(entry));
+    BOOST_CHECK_EQUAL(entry.MiningReward, 8);
+
+    BOOST_CHECK(!index.HasNullRecords());
+    CFluidMining nullEntry;
+    index.Add(MakeRecord("n", 5, 0).FluidScript, nullEntry);
+    BOOST_CHECK(index.HasNullRecords());
+    index.Erase(MakeRecord("n", 5, 0).FluidScript);
+    BOOST_CHECK(!index.HasNullRecords());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
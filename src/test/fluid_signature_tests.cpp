@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base58.h"
+#include "fluid/fluid.h"
+#include "hash.h"
+#include "key.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+#include "test/test_dynamic.h"
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(fluid_signature_tests, BasicTestingSetup)
+
+static std::string SignToken(const CKey& key, const std::string& strToken)
+{
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << strMessageMagic;
+    ss << strToken;
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.SignCompact(ss.GetHash(), vchSig));
+    return EncodeBase64(vchSig.data(), vchSig.size());
+}
+
+BOOST_AUTO_TEST_CASE(fluid_signature_cached_signer)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    const CDynamicAddress address(key.GetPubKey().GetID());
+    const std::string strToken = "10.00000000$1554000000";
+    const std::string strSignature = SignToken(key, strToken);
+
+    // The second recovery is served from the cache and must agree with the first
+    CFluid fluidCheck;
+    BOOST_CHECK(fluidCheck.GetAddressFromDigestSignature(strSignature, strToken) == address);
+    BOOST_CHECK(fluidCheck.GetAddressFromDigestSignature(strSignature, strToken) == address);
+
+    // A cached signature does not vouch for another message
+    BOOST_CHECK(!(fluidCheck.GetAddressFromDigestSignature(strSignature, strToken + "0") == address));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
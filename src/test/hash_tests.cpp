@@ -83,4 +83,36 @@ BOOST_AUTO_TEST_CASE(siphash)
     }*/
 }
 
+BOOST_AUTO_TEST_CASE(argon2d_context)
+{
+    // A reused arena must give the same hashes as a fresh allocation
+    CArgon2dContext ctx;
+    std::vector<unsigned char> header(80);
+    for (unsigned int phase = 1; phase <= 2; phase++) {
+        for (unsigned int nonce = 0; nonce < 4; nonce++) {
+            header[79] = nonce;
+            BOOST_CHECK_EQUAL(ctx.Hash(header.data(), header.size(), phase).GetHex(),
+                hash_Argon2d(header.begin(), header.end(), phase).GetHex());
+        }
+    }
+    BOOST_CHECK(ctx.ArenaSize() > 0);
+
+    // Lockstep hashing must match hashing every input on its own
+    std::vector<std::vector<unsigned char> > headers(CArgon2dContext::MAX_MULTI_HASHES, header);
+    const void* inputs[CArgon2dContext::MAX_MULTI_HASHES];
+    for (unsigned int i = 0; i < headers.size(); i++) {
+        headers[i][76] = i;
+        inputs[i] = headers[i].data();
+    }
+    for (unsigned int phase = 1; phase <= 2; phase++) {
+        for (unsigned int count = 1; count <= CArgon2dContext::MAX_MULTI_HASHES; count++) {
+            uint256 hashes[CArgon2dContext::MAX_MULTI_HASHES];
+            BOOST_CHECK(ctx.HashMulti(inputs, header.size(), count, phase, hashes));
+            for (unsigned int i = 0; i < count; i++) {
+                BOOST_CHECK_EQUAL(hashes[i].GetHex(), hash_Argon2d(headers[i].begin(), headers[i].end(), phase).GetHex());
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
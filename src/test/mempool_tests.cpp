@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "fluid/fluid.h"
 #include "txmempool.h"
 #include "util.h"
 
@@ -583,4 +584,33 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     SetMockTime(0);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolFluidIndexTest)
+{
+    CTxMemPool pool(CFeeRate(0));
+    TestMemPoolEntryHelper entry;
+
+    std::vector<unsigned char> vchPayload = ParseHex("0123456789abcdef0123456789abcdef");
+    CMutableTransaction tx1;
+    tx1.vout.resize(2);
+    tx1.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx1.vout[0].nValue = 10 * COIN;
+    tx1.vout[1].scriptPubKey = CScript() << OP_MINT << vchPayload;
+    tx1.vout[1].nValue = 0;
+    pool.addUnchecked(tx1.GetHash(), entry.FromTx(tx1));
+
+    // The operation code is not part of the payload
+    uint256 txhash;
+    BOOST_CHECK(pool.getFluidIndex(CScript() << OP_REWARD_MINING << vchPayload, txhash));
+    BOOST_CHECK(txhash == tx1.GetHash());
+    vchPayload[0] ^= 1;
+    BOOST_CHECK(!pool.getFluidIndex(CScript() << OP_MINT << vchPayload, txhash));
+
+    std::string strError;
+    BOOST_CHECK(fluid.CheckIfExistsInMemPool(pool, tx1.vout[1].scriptPubKey, strError));
+
+    pool.removeRecursive(tx1);
+    BOOST_CHECK(!pool.getFluidIndex(tx1.vout[1].scriptPubKey, txhash));
+    BOOST_CHECK(!fluid.CheckIfExistsInMemPool(pool, tx1.vout[1].scriptPubKey, strError));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -133,4 +133,36 @@ BOOST_AUTO_TEST_CASE(merkle_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(merkle_tree_incremental)
+{
+    std::vector<uint256> leaves;
+    CMerkleTree appended;
+    BOOST_CHECK(appended.Root() == uint256());
+    for (int ntx = 1; ntx <= 70; ntx++) {
+        leaves.push_back(GetRandHash());
+        appended.Append(leaves.back());
+        BOOST_CHECK_EQUAL(appended.size(), leaves.size());
+        BOOST_CHECK(appended.Root() == ComputeMerkleRoot(leaves));
+
+        CMerkleTree built(leaves);
+        BOOST_CHECK(built.Root() == appended.Root());
+
+        // Replace a random leaf and the first one, as extra-nonce rolls do
+        uint32_t pos = insecure_rand() % ntx;
+        leaves[pos] = GetRandHash();
+        built.Update(pos, leaves[pos]);
+        BOOST_CHECK(built.Root() == ComputeMerkleRoot(leaves));
+        leaves[0] = GetRandHash();
+        built.Update(0, leaves[0]);
+        appended.Update(0, leaves[0]);
+        BOOST_CHECK(built.Root() == ComputeMerkleRoot(leaves));
+        appended.Update(pos, leaves[pos]);
+        BOOST_CHECK(appended.Root() == built.Root());
+
+        BOOST_CHECK(built.Branch(0) == ComputeMerkleBranch(leaves, 0));
+        BOOST_CHECK(built.Branch(pos) == ComputeMerkleBranch(leaves, pos));
+        BOOST_CHECK(ComputeMerkleRootFromBranch(leaves[0], appended.Branch(0), 0) == appended.Root());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
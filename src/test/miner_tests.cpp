@@ -19,6 +19,7 @@
 #include "utilstrencodings.h"
 
 #include "miner/impl/miner-gpu.h"
+#include "miner/internal/hash-rate-counter.h"
 
 #include "test/test_dynamic.h"
 
@@ -113,6 +114,53 @@ BOOST_AUTO_TEST_CASE(ScanNoncesGPU_check)
 }
 #endif //ENABLE_GPU
 
+BOOST_AUTO_TEST_CASE(HashRateCounter_check)
+{
+    const int64_t start = 1000000;
+    SetMockTime(start);
+    HashRateCounterRef group = std::make_shared<HashRateCounter>();
+    HashRateCounterRef thread0 = group->MakeChild();
+    HashRateCounterRef thread1 = group->MakeChild();
+
+    thread0->Increment(10);
+    thread1->Increment(30);
+    thread1->RecordLatency(100);
+    SetMockTime(start + 1);
+    thread0->Increment(20);
+    SetMockTime(start + 2);
+
+    // Group sums the counters of its threads
+    BOOST_CHECK_EQUAL(thread0->GetRate(10), 15);
+    BOOST_CHECK_EQUAL(thread1->GetRate(10), 15);
+    BOOST_CHECK_EQUAL(group->GetRate(10), 30);
+    BOOST_CHECK_EQUAL(group->total(), 60);
+    BOOST_CHECK_EQUAL(group->GetLatencyHistogram()[7], 1);
+
+    // Same slot one window later replaces the count of the old second
+    SetMockTime(start + HashRateCounter::WINDOW_SLOTS);
+    thread0->Increment(900);
+    SetMockTime(start + HashRateCounter::WINDOW_SLOTS + 1);
+    BOOST_CHECK_EQUAL(thread0->GetRate(1), 900);
+    BOOST_CHECK_EQUAL(thread0->GetRate(HashRateCounter::WINDOW_SLOTS), 1);
+    BOOST_CHECK_EQUAL(thread0->total(), 930);
+
+    // Group keeps the counts of threads that shut down
+    thread1.reset();
+    BOOST_CHECK_EQUAL(group->children().size(), 1);
+    BOOST_CHECK_EQUAL(group->total(), 960);
+    BOOST_CHECK_EQUAL(group->GetRate(1), 900);
+    BOOST_CHECK_EQUAL(group->GetLatencyHistogram()[7], 1);
+
+    // Reset clears the threads still running too
+    group->Reset();
+    BOOST_CHECK_EQUAL(group->total(), 0);
+    BOOST_CHECK_EQUAL(group->GetRate(10), 0);
+    BOOST_CHECK_EQUAL(group->GetLatencyHistogram()[7], 0);
+    thread0.reset();
+    BOOST_CHECK_EQUAL(group->total(), 0);
+    SetMockTime(0);
+}
+
 
 // NOTE: These tests rely on CreateNewBlock doing its own self-validation!
 BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
@@ -0,0 +1,146 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainparams.h"
+#include "consensus/merkle.h"
+#include "miner/miner-util.h"
+#include "miner/stratum.h"
+#include "test/test_dynamic.h"
+#include "timedata.h"
+#include "validation.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(stratum_tests, BasicTestingSetup)
+
+static std::shared_ptr<CBlockTemplate> MakeTemplate(unsigned int nTx, uint32_t nBits)
+{
+    std::shared_ptr<CBlockTemplate> blocktemplate = std::make_shared<CBlockTemplate>();
+    CBlock& block = blocktemplate->block;
+    blocktemplate->nHeight = 1234;
+
+    CMutableTransaction txCoinbase;
+    txCoinbase.vin.resize(1);
+    txCoinbase.vin[0].prevout.SetNull();
+    txCoinbase.vin[0].scriptSig = CScript() << blocktemplate->nHeight << OP_0;
+    txCoinbase.vout.resize(1);
+    txCoinbase.vout[0].nValue = 10 * COIN;
+    block.vtx.push_back(MakeTransactionRef(txCoinbase));
+    for (unsigned int i = 0; i < nTx; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(GetRandHash(), i);
+        tx.vout.resize(1);
+        tx.vout[0].nValue = i * CENT;
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    std::vector<uint256> leaves;
+    for (const CTransactionRef& tx : block.vtx)
+        leaves.push_back(tx->GetHash());
+    blocktemplate->selection->merkleTree = CMerkleTree(leaves);
+    blocktemplate->vCoinbaseBranch = blocktemplate->selection->merkleTree.Branch(0);
+    block.hashMerkleRoot = blocktemplate->selection->merkleTree.Root();
+    block.hashPrevBlock = GetRandHash();
+    block.nVersion = 4;
+    block.nTime = GetAdjustedTime();
+    block.nBits = nBits;
+    return blocktemplate;
+}
+
+BOOST_AUTO_TEST_CASE(stratum_job_build_block)
+{
+    const CScript scriptPubKey = CScript() << OP_TRUE;
+    const std::vector<unsigned char> vchExtraNonce1 = ParseHex("01020304");
+    const std::vector<unsigned char> vchExtraNonce2 = ParseHex("a0b0c0d0");
+
+    for (unsigned int nTx = 0; nTx < 12; nTx++) {
+        std::shared_ptr<CBlockTemplate> blocktemplate = MakeTemplate(nTx, 0x207fffff);
+        CStratumJob job("1", blocktemplate, scriptPubKey);
+
+        CBlock block;
+        BOOST_CHECK(job.BuildBlock(vchExtraNonce1, vchExtraNonce2, blocktemplate->block.nTime + 1, 42, block));
+        BOOST_CHECK_EQUAL(block.vtx.size(), nTx + 1);
+        BOOST_CHECK(block.vtx[0]->vout[0].scriptPubKey == scriptPubKey);
+        BOOST_CHECK_EQUAL(block.vtx[0]->vout[0].nValue, 10 * COIN);
+
+        std::vector<unsigned char> vchExtraNonce(vchExtraNonce1);
+        vchExtraNonce.insert(vchExtraNonce.end(), vchExtraNonce2.begin(), vchExtraNonce2.end());
+        BOOST_CHECK(block.vtx[0]->vin[0].scriptSig == (CScript() << blocktemplate->nHeight << vchExtraNonce) + COINBASE_FLAGS);
+
+        // Root from the branch matches hashing the whole block
+        BOOST_CHECK(block.hashMerkleRoot == BlockMerkleRoot(block));
+        BOOST_CHECK_EQUAL(block.nTime, blocktemplate->block.nTime + 1);
+        BOOST_CHECK_EQUAL(block.nNonce, 42U);
+        BOOST_CHECK(block.hashPrevBlock == blocktemplate->block.hashPrevBlock);
+
+        // Notify params carry the coinbase halves around the extranonce
+        UniValue params = job.GetNotifyParams(true);
+        BOOST_CHECK_EQUAL(params.size(), 9U);
+        BOOST_CHECK_EQUAL(params[0].get_str(), "1");
+        BOOST_CHECK_EQUAL(params[4].size(), blocktemplate->vCoinbaseBranch.size());
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss << *block.vtx[0];
+        BOOST_CHECK_EQUAL(params[2].get_str() + HexStr(vchExtraNonce) + params[3].get_str(), HexStr(ss.begin(), ss.end()));
+        BOOST_CHECK(params[8].get_bool());
+    }
+
+    // Extranonces of the wrong size are rejected
+    std::shared_ptr<CBlockTemplate> blocktemplate = MakeTemplate(3, 0x207fffff);
+    CStratumJob job("2", blocktemplate, scriptPubKey);
+    CBlock block;
+    BOOST_CHECK(!job.BuildBlock(ParseHex("0102"), vchExtraNonce2, blocktemplate->block.nTime, 0, block));
+    BOOST_CHECK(!job.BuildBlock(vchExtraNonce1, ParseHex("a0b0c0d0e0"), blocktemplate->block.nTime, 0, block));
+}
+
+BOOST_AUTO_TEST_CASE(stratum_job_check_share)
+{
+    const CScript scriptPubKey = CScript() << OP_TRUE;
+    const std::vector<unsigned char> vchExtraNonce1 = ParseHex("00000001");
+    const std::vector<unsigned char> vchExtraNonce2 = ParseHex("00000000");
+    const arith_uint256 maxTarget = ~arith_uint256(0);
+
+    // Block target of zero, valid shares never solve the block
+    std::shared_ptr<CBlockTemplate> blocktemplate = MakeTemplate(5, 0x01000000);
+    CStratumJob job("1", blocktemplate, scriptPubKey);
+    const uint32_t nTime = blocktemplate->block.nTime;
+    CBlock block;
+    uint256 hash;
+
+    BOOST_CHECK_EQUAL(job.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 1, maxTarget, block, hash), STRATUM_SHARE_ACCEPTED);
+    BOOST_CHECK(hash == block.GetHash());
+    BOOST_CHECK_EQUAL(job.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 1, maxTarget, block, hash), STRATUM_SHARE_DUPLICATE);
+    BOOST_CHECK_EQUAL(job.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 2, arith_uint256(0), block, hash), STRATUM_SHARE_LOW_DIFFICULTY);
+    // Low difficulty shares are not recorded
+    BOOST_CHECK_EQUAL(job.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 2, maxTarget, block, hash), STRATUM_SHARE_ACCEPTED);
+    BOOST_CHECK_EQUAL(job.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime - 1, 3, maxTarget, block, hash), STRATUM_SHARE_INVALID);
+    BOOST_CHECK_EQUAL(job.CheckShare(vchExtraNonce1, ParseHex("00"), nTime, 4, maxTarget, block, hash), STRATUM_SHARE_INVALID);
+
+    // Shares beyond the per job limit are rejected, duplicates are still detected
+    CStratumJob smalljob("3", blocktemplate, scriptPubKey, 2);
+    BOOST_CHECK_EQUAL(smalljob.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 1, maxTarget, block, hash), STRATUM_SHARE_ACCEPTED);
+    BOOST_CHECK_EQUAL(smalljob.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 2, maxTarget, block, hash), STRATUM_SHARE_ACCEPTED);
+    BOOST_CHECK_EQUAL(smalljob.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 3, maxTarget, block, hash), STRATUM_SHARE_JOB_FULL);
+    BOOST_CHECK_EQUAL(smalljob.CheckShare(vchExtraNonce1, vchExtraNonce2, nTime, 1, maxTarget, block, hash), STRATUM_SHARE_DUPLICATE);
+
+    // Nearly every hash meets this block target
+    blocktemplate = MakeTemplate(5, 0x2100ffff);
+    CStratumJob easyjob("2", blocktemplate, scriptPubKey);
+    bool fFound = false;
+    for (uint32_t nNonce = 0; nNonce < 16 && !fFound; nNonce++) {
+        fFound = easyjob.CheckShare(vchExtraNonce1, vchExtraNonce2, blocktemplate->block.nTime, nNonce, maxTarget, block, hash) == STRATUM_SHARE_BLOCK;
+    }
+    BOOST_CHECK(fFound);
+    BOOST_CHECK(block.hashMerkleRoot == BlockMerkleRoot(block));
+}
+
+BOOST_AUTO_TEST_CASE(stratum_share_target)
+{
+    const arith_uint256 powLimit = UintToArith256(Params().GetConsensus().powLimit);
+    BOOST_CHECK(GetStratumShareTarget(Params(), 1) == powLimit);
+    BOOST_CHECK(GetStratumShareTarget(Params(), 16) == powLimit / 16);
+    BOOST_CHECK(GetStratumShareTarget(Params(), 0) == powLimit);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -10,6 +10,7 @@
 #include "clientversion.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "fluid/fluid.h"
 #include "instantsend.h"
 #include "policy/fees.h"
 #include "policy/policy.h"
@@ -433,6 +434,7 @@ bool CTxMemPool::addUnchecked(const uint256& hash, const CTxMemPoolEntry& entry,
 
     vTxHashes.emplace_back(hash, newit);
     newit->vTxHashesIdx = vTxHashes.size() - 1;
+    addFluidIndex(tx);
 
     return true;
 }
@@ -672,12 +674,53 @@ bool CTxMemPool::removeSpentIndex(const uint256 txhash)
     return true;
 }
 
+void CTxMemPool::addFluidIndex(const CTransaction& tx)
+{
+    for (const CTxOut& txout : tx.vout) {
+        uint256 payloadHash;
+        if (IsTransactionFluid(txout.scriptPubKey) && GetFluidPayloadHash(txout.scriptPubKey, payloadHash))
+            mapFluid.insert(std::make_pair(payloadHash, tx.GetHash()));
+    }
+}
+
+void CTxMemPool::removeFluidIndex(const CTransaction& tx)
+{
+    for (const CTxOut& txout : tx.vout) {
+        uint256 payloadHash;
+        if (!IsTransactionFluid(txout.scriptPubKey) || !GetFluidPayloadHash(txout.scriptPubKey, payloadHash))
+            continue;
+        std::pair<mapFluidIndex::iterator, mapFluidIndex::iterator> range = mapFluid.equal_range(payloadHash);
+        for (mapFluidIndex::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == tx.GetHash()) {
+                mapFluid.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+bool CTxMemPool::getFluidIndex(const CScript& fluidScript, uint256& txhash) const
+{
+    uint256 payloadHash;
+    if (!GetFluidPayloadHash(fluidScript, payloadHash))
+        return false;
+
+    LOCK(cs);
+    mapFluidIndex::const_iterator it = mapFluid.find(payloadHash);
+    if (it == mapFluid.end())
+        return false;
+
+    txhash = it->second;
+    return true;
+}
+
 void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 {
     NotifyEntryRemoved(it->GetSharedTx(), reason);
     const uint256 hash = it->GetTx().GetHash();
     BOOST_FOREACH (const CTxIn& txin, it->GetTx().vin)
         mapNextTx.erase(txin.prevout);
+    removeFluidIndex(it->GetTx());
 
     if (vTxHashes.size() > 1) {
         vTxHashes[it->vTxHashesIdx] = std::move(vTxHashes.back());
@@ -850,6 +893,7 @@ void CTxMemPool::_clear()
     mapLinks.clear();
     mapTx.clear();
     mapNextTx.clear();
+    mapFluid.clear();
     totalTxSize = 0;
     cachedInnerUsage = 0;
     lastRollingFeeUpdate = GetTime();
@@ -12,6 +12,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -531,6 +532,13 @@ private:
     typedef std::map<uint256, std::vector<CSpentIndexKey> > mapSpentIndexInserted;
     mapSpentIndexInserted mapSpentInserted;
 
+    // fluid payload hash -> transactions carrying the payload
+    typedef std::unordered_multimap<uint256, uint256, SaltedTxidHasher> mapFluidIndex;
+    mapFluidIndex mapFluid;
+
+    void addFluidIndex(const CTransaction& tx);
+    void removeFluidIndex(const CTransaction& tx);
+
     void UpdateParent(txiter entry, txiter parent, bool add);
     void UpdateChild(txiter entry, txiter child, bool add);
 
@@ -570,6 +578,9 @@ public:
     bool getSpentIndex(CSpentIndexKey& key, CSpentIndexValue& value);
     bool removeSpentIndex(const uint256 txhash);
 
+    /** Finds a transaction carrying the same fluid payload as fluidScript */
+    bool getFluidIndex(const CScript& fluidScript, uint256& txhash) const;
+
     void removeRecursive(const CTransaction& tx, MemPoolRemovalReason reason = MemPoolRemovalReason::UNKNOWN);
     void removeForReorg(const CCoinsViewCache* pcoins, unsigned int nMemPoolHeight, int flags);
     void removeConflicts(const CTransaction& tx);
@@ -279,6 +279,8 @@ bool LoadBlockIndex(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the header proof-of-work checking thread */
+void ThreadHeaderCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Format a string that describes several potential problems detected by the core.
@@ -479,6 +481,31 @@ public:
     ScriptError GetScriptError() const { return error; }
 };
 
+/**
+ * Closure representing one header proof-of-work verification
+ * Note that this stores references to the header and to the hash it fills in
+ */
+class CHeaderPoWCheck
+{
+private:
+    const CBlockHeader* pheader;
+    uint256* phash;
+    const Consensus::Params* pconsensusParams;
+
+public:
+    CHeaderPoWCheck() : pheader(NULL), phash(NULL), pconsensusParams(NULL) {}
+    CHeaderPoWCheck(const CBlockHeader& headerIn, uint256& hashOut, const Consensus::Params& consensusParamsIn) : pheader(&headerIn), phash(&hashOut), pconsensusParams(&consensusParamsIn) {}
+
+    bool operator()();
+
+    void swap(CHeaderPoWCheck& check)
+    {
+        std::swap(pheader, check.pheader);
+        std::swap(phash, check.phash);
+        std::swap(pconsensusParams, check.pconsensusParams);
+    }
+};
+
 bool GetTimestampIndex(const unsigned int& high, const unsigned int& low, std::vector<uint256>& hashes);
 bool GetSpentIndex(CSpentIndexKey& key, CSpentIndexValue& value);
 bool GetAddressIndex(uint160 addressHash, int type, std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex, int start = 0, int end = 0);
@@ -487,7 +514,12 @@ bool GetAddressUnspent(uint160 addressHash, int type, std::vector<std::pair<CAdd
 /** Functions for disk access for blocks */
 bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/**
+ * Read the block of an index entry. With fTrustIndex the on-disk header is
+ * compared byte for byte with the already validated index entry instead of
+ * recomputing its Argon2d proof of work.
+ */
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fTrustIndex = true);
 
 /** Functions for validating blocks and updating the block tree */
 